@@ -24,7 +24,9 @@ if {[file exists ${project_name}_proj/${project_name}_proj.srcs/sources_1/bd/${p
 
   apply_bd_automation -rule xilinx.com:bd_rule:processing_system7 -config {make_external "FIXED_IO, DDR" apply_board_preset "1" Master "Disable" Slave "Disable" }  [get_bd_cells processing_system7_0]
 
-  set_property -dict [list CONFIG.PCW_FPGA0_PERIPHERAL_FREQMHZ ${f_mhz} CONFIG.PCW_USE_M_AXI_GP0 {0} CONFIG.PCW_USE_S_AXI_HP0 {1} CONFIG.PCW_QSPI_GRP_SINGLE_SS_ENABLE {1}] [get_bd_cells processing_system7_0]
+  # HP0 is at most 64-bit wide; the smartconnect converts from the z1top_axi
+  # AXI_DWIDTH (32, 64 or 128)
+  set_property -dict [list CONFIG.PCW_FPGA0_PERIPHERAL_FREQMHZ ${f_mhz} CONFIG.PCW_USE_M_AXI_GP0 {0} CONFIG.PCW_USE_S_AXI_HP0 {1} CONFIG.PCW_S_AXI_HP0_DATA_WIDTH {64} CONFIG.PCW_QSPI_GRP_SINGLE_SS_ENABLE {1}] [get_bd_cells processing_system7_0]
 
   create_bd_cell -type ip -vlnv xilinx.com:ip:smartconnect:1.0 smartconnect_0
   set_property -dict [list CONFIG.NUM_SI {1}] [get_bd_cells smartconnect_0]
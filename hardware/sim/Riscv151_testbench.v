@@ -52,7 +52,8 @@ module Riscv151_testbench();
     .rst(rst),
     .FPGA_SERIAL_RX(),
     .FPGA_SERIAL_TX(),
-    .csr(csr)
+    .csr(csr),
+    .dma_imem_wbe(4'd0) // no DMA writes to IMem
   );
 
   wire [31:0] timeout_cycle = 11;
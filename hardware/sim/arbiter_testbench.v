@@ -0,0 +1,392 @@
+`timescale 1ns/1ns
+
+// Two AXI clients (DMA, accelerator) issuing read and write bursts at the
+// same time through the arbiter to the memory model: every client must get
+// its own data back, and back-to-back requests must alternate between them.
+// The traffic monitor (axi_monitor) on the memory side must count every
+// request and beat for the right client; its counters are printed at the end
+module arbiter_testbench();
+  reg clk, rst;
+  parameter CPU_CLOCK_PERIOD = 20;
+
+  initial clk = 0;
+  always #(CPU_CLOCK_PERIOD/2) clk = ~clk;
+
+  localparam TIMEOUT_CYCLE = 100_000;
+
+  localparam AXI_AWIDTH = 32;
+  localparam AXI_DWIDTH = 32;
+
+  localparam NUM_BURSTS = 4;
+  localparam BURST_LEN  = 8;
+
+  // Client 0: DMA, client 1: accelerator
+  localparam DMA  = 0;
+  localparam XCEL = 1;
+
+  wire core_read_request_valid, core_read_request_ready;
+  wire [AXI_AWIDTH-1:0] core_read_addr;
+  wire [31:0] core_read_len;
+  wire [2:0] core_read_size;
+  wire [1:0] core_read_burst;
+  wire [AXI_DWIDTH-1:0] core_read_data;
+  wire core_read_data_valid, core_read_data_ready;
+
+  wire core_write_request_valid, core_write_request_ready;
+  wire [AXI_AWIDTH-1:0] core_write_addr;
+  wire [31:0] core_write_len;
+  wire [2:0] core_write_size;
+  wire [1:0] core_write_burst;
+  wire [AXI_DWIDTH-1:0] core_write_data;
+  wire core_write_data_valid, core_write_data_ready;
+
+  // Client signals, client c at bit c (or slice c)
+  reg  [1:0] read_request_valid;
+  wire [1:0] read_request_ready;
+  reg  [2*AXI_AWIDTH-1:0] read_addr;
+  wire [2*AXI_DWIDTH-1:0] read_data;
+  wire [1:0] read_data_valid;
+  reg  [1:0] read_data_ready;
+
+  reg  [1:0] write_request_valid;
+  wire [1:0] write_request_ready;
+  reg  [2*AXI_AWIDTH-1:0] write_addr;
+  reg  [2*AXI_DWIDTH-1:0] write_data;
+  reg  [1:0] write_data_valid;
+  wire [1:0] write_data_ready;
+
+  arbiter #(
+    .AXI_AWIDTH(AXI_AWIDTH),
+    .AXI_DWIDTH(AXI_DWIDTH)
+  ) dut (
+    .clk(clk),
+    .rst(rst),
+
+    .core_read_request_valid(core_read_request_valid), // output
+    .core_read_request_ready(core_read_request_ready), // input
+    .core_read_addr(core_read_addr),                   // output
+    .core_read_len(core_read_len),                     // output
+    .core_read_size(core_read_size),                   // output
+    .core_read_burst(core_read_burst),                 // output
+    .core_read_data(core_read_data),                   // input
+    .core_read_data_valid(core_read_data_valid),       // input
+    .core_read_data_ready(core_read_data_ready),       // output
+
+    .core_write_request_valid(core_write_request_valid), // output
+    .core_write_request_ready(core_write_request_ready), // input
+    .core_write_addr(core_write_addr),                   // output
+    .core_write_len(core_write_len),                     // output
+    .core_write_size(core_write_size),                   // output
+    .core_write_burst(core_write_burst),                 // output
+    .core_write_data(core_write_data),                   // output
+    .core_write_data_valid(core_write_data_valid),       // output
+    .core_write_data_ready(core_write_data_ready),       // input
+    .core_write_idle(1'b1),                              // input (mem_model stores a write at once)
+
+    .dma_read_request_valid(read_request_valid[DMA]),        // input
+    .dma_read_request_ready(read_request_ready[DMA]),        // output
+    .dma_read_addr(read_addr[DMA*AXI_AWIDTH +: AXI_AWIDTH]), // input
+    .dma_read_len(BURST_LEN - 1),                            // input
+    .dma_read_size(3'd2),                                    // input
+    .dma_read_burst(2'd1),                                   // input
+    .dma_read_data(read_data[DMA*AXI_DWIDTH +: AXI_DWIDTH]), // output
+    .dma_read_data_valid(read_data_valid[DMA]),              // output
+    .dma_read_data_ready(read_data_ready[DMA]),              // input
+
+    .dma_write_request_valid(write_request_valid[DMA]),        // input
+    .dma_write_request_ready(write_request_ready[DMA]),        // output
+    .dma_write_addr(write_addr[DMA*AXI_AWIDTH +: AXI_AWIDTH]), // input
+    .dma_write_len(BURST_LEN - 1),                             // input
+    .dma_write_size(3'd2),                                     // input
+    .dma_write_burst(2'd1),                                    // input
+    .dma_write_data(write_data[DMA*AXI_DWIDTH +: AXI_DWIDTH]), // input
+    .dma_write_data_valid(write_data_valid[DMA]),              // input
+    .dma_write_data_ready(write_data_ready[DMA]),              // output
+
+    .xcel_read_request_valid(read_request_valid[XCEL]),        // input
+    .xcel_read_request_ready(read_request_ready[XCEL]),        // output
+    .xcel_read_addr(read_addr[XCEL*AXI_AWIDTH +: AXI_AWIDTH]), // input
+    .xcel_read_len(BURST_LEN - 1),                             // input
+    .xcel_read_size(3'd2),                                     // input
+    .xcel_read_burst(2'd1),                                    // input
+    .xcel_read_data(read_data[XCEL*AXI_DWIDTH +: AXI_DWIDTH]), // output
+    .xcel_read_data_valid(read_data_valid[XCEL]),              // output
+    .xcel_read_data_ready(read_data_ready[XCEL]),              // input
+
+    .xcel_write_request_valid(write_request_valid[XCEL]),        // input
+    .xcel_write_request_ready(write_request_ready[XCEL]),        // output
+    .xcel_write_addr(write_addr[XCEL*AXI_AWIDTH +: AXI_AWIDTH]), // input
+    .xcel_write_len(BURST_LEN - 1),                              // input
+    .xcel_write_size(3'd2),                                      // input
+    .xcel_write_burst(2'd1),                                     // input
+    .xcel_write_data(write_data[XCEL*AXI_DWIDTH +: AXI_DWIDTH]), // input
+    .xcel_write_data_valid(write_data_valid[XCEL]),              // input
+    .xcel_write_data_ready(write_data_ready[XCEL])               // output
+  );
+
+  mem_model #(
+    .AXI_AWIDTH(AXI_AWIDTH),
+    .AXI_DWIDTH(AXI_DWIDTH),
+    .DELAY(4)
+  ) mm_unit (
+    .clk(clk),
+    .rst(rst),
+
+    .read_request_valid(core_read_request_valid),   // input
+    .read_request_ready(core_read_request_ready),   // output
+    .read_request_addr(core_read_addr),             // input
+    .read_len(core_read_len),                       // input
+    .read_size(core_read_size),                     // input
+    .read_data(core_read_data),                     // output
+    .read_data_valid(core_read_data_valid),         // output
+    .read_data_ready(core_read_data_ready),         // input
+
+    .write_request_valid(core_write_request_valid), // input
+    .write_request_ready(core_write_request_ready), // output
+    .write_request_addr(core_write_addr),           // input
+    .write_len(core_write_len),                     // input
+    .write_size(core_write_size),                   // input
+    .write_data(core_write_data),                   // input
+    .write_data_valid(core_write_data_valid),       // input
+    .write_data_ready(core_write_data_ready)        // output
+  );
+
+  reg  [5:0]  mon_sel;
+  wire [31:0] mon_value;
+
+  axi_monitor mon (
+    .clk(clk),
+    .rst(rst),
+    .clear(1'b0),
+
+    .read_request_valid(core_read_request_valid),   // input
+    .read_request_ready(core_read_request_ready),   // input
+    .read_len(core_read_len),                       // input
+    .read_master(read_request_ready[XCEL]),         // input
+    .read_data_valid(core_read_data_valid),         // input
+    .read_data_ready(core_read_data_ready),         // input
+
+    .write_request_valid(core_write_request_valid), // input
+    .write_request_ready(core_write_request_ready), // input
+    .write_len(core_write_len),                     // input
+    .write_master(write_request_ready[XCEL]),       // input
+    .write_data_valid(core_write_data_valid),       // input
+    .write_data_ready(core_write_data_ready),       // input
+
+    .sel(mon_sel),                                  // input
+    .value(mon_value)                               // output
+  );
+
+  integer i;
+  integer num_mismatches = 0;
+
+  // Read monitor counter sel
+  task mon_read;
+    input  [5:0]  sel;
+    output [31:0] value;
+    begin
+      mon_sel = sel;
+      #1;
+      value = mon_value;
+    end
+  endtask
+
+  task check_monitor;
+    input integer c;
+    input integer sel;
+    input integer expected;
+    input [255:0] what;
+    reg [31:0] got;
+    begin
+      mon_read(16 * (c + 1) + sel, got);
+      if (got !== expected) begin
+        num_mismatches = num_mismatches + 1;
+        $display("Mismatch (client %0d monitor %0s): expected %0d, got %0d",
+                 c, what, expected, got);
+      end
+    end
+  endtask
+
+  task report_monitor;
+    integer c, b;
+    reg [31:0] v0, v1, v2, v3, v4, v5;
+    begin
+      mon_read(0, v0);
+      mon_read(1, v1);
+      $display("AXI monitor: %0d cycles, %0d idle", v0, v1);
+      for (c = 0; c < 2; c = c + 1) begin
+        mon_read(16 * (c + 1) + 0, v0);
+        mon_read(16 * (c + 1) + 1, v1);
+        mon_read(16 * (c + 1) + 2, v2);
+        mon_read(16 * (c + 1) + 3, v3);
+        mon_read(16 * (c + 1) + 4, v4);
+        mon_read(16 * (c + 1) + 5, v5);
+        $display("  %0s: read %0d requests / %0d beats, write %0d requests / %0d beats, read latency avg %0d max %0d",
+                 c == DMA ? "DMA " : "xcel", v0, v1, v2, v3, v0 ? v4 / v0 : 0, v5);
+        for (b = 0; b < 8; b = b + 1) begin
+          mon_read(16 * (c + 1) + 8 + b, v0);
+          if (v0 != 0 && b == 7)
+            $display("    latency >= 1024: %0d", v0);
+          else if (v0 != 0)
+            $display("    latency < %0d: %0d", 16 << b, v0);
+        end
+      end
+    end
+  endtask
+
+  // DDR layout (word addresses): client c reads bursts from c * 1024,
+  // and writes them to 4096 + c * 1024
+  function [31:0] src_word;
+    input integer c;
+    input integer idx;
+    src_word = 32'hd000_0000 + (c << 16) + idx;
+  endfunction
+
+  // Order of the granted read requests (1: accelerator)
+  reg [2*NUM_BURSTS-1:0] rd_grant_order;
+  integer num_rd_grants = 0;
+
+  always @(posedge clk) begin
+    if (read_request_valid[DMA] & read_request_ready[DMA]) begin
+      rd_grant_order[num_rd_grants] <= DMA;
+      num_rd_grants <= num_rd_grants + 1;
+    end
+    if (read_request_valid[XCEL] & read_request_ready[XCEL]) begin
+      rd_grant_order[num_rd_grants] <= XCEL;
+      num_rd_grants <= num_rd_grants + 1;
+    end
+  end
+
+  // A client: NUM_BURSTS back-to-back read bursts (the next request goes
+  // out right after the last beat of the previous one), then the same data
+  // written back with NUM_BURSTS write bursts
+  reg [1:0] client_done;
+
+  genvar c;
+  generate
+    for (c = 0; c < 2; c = c + 1) begin:CLIENT
+      integer b, k;
+      reg [AXI_DWIDTH-1:0] buffer [NUM_BURSTS*BURST_LEN-1:0];
+
+      initial begin
+        client_done[c]         = 1'b0;
+        read_request_valid[c]  = 1'b0;
+        read_data_ready[c]     = 1'b0;
+        write_request_valid[c] = 1'b0;
+        write_data_valid[c]    = 1'b0;
+
+        wait (rst === 1'b0);
+
+        for (b = 0; b < NUM_BURSTS; b = b + 1) begin
+          @(negedge clk);
+          read_data_ready[c] = 1'b0;
+          read_addr[c*AXI_AWIDTH +: AXI_AWIDTH] = (c * 1024 + b * BURST_LEN) << 2;
+          read_request_valid[c] = 1'b1;
+          @(posedge clk);
+          while (!read_request_ready[c]) @(posedge clk);
+          @(negedge clk);
+          read_request_valid[c] = 1'b0;
+
+          read_data_ready[c] = 1'b1;
+          for (k = 0; k < BURST_LEN; k = k + 1) begin
+            @(posedge clk);
+            while (!read_data_valid[c]) @(posedge clk);
+            buffer[b * BURST_LEN + k] = read_data[c*AXI_DWIDTH +: AXI_DWIDTH];
+          end
+        end
+        @(negedge clk);
+        read_data_ready[c] = 1'b0;
+
+        for (k = 0; k < NUM_BURSTS * BURST_LEN; k = k + 1) begin
+          if (buffer[k] !== src_word(c, k)) begin
+            num_mismatches = num_mismatches + 1;
+            $display("Mismatch (client %0d read): expected %h, got %h",
+                     c, src_word(c, k), buffer[k]);
+          end
+        end
+
+        for (b = 0; b < NUM_BURSTS; b = b + 1) begin
+          @(negedge clk);
+          write_addr[c*AXI_AWIDTH +: AXI_AWIDTH] = (4096 + c * 1024 + b * BURST_LEN) << 2;
+          write_request_valid[c] = 1'b1;
+          @(posedge clk);
+          while (!write_request_ready[c]) @(posedge clk);
+          @(negedge clk);
+          write_request_valid[c] = 1'b0;
+
+          for (k = 0; k < BURST_LEN; k = k + 1) begin
+            write_data[c*AXI_DWIDTH +: AXI_DWIDTH] = buffer[b * BURST_LEN + k];
+            write_data_valid[c] = 1'b1;
+            @(posedge clk);
+            while (!write_data_ready[c]) @(posedge clk);
+            @(negedge clk);
+          end
+          write_data_valid[c] = 1'b0;
+        end
+
+        client_done[c] = 1'b1;
+      end
+    end
+  endgenerate
+
+  initial begin
+    #0;
+    rst = 1'b1;
+
+    for (i = 0; i < NUM_BURSTS * BURST_LEN; i = i + 1) begin
+      mm_unit.buffer.mem[i]        = src_word(DMA, i);
+      mm_unit.buffer.mem[1024 + i] = src_word(XCEL, i);
+    end
+
+    repeat (10) @(posedge clk);
+
+    @(negedge clk);
+    rst = 1'b0;
+
+    wait (client_done === 2'b11);
+    repeat (10) @(posedge clk);
+
+    for (i = 0; i < NUM_BURSTS * BURST_LEN; i = i + 1) begin
+      if (mm_unit.buffer.mem[4096 + i] !== src_word(DMA, i)) begin
+        num_mismatches = num_mismatches + 1;
+        $display("Mismatch (DMA write) at %0d", i);
+      end
+      if (mm_unit.buffer.mem[4096 + 1024 + i] !== src_word(XCEL, i)) begin
+        num_mismatches = num_mismatches + 1;
+        $display("Mismatch (xcel write) at %0d", i);
+      end
+    end
+
+    for (i = 0; i < 2; i = i + 1) begin
+      check_monitor(i, 0, NUM_BURSTS, "read requests");
+      check_monitor(i, 1, NUM_BURSTS * BURST_LEN, "read beats");
+      check_monitor(i, 2, NUM_BURSTS, "write requests");
+      check_monitor(i, 3, NUM_BURSTS * BURST_LEN, "write beats");
+    end
+    report_monitor;
+
+    // Both clients keep a read request pending until their last burst, so
+    // the read grants must alternate (a fixed priority would serve one
+    // client's bursts back to back)
+    for (i = 1; i < 2 * NUM_BURSTS; i = i + 1) begin
+      if (rd_grant_order[i] == rd_grant_order[i - 1]) begin
+        num_mismatches = num_mismatches + 1;
+        $display("Read grant %0d went to the same client twice in a row", i);
+      end
+    end
+
+    if (num_mismatches == 0)
+      $display("Test passed!");
+    else
+      $display("Test failed! Num. mismatches: %d", num_mismatches);
+
+    $finish();
+  end
+
+  initial begin
+    repeat (TIMEOUT_CYCLE) @(posedge clk);
+    $display("Timeout!");
+    $finish();
+  end
+
+endmodule
@@ -17,7 +17,8 @@ module assembly_testbench();
     .rst(rst),
     .FPGA_SERIAL_RX(),
     .FPGA_SERIAL_TX(),
-    .csr()
+    .csr(),
+    .dma_imem_wbe(4'd0) // no DMA writes to IMem
   );
 
   // A task to check if the value contained in a register equals an expected value
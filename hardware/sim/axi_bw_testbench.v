@@ -0,0 +1,727 @@
+`timescale 1ns/1ns
+
+// Sustained bandwidth of the AXI adapter (axi_mm_adapter) against the AXI
+// memory model, for a few memory latencies (DELAY) and AXI_MAX_OUTSTANDING
+// settings. Each configuration streams NUM_REQS back-to-back requests of
+// REQ_LEN beats: reads only, writes only, then reads and writes at the
+// same time. All configurations run side by side.
+// Alongside, the DMA controller writes DDR words through the arbiter and
+// the adapter and then reads them back, with write responses much slower
+// than reads: the read must not overtake the write
+module axi_bw_testbench();
+  reg clk, rst;
+  parameter CPU_CLOCK_PERIOD = 20;
+
+  initial clk = 0;
+  always #(CPU_CLOCK_PERIOD/2) clk = ~clk;
+
+  localparam TIMEOUT_CYCLE = 1_000_000;
+
+  localparam AXI_AWIDTH = 32;
+  localparam AXI_DWIDTH = 32;
+
+  localparam NUM_REQS = 32;
+  localparam REQ_LEN  = 64;
+  localparam NUM_BEATS = NUM_REQS * REQ_LEN;
+
+  // Word addresses: reads from 0, writes to WR_BASE
+  localparam WR_BASE = 4096;
+
+  localparam NUM_DELAYS       = 3;
+  localparam NUM_OUTSTANDINGS = 2;
+  localparam NUM_CONFIGS      = NUM_DELAYS * NUM_OUTSTANDINGS;
+
+  function integer delay_of;
+    input integer d;
+    delay_of = (d == 0) ? 10 : (d == 1) ? 50 : 100;
+  endfunction
+
+  function integer outstanding_of;
+    input integer o;
+    outstanding_of = (o == 0) ? 1 : 4;
+  endfunction
+
+  integer num_mismatches = 0;
+  reg [NUM_CONFIGS-1:0] config_done;
+
+  genvar d, o;
+  generate
+    for (d = 0; d < NUM_DELAYS; d = d + 1) begin:DLY
+      for (o = 0; o < NUM_OUTSTANDINGS; o = o + 1) begin:OST
+        localparam DELAY           = delay_of(d);
+        localparam MAX_OUTSTANDING = outstanding_of(o);
+
+        wire [3:0]            arid, rid, awid, wid, bid;
+        wire [AXI_AWIDTH-1:0] araddr, awaddr;
+        wire                  arvalid, arready, rvalid, rready, rlast;
+        wire                  awvalid, awready, wvalid, wready, wlast;
+        wire                  bvalid, bready;
+        wire [7:0]            arlen, awlen;
+        wire [2:0]            arsize, awsize;
+        wire [1:0]            arburst, awburst, rresp, bresp;
+        wire [AXI_DWIDTH-1:0] rdata, wdata;
+        wire [AXI_DWIDTH/8-1:0] wstrb;
+
+        reg                   core_read_request_valid;
+        wire                  core_read_request_ready;
+        reg  [AXI_AWIDTH-1:0] core_read_addr;
+        wire [AXI_DWIDTH-1:0] core_read_data;
+        wire                  core_read_data_valid;
+
+        reg                   core_write_request_valid;
+        wire                  core_write_request_ready;
+        reg  [AXI_AWIDTH-1:0] core_write_addr;
+        reg  [AXI_DWIDTH-1:0] core_write_data;
+        reg                   core_write_data_valid;
+        wire                  core_write_data_ready;
+
+        axi_mm_adapter #(
+          .AXI_AWIDTH(AXI_AWIDTH),
+          .AXI_DWIDTH(AXI_DWIDTH),
+          .AXI_MAX_OUTSTANDING(MAX_OUTSTANDING)
+        ) dut (
+          .clk(clk),
+          .resetn(~rst),
+
+          .arid(arid),
+          .araddr(araddr),
+          .arvalid(arvalid),
+          .arready(arready),
+          .arlen(arlen),
+          .arsize(arsize),
+          .arburst(arburst),
+
+          .rid(rid),
+          .rdata(rdata),
+          .rvalid(rvalid),
+          .rready(rready),
+          .rlast(rlast),
+          .rresp(rresp),
+
+          .awid(awid),
+          .awaddr(awaddr),
+          .awvalid(awvalid),
+          .awready(awready),
+          .awlen(awlen),
+          .awsize(awsize),
+          .awburst(awburst),
+
+          .wid(wid),
+          .wdata(wdata),
+          .wvalid(wvalid),
+          .wready(wready),
+          .wlast(wlast),
+          .wstrb(wstrb),
+
+          .bid(bid),
+          .bresp(bresp),
+          .bvalid(bvalid),
+          .bready(bready),
+
+          .core_read_request_valid(core_read_request_valid),
+          .core_read_request_ready(core_read_request_ready),
+          .core_read_addr(core_read_addr),
+          .core_read_len(REQ_LEN - 1),
+          .core_read_size(3'd2),
+          .core_read_burst(`BURST_INCR),
+          .core_read_data(core_read_data),
+          .core_read_data_valid(core_read_data_valid),
+          .core_read_data_ready(1'b1),
+
+          .core_write_request_valid(core_write_request_valid),
+          .core_write_request_ready(core_write_request_ready),
+          .core_write_addr(core_write_addr),
+          .core_write_len(REQ_LEN - 1),
+          .core_write_size(3'd2),
+          .core_write_burst(`BURST_INCR),
+          .core_write_data(core_write_data),
+          .core_write_data_valid(core_write_data_valid),
+          .core_write_data_ready(core_write_data_ready)
+        );
+
+        axi_mem_model #(
+          .AXI_AWIDTH(AXI_AWIDTH),
+          .AXI_DWIDTH(AXI_DWIDTH),
+          .DELAY(DELAY)
+        ) mem (
+          .clk(clk),
+          .rst(rst),
+
+          .arid(arid),
+          .araddr(araddr),
+          .arvalid(arvalid),
+          .arready(arready),
+          .arlen(arlen),
+          .arsize(arsize),
+          .arburst(arburst),
+
+          .rid(rid),
+          .rdata(rdata),
+          .rvalid(rvalid),
+          .rready(rready),
+          .rlast(rlast),
+          .rresp(rresp),
+
+          .awid(awid),
+          .awaddr(awaddr),
+          .awvalid(awvalid),
+          .awready(awready),
+          .awlen(awlen),
+          .awsize(awsize),
+          .awburst(awburst),
+
+          .wid(wid),
+          .wdata(wdata),
+          .wvalid(wvalid),
+          .wready(wready),
+          .wlast(wlast),
+          .wstrb(wstrb),
+
+          .bid(bid),
+          .bresp(bresp),
+          .bvalid(bvalid),
+          .bready(bready)
+        );
+
+        integer i, r, k, pass;
+        integer num_read, start_cycle;
+        integer read_cycles, write_cycles, both_cycles;
+        reg reading, writing;
+
+        // Count (and check) the read beats as they come back
+        always @(posedge clk) begin
+          if (rst)
+            num_read <= 0;
+          else if (core_read_data_valid) begin
+            if (core_read_data !== 32'hd000_0000 + (num_read % NUM_BEATS)) begin
+              num_mismatches = num_mismatches + 1;
+              $display("[DELAY %0d, outstanding %0d] read mismatch at beat %0d",
+                       DELAY, MAX_OUTSTANDING, num_read);
+            end
+            num_read <= num_read + 1;
+          end
+        end
+
+        initial begin
+          config_done[d * NUM_OUTSTANDINGS + o] = 1'b0;
+          core_read_request_valid  = 1'b0;
+          core_write_request_valid = 1'b0;
+          core_write_data_valid    = 1'b0;
+          reading = 1'b0;
+          writing = 1'b0;
+
+          for (i = 0; i < NUM_BEATS; i = i + 1)
+            mem.mem[i] = 32'hd000_0000 + i;
+
+          wait (rst === 1'b0);
+
+          // pass 0: reads, pass 1: writes, pass 2: both
+          for (pass = 0; pass < 3; pass = pass + 1) begin
+            @(negedge clk);
+            reading     = pass != 1;
+            writing     = pass != 0;
+            start_cycle = mem.cycle;
+
+            fork
+              if (reading) begin
+                for (r = 0; r < NUM_REQS; r = r + 1) begin
+                  core_read_addr          = (r * REQ_LEN) << 2;
+                  core_read_request_valid = 1'b1;
+                  @(posedge clk);
+                  while (!core_read_request_ready) @(posedge clk);
+                  @(negedge clk);
+                  core_read_request_valid = 1'b0;
+                end
+                wait (num_read == (pass == 0 ? 1 : 2) * NUM_BEATS);
+              end
+
+              if (writing) begin
+                for (r = 0; r < NUM_REQS; r = r + 1) begin
+                  core_write_addr          = (WR_BASE + r * REQ_LEN) << 2;
+                  core_write_request_valid = 1'b1;
+                  @(posedge clk);
+                  while (!core_write_request_ready) @(posedge clk);
+                  @(negedge clk);
+                  core_write_request_valid = 1'b0;
+
+                  for (k = 0; k < REQ_LEN; k = k + 1) begin
+                    core_write_data       = 32'he000_0000 + pass * NUM_BEATS + r * REQ_LEN + k;
+                    core_write_data_valid = 1'b1;
+                    @(posedge clk);
+                    while (!core_write_data_ready) @(posedge clk);
+                    @(negedge clk);
+                  end
+                  core_write_data_valid = 1'b0;
+                end
+                // all write responses are in
+                wait (dut.write_unit.outstanding_value == 0 &&
+                      !dut.write_unit.aw_busy_value);
+              end
+            join
+
+            if (pass == 0) read_cycles  = mem.cycle - start_cycle;
+            if (pass == 1) write_cycles = mem.cycle - start_cycle;
+            if (pass == 2) both_cycles  = mem.cycle - start_cycle;
+
+            if (writing) begin
+              for (i = 0; i < NUM_BEATS; i = i + 1) begin
+                if (mem.mem[WR_BASE + i] !== 32'he000_0000 + pass * NUM_BEATS + i) begin
+                  num_mismatches = num_mismatches + 1;
+                  $display("[DELAY %0d, outstanding %0d] write mismatch at beat %0d",
+                           DELAY, MAX_OUTSTANDING, i);
+                end
+              end
+            end
+          end
+
+          // bytes per 100 cycles
+          $display("DELAY %3d, outstanding %0d: read %0d cycles (%0d B/100 cycles), write %0d cycles (%0d B/100 cycles), read+write %0d cycles (%0d B/100 cycles)",
+                   DELAY, MAX_OUTSTANDING,
+                   read_cycles,  (NUM_BEATS * 4 * 100) / read_cycles,
+                   write_cycles, (NUM_BEATS * 4 * 100) / write_cycles,
+                   both_cycles,  (2 * NUM_BEATS * 4 * 100) / both_cycles);
+
+          config_done[d * NUM_OUTSTANDINGS + o] = 1'b1;
+        end
+      end
+    end
+  endgenerate
+
+  // -------------------------------------------------------------------------
+  // DMA write, then read of the same DDR words
+  // -------------------------------------------------------------------------
+  localparam RAW_DELAY   = 10;
+  localparam RAW_B_DELAY = 200;
+  localparam RAW_LEN     = 16;
+  localparam DMEM_AWIDTH = 14;
+
+  wire [3:0]            raw_arid, raw_rid, raw_awid, raw_wid, raw_bid;
+  wire [AXI_AWIDTH-1:0] raw_araddr, raw_awaddr;
+  wire                  raw_arvalid, raw_arready, raw_rvalid, raw_rready, raw_rlast;
+  wire                  raw_awvalid, raw_awready, raw_wvalid, raw_wready, raw_wlast;
+  wire                  raw_bvalid, raw_bready;
+  wire [7:0]            raw_arlen, raw_awlen;
+  wire [2:0]            raw_arsize, raw_awsize;
+  wire [1:0]            raw_arburst, raw_awburst, raw_rresp, raw_bresp;
+  wire [AXI_DWIDTH-1:0] raw_rdata, raw_wdata;
+  wire [AXI_DWIDTH/8-1:0] raw_wstrb;
+
+  wire                  core_read_request_valid, core_read_request_ready;
+  wire [AXI_AWIDTH-1:0] core_read_addr;
+  wire [31:0]           core_read_len;
+  wire [2:0]            core_read_size;
+  wire [1:0]            core_read_burst;
+  wire [AXI_DWIDTH-1:0] core_read_data;
+  wire                  core_read_data_valid, core_read_data_ready;
+
+  wire                  core_write_request_valid, core_write_request_ready;
+  wire [AXI_AWIDTH-1:0] core_write_addr;
+  wire [31:0]           core_write_len;
+  wire [2:0]            core_write_size;
+  wire [1:0]            core_write_burst;
+  wire [AXI_DWIDTH-1:0] core_write_data;
+  wire                  core_write_data_valid, core_write_data_ready;
+  wire                  core_write_idle;
+
+  wire                  dma_read_request_valid, dma_read_request_ready;
+  wire [AXI_AWIDTH-1:0] dma_read_addr;
+  wire [31:0]           dma_read_len;
+  wire [2:0]            dma_read_size;
+  wire [1:0]            dma_read_burst;
+  wire [AXI_DWIDTH-1:0] dma_read_data;
+  wire                  dma_read_data_valid, dma_read_data_ready;
+
+  wire                  dma_write_request_valid, dma_write_request_ready;
+  wire [AXI_AWIDTH-1:0] dma_write_addr;
+  wire [31:0]           dma_write_len;
+  wire [2:0]            dma_write_size;
+  wire [1:0]            dma_write_burst;
+  wire [AXI_DWIDTH-1:0] dma_write_data;
+  wire                  dma_write_data_valid, dma_write_data_ready;
+  wire                  dma_write_idle;
+
+  reg dma_start, dma_desc_start, dma_dir;
+  reg [31:0] dma_src_addr, dma_dst_addr, dma_len, dma_desc_addr;
+  wire dma_done;
+
+  wire [DMEM_AWIDTH-1:0] dmem_addr;
+  wire [31:0]            dmem_din, dmem_dout;
+  wire [3:0]             dmem_wbe;
+  wire                   dmem_en;
+
+  dma_controller #(
+    .AXI_AWIDTH(AXI_AWIDTH),
+    .AXI_DWIDTH(AXI_DWIDTH),
+    .DMEM_AWIDTH(DMEM_AWIDTH),
+    .DMEM_DWIDTH(32)
+  ) raw_dma (
+    .clk(clk),
+    .resetn(~rst),
+
+    .dma_read_request_valid(dma_read_request_valid),
+    .dma_read_request_ready(dma_read_request_ready),
+    .dma_read_addr(dma_read_addr),
+    .dma_read_len(dma_read_len),
+    .dma_read_size(dma_read_size),
+    .dma_read_burst(dma_read_burst),
+    .dma_read_data(dma_read_data),
+    .dma_read_data_valid(dma_read_data_valid),
+    .dma_read_data_ready(dma_read_data_ready),
+
+    .dma_write_request_valid(dma_write_request_valid),
+    .dma_write_request_ready(dma_write_request_ready),
+    .dma_write_addr(dma_write_addr),
+    .dma_write_len(dma_write_len),
+    .dma_write_size(dma_write_size),
+    .dma_write_burst(dma_write_burst),
+    .dma_write_data(dma_write_data),
+    .dma_write_data_valid(dma_write_data_valid),
+    .dma_write_data_ready(dma_write_data_ready),
+    .dma_write_idle(dma_write_idle),
+
+    .dma_start(dma_start),
+    .dma_done(dma_done),
+    .dma_idle(),
+    .dma_dir(dma_dir),
+    .dma_src_addr(dma_src_addr),
+    .dma_dst_addr(dma_dst_addr),
+    .dma_len(dma_len),
+    .dma_desc_start(dma_desc_start),
+    .dma_desc_addr(dma_desc_addr),
+    .dma_desc_count(),
+    .dma_sum(),
+    .dma_crc(),
+
+    .dmem_addr(dmem_addr),
+    .dmem_din(dmem_din),
+    .dmem_dout(dmem_dout),
+    .dmem_wbe(dmem_wbe),
+    .dmem_en(dmem_en),
+
+    .imem_addr(),
+    .imem_din(),
+    .imem_wbe()
+  );
+
+  SYNC_RAM_WBE #(
+    .AWIDTH(DMEM_AWIDTH),
+    .DWIDTH(32)
+  ) raw_dmem (
+    .q(dmem_dout),
+    .d(dmem_din),
+    .addr(dmem_addr),
+    .wbe(dmem_wbe),
+    .en(dmem_en),
+    .clk(clk)
+  );
+
+  // The accelerator side of the arbiter is left idle
+  arbiter #(
+    .AXI_AWIDTH(AXI_AWIDTH),
+    .AXI_DWIDTH(AXI_DWIDTH)
+  ) raw_arb (
+    .clk(clk),
+    .rst(rst),
+
+    .core_read_request_valid(core_read_request_valid),
+    .core_read_request_ready(core_read_request_ready),
+    .core_read_addr(core_read_addr),
+    .core_read_len(core_read_len),
+    .core_read_size(core_read_size),
+    .core_read_burst(core_read_burst),
+    .core_read_data(core_read_data),
+    .core_read_data_valid(core_read_data_valid),
+    .core_read_data_ready(core_read_data_ready),
+
+    .core_write_request_valid(core_write_request_valid),
+    .core_write_request_ready(core_write_request_ready),
+    .core_write_addr(core_write_addr),
+    .core_write_len(core_write_len),
+    .core_write_size(core_write_size),
+    .core_write_burst(core_write_burst),
+    .core_write_data(core_write_data),
+    .core_write_data_valid(core_write_data_valid),
+    .core_write_data_ready(core_write_data_ready),
+    .core_write_idle(core_write_idle),
+
+    .dma_read_request_valid(dma_read_request_valid),
+    .dma_read_request_ready(dma_read_request_ready),
+    .dma_read_addr(dma_read_addr),
+    .dma_read_len(dma_read_len),
+    .dma_read_size(dma_read_size),
+    .dma_read_burst(dma_read_burst),
+    .dma_read_data(dma_read_data),
+    .dma_read_data_valid(dma_read_data_valid),
+    .dma_read_data_ready(dma_read_data_ready),
+
+    .dma_write_request_valid(dma_write_request_valid),
+    .dma_write_request_ready(dma_write_request_ready),
+    .dma_write_addr(dma_write_addr),
+    .dma_write_len(dma_write_len),
+    .dma_write_size(dma_write_size),
+    .dma_write_burst(dma_write_burst),
+    .dma_write_data(dma_write_data),
+    .dma_write_data_valid(dma_write_data_valid),
+    .dma_write_data_ready(dma_write_data_ready),
+    .dma_write_idle(dma_write_idle),
+
+    .xcel_read_request_valid(1'b0),
+    .xcel_read_request_ready(),
+    .xcel_read_addr(0),
+    .xcel_read_len(0),
+    .xcel_read_size(3'd2),
+    .xcel_read_burst(`BURST_INCR),
+    .xcel_read_data(),
+    .xcel_read_data_valid(),
+    .xcel_read_data_ready(1'b0),
+
+    .xcel_write_request_valid(1'b0),
+    .xcel_write_request_ready(),
+    .xcel_write_addr(0),
+    .xcel_write_len(0),
+    .xcel_write_size(3'd2),
+    .xcel_write_burst(`BURST_INCR),
+    .xcel_write_data(0),
+    .xcel_write_data_valid(1'b0),
+    .xcel_write_data_ready(),
+    .xcel_write_idle()
+  );
+
+  axi_mm_adapter #(
+    .AXI_AWIDTH(AXI_AWIDTH),
+    .AXI_DWIDTH(AXI_DWIDTH)
+  ) raw_adapter (
+    .clk(clk),
+    .resetn(~rst),
+
+    .arid(raw_arid),
+    .araddr(raw_araddr),
+    .arvalid(raw_arvalid),
+    .arready(raw_arready),
+    .arlen(raw_arlen),
+    .arsize(raw_arsize),
+    .arburst(raw_arburst),
+
+    .rid(raw_rid),
+    .rdata(raw_rdata),
+    .rvalid(raw_rvalid),
+    .rready(raw_rready),
+    .rlast(raw_rlast),
+    .rresp(raw_rresp),
+
+    .awid(raw_awid),
+    .awaddr(raw_awaddr),
+    .awvalid(raw_awvalid),
+    .awready(raw_awready),
+    .awlen(raw_awlen),
+    .awsize(raw_awsize),
+    .awburst(raw_awburst),
+
+    .wid(raw_wid),
+    .wdata(raw_wdata),
+    .wvalid(raw_wvalid),
+    .wready(raw_wready),
+    .wlast(raw_wlast),
+    .wstrb(raw_wstrb),
+
+    .bid(raw_bid),
+    .bresp(raw_bresp),
+    .bvalid(raw_bvalid),
+    .bready(raw_bready),
+
+    .core_read_request_valid(core_read_request_valid),
+    .core_read_request_ready(core_read_request_ready),
+    .core_read_addr(core_read_addr),
+    .core_read_len(core_read_len),
+    .core_read_size(core_read_size),
+    .core_read_burst(core_read_burst),
+    .core_read_data(core_read_data),
+    .core_read_data_valid(core_read_data_valid),
+    .core_read_data_ready(core_read_data_ready),
+
+    .core_write_request_valid(core_write_request_valid),
+    .core_write_request_ready(core_write_request_ready),
+    .core_write_addr(core_write_addr),
+    .core_write_len(core_write_len),
+    .core_write_size(core_write_size),
+    .core_write_burst(core_write_burst),
+    .core_write_data(core_write_data),
+    .core_write_data_valid(core_write_data_valid),
+    .core_write_data_ready(core_write_data_ready),
+    .core_write_idle(core_write_idle)
+  );
+
+  axi_mem_model #(
+    .AXI_AWIDTH(AXI_AWIDTH),
+    .AXI_DWIDTH(AXI_DWIDTH),
+    .DELAY(RAW_DELAY),
+    .B_DELAY(RAW_B_DELAY)
+  ) raw_mem (
+    .clk(clk),
+    .rst(rst),
+
+    .arid(raw_arid),
+    .araddr(raw_araddr),
+    .arvalid(raw_arvalid),
+    .arready(raw_arready),
+    .arlen(raw_arlen),
+    .arsize(raw_arsize),
+    .arburst(raw_arburst),
+
+    .rid(raw_rid),
+    .rdata(raw_rdata),
+    .rvalid(raw_rvalid),
+    .rready(raw_rready),
+    .rlast(raw_rlast),
+    .rresp(raw_rresp),
+
+    .awid(raw_awid),
+    .awaddr(raw_awaddr),
+    .awvalid(raw_awvalid),
+    .awready(raw_awready),
+    .awlen(raw_awlen),
+    .awsize(raw_awsize),
+    .awburst(raw_awburst),
+
+    .wid(raw_wid),
+    .wdata(raw_wdata),
+    .wvalid(raw_wvalid),
+    .wready(raw_wready),
+    .wlast(raw_wlast),
+    .wstrb(raw_wstrb),
+
+    .bid(raw_bid),
+    .bresp(raw_bresp),
+    .bvalid(raw_bvalid),
+    .bready(raw_bready)
+  );
+
+  task run_dma;
+    input chain;
+    begin
+      @(negedge clk);
+      if (chain)
+        dma_desc_start = 1'b1;
+      else
+        dma_start = 1'b1;
+
+      @(negedge clk);
+      dma_start      = 1'b0;
+      dma_desc_start = 1'b0;
+
+      wait (dma_done === 1'b1);
+      // done only once the write responses are in
+      if (raw_adapter.write_unit.outstanding_value != 0) begin
+        num_mismatches = num_mismatches + 1;
+        $display("[DMA] done with %0d write bursts unacknowledged",
+                 raw_adapter.write_unit.outstanding_value);
+      end
+      @(posedge clk); #1;
+    end
+  endtask
+
+  task check_raw;
+    input [31:0] got;
+    input [31:0] expected;
+    input [255:0] what;
+    begin
+      if (got !== expected) begin
+        num_mismatches = num_mismatches + 1;
+        $display("[DMA] %0s mismatch: expected %h, got %h", what, expected, got);
+      end
+    end
+  endtask
+
+  reg raw_done;
+  integer w;
+
+  // DDR layout (word addresses): old data at 0 and 64
+  // DMem layout (word addresses): new data at 0, read back to 256 (single
+  // transfers) and 512 (chain), descriptors at 1024
+  initial begin
+    raw_done       = 1'b0;
+    dma_start      = 1'b0;
+    dma_desc_start = 1'b0;
+    dma_dir        = 1'b0;
+    dma_src_addr   = 0;
+    dma_dst_addr   = 0;
+    dma_len        = 0;
+    dma_desc_addr  = 0;
+
+    for (w = 0; w < RAW_LEN; w = w + 1) begin
+      raw_mem.mem[w]      = 32'hb000_0000 + w;
+      raw_mem.mem[64 + w] = 32'hb000_0000 + 64 + w;
+      raw_dmem.mem[w]     = 32'hc000_0000 + w;
+    end
+
+    wait (rst === 1'b0);
+
+    // Single transfers: DMem[0..15] -> DDR[0..15], then DDR[0..15] ->
+    // DMem[256..271]
+    dma_dir      = 1'b1;
+    dma_src_addr = 0;
+    dma_dst_addr = 0;
+    dma_len      = RAW_LEN;
+    run_dma(1'b0);
+
+    dma_dir      = 1'b0;
+    dma_src_addr = 0;
+    dma_dst_addr = 256;
+    run_dma(1'b0);
+
+    for (w = 0; w < RAW_LEN; w = w + 1)
+      check_raw(raw_dmem.mem[256 + w], 32'hc000_0000 + w, "single");
+
+    // The same in one chain: DMem[0..15] -> DDR[64..79], then DDR[64..79]
+    // -> DMem[512..527]
+    raw_dmem.mem[1024 + 0] = 32'h1;
+    raw_dmem.mem[1024 + 1] = 0;
+    raw_dmem.mem[1024 + 2] = 64 << 2;
+    raw_dmem.mem[1024 + 3] = RAW_LEN;
+    raw_dmem.mem[1024 + 4] = 1032;
+    raw_dmem.mem[1024 + 5] = 1;
+    raw_dmem.mem[1024 + 6] = 0;
+    raw_dmem.mem[1024 + 7] = 0;
+    raw_dmem.mem[1032 + 0] = 32'h2;
+    raw_dmem.mem[1032 + 1] = 64 << 2;
+    raw_dmem.mem[1032 + 2] = 512;
+    raw_dmem.mem[1032 + 3] = RAW_LEN;
+    raw_dmem.mem[1032 + 4] = 0;
+    raw_dmem.mem[1032 + 5] = 1;
+    raw_dmem.mem[1032 + 6] = 0;
+    raw_dmem.mem[1032 + 7] = 0;
+
+    dma_desc_addr = 1024;
+    run_dma(1'b1);
+
+    for (w = 0; w < RAW_LEN; w = w + 1)
+      check_raw(raw_dmem.mem[512 + w], 32'hc000_0000 + w, "chain");
+
+    raw_done = 1'b1;
+  end
+
+  initial begin
+    #0;
+    rst = 1'b1;
+    repeat (10) @(posedge clk);
+
+    @(negedge clk);
+    rst = 1'b0;
+
+    wait (&config_done === 1'b1 && raw_done === 1'b1);
+
+    if (num_mismatches == 0)
+      $display("Test passed!");
+    else
+      $display("Test failed! Num. mismatches: %d", num_mismatches);
+
+    $finish();
+  end
+
+  initial begin
+    repeat (TIMEOUT_CYCLE) @(posedge clk);
+    $display("Timeout!");
+    $finish();
+  end
+
+endmodule
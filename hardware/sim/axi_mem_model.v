@@ -0,0 +1,183 @@
+`include "axi_consts.vh"
+
+// AXI4 slave memory model for RTL simulation of the AXI adapter
+// (mem_model stands in for the adapter and DDR together; this one sits on
+// the AXI side of the adapter instead)
+//
+// Each read burst returns its first beat DELAY cycles after its address
+// handshake, and each write burst gets its response B_DELAY cycles after its
+// last data beat. A write burst only reaches the memory with its response:
+// until then, a read of the same words returns the old data, as a read can
+// overtake a write on its way to DDR. Up to MAX_OUTSTANDING bursts per
+// direction are accepted ahead, so the latency of back-to-back bursts
+// overlaps. Beats are served one per cycle, in order (single ID). Only INCR
+// bursts of full-width beats are modeled
+module axi_mem_model #(
+  parameter AXI_AWIDTH      = 32,
+  parameter AXI_DWIDTH      = 32,
+  parameter MEM_AWIDTH      = 14,
+  parameter DELAY           = 50,
+  parameter B_DELAY         = DELAY,
+  parameter MAX_OUTSTANDING = 8
+) (
+  input clk,
+  input rst,
+
+  // Read address channel
+  input  [3:0]            arid,
+  input  [AXI_AWIDTH-1:0] araddr,
+  input                   arvalid,
+  output                  arready,
+  input  [7:0]            arlen,
+  input  [2:0]            arsize,
+  input  [1:0]            arburst,
+
+  // Read data channel
+  output [3:0]            rid,
+  output [AXI_DWIDTH-1:0] rdata,
+  output                  rvalid,
+  input                   rready,
+  output                  rlast,
+  output [1:0]            rresp,
+
+  // Write address channel
+  input  [3:0]            awid,
+  input  [AXI_AWIDTH-1:0] awaddr,
+  input                   awvalid,
+  output                  awready,
+  input  [7:0]            awlen,
+  input  [2:0]            awsize,
+  input  [1:0]            awburst,
+
+  // Write data channel
+  input  [3:0]              wid,
+  input  [AXI_DWIDTH-1:0]   wdata,
+  input                     wvalid,
+  output                    wready,
+  input                     wlast,
+  input  [AXI_DWIDTH/8-1:0] wstrb,
+
+  // Write response channel
+  output [3:0] bid,
+  output [1:0] bresp,
+  output       bvalid,
+  input        bready
+);
+
+  localparam WORD_SHIFT = $clog2(AXI_DWIDTH / 8);
+
+  reg [AXI_DWIDTH-1:0] mem [0:(1 << MEM_AWIDTH)-1];
+
+  wire ar_fire = arvalid & arready;
+  wire r_fire  = rvalid  & rready;
+  wire aw_fire = awvalid & awready;
+  wire w_fire  = wvalid  & wready;
+  wire b_fire  = bvalid  & bready;
+
+  reg [31:0] cycle;
+  always @(posedge clk) begin
+    if (rst)
+      cycle <= 0;
+    else
+      cycle <= cycle + 1;
+  end
+
+  // Read bursts: word address, length, cycle of the first beat
+  reg [AXI_AWIDTH-1:0] ar_addr_q [0:MAX_OUTSTANDING-1];
+  reg [7:0]            ar_len_q  [0:MAX_OUTSTANDING-1];
+  reg [31:0]           ar_due_q  [0:MAX_OUTSTANDING-1];
+  integer ar_head, ar_tail, ar_count;
+  reg [7:0] r_beat;
+
+  assign arready = ar_count < MAX_OUTSTANDING;
+  assign rvalid  = (ar_count > 0) && (cycle >= ar_due_q[ar_head]);
+  assign rdata   = mem[(ar_addr_q[ar_head] + r_beat) % (1 << MEM_AWIDTH)];
+  assign rlast   = r_beat == ar_len_q[ar_head];
+  assign rid     = 0;
+  assign rresp   = `RESP_OKAY;
+
+  always @(posedge clk) begin
+    if (rst) begin
+      ar_head  <= 0;
+      ar_tail  <= 0;
+      ar_count <= 0;
+      r_beat   <= 0;
+    end
+    else begin
+      if (ar_fire) begin
+        ar_addr_q[ar_tail] <= araddr >> WORD_SHIFT;
+        ar_len_q[ar_tail]  <= arlen;
+        ar_due_q[ar_tail]  <= cycle + DELAY;
+        ar_tail <= (ar_tail + 1) % MAX_OUTSTANDING;
+      end
+
+      if (r_fire) begin
+        r_beat <= rlast ? 0 : r_beat + 1;
+        if (rlast)
+          ar_head <= (ar_head + 1) % MAX_OUTSTANDING;
+      end
+
+      ar_count <= ar_count + ar_fire - (r_fire & rlast);
+    end
+  end
+
+  // Write bursts: word address, then the data, address, length and
+  // response due cycle, until the response
+  reg [AXI_AWIDTH-1:0] aw_addr_q [0:MAX_OUTSTANDING-1];
+  integer aw_head, aw_tail, aw_count;
+  reg [7:0] w_beat;
+
+  reg [AXI_DWIDTH-1:0] b_data_q [0:MAX_OUTSTANDING*256-1];
+  reg [AXI_AWIDTH-1:0] b_addr_q [0:MAX_OUTSTANDING-1];
+  reg [7:0]            b_len_q  [0:MAX_OUTSTANDING-1];
+  reg [31:0]           b_due_q  [0:MAX_OUTSTANDING-1];
+  integer b_head, b_tail, b_count;
+  integer k;
+
+  assign awready = aw_count < MAX_OUTSTANDING;
+  // data is taken once its address is in
+  assign wready  = (aw_count > 0) && (b_count < MAX_OUTSTANDING);
+  assign bvalid  = (b_count > 0) && (cycle >= b_due_q[b_head]);
+  assign bid     = 0;
+  assign bresp   = `RESP_OKAY;
+
+  always @(posedge clk) begin
+    if (rst) begin
+      aw_head  <= 0;
+      aw_tail  <= 0;
+      aw_count <= 0;
+      w_beat   <= 0;
+      b_head   <= 0;
+      b_tail   <= 0;
+      b_count  <= 0;
+    end
+    else begin
+      if (aw_fire) begin
+        aw_addr_q[aw_tail] <= awaddr >> WORD_SHIFT;
+        aw_tail <= (aw_tail + 1) % MAX_OUTSTANDING;
+      end
+
+      if (w_fire) begin
+        b_data_q[b_tail * 256 + w_beat] <= wdata;
+        w_beat <= wlast ? 0 : w_beat + 1;
+        if (wlast) begin
+          aw_head <= (aw_head + 1) % MAX_OUTSTANDING;
+          b_addr_q[b_tail] <= aw_addr_q[aw_head];
+          b_len_q[b_tail]  <= w_beat;
+          b_due_q[b_tail]  <= cycle + B_DELAY;
+          b_tail <= (b_tail + 1) % MAX_OUTSTANDING;
+        end
+      end
+
+      if (b_fire) begin
+        for (k = 0; k <= b_len_q[b_head]; k = k + 1)
+          mem[(b_addr_q[b_head] + k) % (1 << MEM_AWIDTH)] <= b_data_q[b_head * 256 + k];
+        b_head <= (b_head + 1) % MAX_OUTSTANDING;
+      end
+
+      aw_count <= aw_count + aw_fire - (w_fire & wlast);
+      b_count  <= b_count + (w_fire & wlast) - b_fire;
+    end
+  end
+
+endmodule
@@ -29,7 +29,8 @@ module bios_testbench();
     .rst(rst),
     .FPGA_SERIAL_RX(serial_in),   // input
     .FPGA_SERIAL_TX(serial_out),  // output
-    .csr()
+    .csr(),
+    .dma_imem_wbe(4'd0) // no DMA writes to IMem
   );
 
   integer i, j;
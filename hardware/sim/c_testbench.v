@@ -24,7 +24,8 @@ module c_testbench();
     .rst(rst),
     .FPGA_SERIAL_RX(serial_in),   // input
     .FPGA_SERIAL_TX(serial_out),  // output
-    .csr(csr)
+    .csr(csr),
+    .dma_imem_wbe(4'd0) // no DMA writes to IMem
   );
 
   integer i, j;
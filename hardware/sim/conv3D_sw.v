@@ -5,7 +5,8 @@ module conv3D_sw #(
   parameter IFM_DEPTH = 2,
   parameter OFM_DIM   = 24,
   parameter OFM_DEPTH = 2,
-  parameter WT_DIM    = 5
+  parameter WT_DIM    = 5,
+  parameter WT_INT4   = 0  // weights limited to the signed 4-bit range
 ) ();
 
   integer ifm_data[IFM_DEPTH*IFM_DIM*IFM_DIM-1:0];
@@ -31,6 +32,10 @@ module conv3D_sw #(
         for (m = 0; m < WT_DIM; m = m + 1) begin
           for (n = 0; n < WT_DIM; n = n + 1) begin
             wt_data[f * IFM_DEPTH * WT_DIM * WT_DIM + d * WT_DIM * WT_DIM + m * WT_DIM + n] = (n % 2 == 0) ? -(f + d + m + n) : (f + d + m + n);
+            // wrap around to [-8, 7] (sign-extend the low nibble)
+            if (WT_INT4)
+              wt_data[f * IFM_DEPTH * WT_DIM * WT_DIM + d * WT_DIM * WT_DIM + m * WT_DIM + n] =
+                ((wt_data[f * IFM_DEPTH * WT_DIM * WT_DIM + d * WT_DIM * WT_DIM + m * WT_DIM + n] & 15) ^ 8) - 8;
           end
         end
       end
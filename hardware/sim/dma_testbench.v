@@ -0,0 +1,481 @@
+`timescale 1ns/1ns
+
+// DMA controller against the memory model (DDR) and DMem/IMem models:
+// one single transfer, a chain of descriptors in DMem, then 2D (strided),
+// DMem -> DMem and DDR -> IMem transfers. The DMA moves one DMem word per
+// beat; with a wider AXI_DWIDTH, it goes through axi_upsizer as in z1top_axi
+module dma_testbench();
+  reg clk, rst;
+  parameter CPU_CLOCK_PERIOD = 20;
+
+  initial clk = 0;
+  always #(CPU_CLOCK_PERIOD/2) clk = ~clk;
+
+  localparam TIMEOUT_CYCLE = 100_000;
+
+  localparam AXI_AWIDTH  = 32;
+  // DDR data path width: 32, 64 or 128
+  parameter  AXI_DWIDTH  = 32;
+  localparam DMEM_AWIDTH = 14;
+  localparam DMEM_DWIDTH = 32;
+
+  wire dma_n_read_request_valid;
+  wire dma_n_read_request_ready;
+  wire [AXI_AWIDTH-1:0] dma_n_read_addr;
+  wire [31:0] dma_n_read_len;
+  wire [2:0] dma_n_read_size;
+  wire [1:0] dma_n_read_burst;
+  wire [DMEM_DWIDTH-1:0] dma_n_read_data;
+  wire dma_n_read_data_valid;
+  wire dma_n_read_data_ready;
+
+  wire dma_n_write_request_valid;
+  wire dma_n_write_request_ready;
+  wire [AXI_AWIDTH-1:0] dma_n_write_addr;
+  wire [31:0] dma_n_write_len;
+  wire [2:0] dma_n_write_size;
+  wire [1:0] dma_n_write_burst;
+  wire [DMEM_DWIDTH-1:0] dma_n_write_data;
+  wire dma_n_write_data_valid;
+  wire dma_n_write_data_ready;
+
+  wire dma_read_request_valid;
+  wire dma_read_request_ready;
+  wire [AXI_AWIDTH-1:0] dma_read_addr;
+  wire [31:0] dma_read_len;
+  wire [2:0] dma_read_size;
+  wire [1:0] dma_read_burst;
+  wire [AXI_DWIDTH-1:0] dma_read_data;
+  wire dma_read_data_valid;
+  wire dma_read_data_ready;
+
+  wire dma_write_request_valid;
+  wire dma_write_request_ready;
+  wire [AXI_AWIDTH-1:0] dma_write_addr;
+  wire [31:0] dma_write_len;
+  wire [2:0] dma_write_size;
+  wire [1:0] dma_write_burst;
+  wire [AXI_DWIDTH-1:0] dma_write_data;
+  wire dma_write_data_valid;
+  wire dma_write_data_ready;
+
+  reg dma_start, dma_desc_start, dma_dir;
+  reg [31:0] dma_src_addr, dma_dst_addr, dma_len, dma_desc_addr;
+  wire dma_done, dma_idle;
+  wire [31:0] dma_desc_count;
+  wire [31:0] dma_sum, dma_crc;
+
+  wire [DMEM_AWIDTH-1:0]   dmem_addr;
+  wire [DMEM_DWIDTH-1:0]   dmem_din, dmem_dout;
+  wire [DMEM_DWIDTH/8-1:0] dmem_wbe;
+  wire                     dmem_en;
+
+  wire [DMEM_AWIDTH-1:0]   imem_addr;
+  wire [DMEM_DWIDTH-1:0]   imem_din;
+  wire [DMEM_DWIDTH/8-1:0] imem_wbe;
+
+  dma_controller #(
+    .AXI_AWIDTH(AXI_AWIDTH),
+    .AXI_DWIDTH(DMEM_DWIDTH),
+    .DMEM_AWIDTH(DMEM_AWIDTH),
+    .DMEM_DWIDTH(DMEM_DWIDTH)
+  ) dut (
+    .clk(clk),
+    .resetn(~rst),
+
+    .dma_read_request_valid(dma_n_read_request_valid),   // output
+    .dma_read_request_ready(dma_n_read_request_ready),   // input
+    .dma_read_addr(dma_n_read_addr),                     // output
+    .dma_read_len(dma_n_read_len),                       // output
+    .dma_read_size(dma_n_read_size),                     // output
+    .dma_read_burst(dma_n_read_burst),                   // output
+    .dma_read_data(dma_n_read_data),                     // input
+    .dma_read_data_valid(dma_n_read_data_valid),         // input
+    .dma_read_data_ready(dma_n_read_data_ready),         // output
+
+    .dma_write_request_valid(dma_n_write_request_valid), // output
+    .dma_write_request_ready(dma_n_write_request_ready), // input
+    .dma_write_addr(dma_n_write_addr),                   // output
+    .dma_write_len(dma_n_write_len),                     // output
+    .dma_write_size(dma_n_write_size),                   // output
+    .dma_write_burst(dma_n_write_burst),                 // output
+    .dma_write_data(dma_n_write_data),                   // output
+    .dma_write_data_valid(dma_n_write_data_valid),       // output
+    .dma_write_data_ready(dma_n_write_data_ready),       // input
+    .dma_write_idle(1'b1),                               // input (mem_model stores a write at once)
+
+    .dma_start(dma_start),           // input
+    .dma_done(dma_done),             // output
+    .dma_idle(dma_idle),             // output
+    .dma_dir(dma_dir),               // input
+    .dma_src_addr(dma_src_addr),     // input
+    .dma_dst_addr(dma_dst_addr),     // input
+    .dma_len(dma_len),               // input
+    .dma_desc_start(dma_desc_start), // input
+    .dma_desc_addr(dma_desc_addr),   // input
+    .dma_desc_count(dma_desc_count), // output
+    .dma_sum(dma_sum),               // output
+    .dma_crc(dma_crc),               // output
+
+    .dmem_addr(dmem_addr), // output
+    .dmem_din(dmem_din),   // output
+    .dmem_dout(dmem_dout), // input
+    .dmem_wbe(dmem_wbe),   // output
+    .dmem_en(dmem_en),     // output
+
+    .imem_addr(imem_addr), // output
+    .imem_din(imem_din),   // output
+    .imem_wbe(imem_wbe)    // output
+  );
+
+  axi_upsizer #(
+    .AXI_AWIDTH(AXI_AWIDTH),
+    .NARROW_DWIDTH(DMEM_DWIDTH),
+    .WIDE_DWIDTH(AXI_DWIDTH)
+  ) upsizer (
+    .clk(clk),
+    .rst(rst),
+
+    .narrow_read_request_valid(dma_n_read_request_valid),
+    .narrow_read_request_ready(dma_n_read_request_ready),
+    .narrow_read_addr(dma_n_read_addr),
+    .narrow_read_len(dma_n_read_len),
+    .narrow_read_size(dma_n_read_size),
+    .narrow_read_burst(dma_n_read_burst),
+    .narrow_read_data(dma_n_read_data),
+    .narrow_read_data_valid(dma_n_read_data_valid),
+    .narrow_read_data_ready(dma_n_read_data_ready),
+
+    .narrow_write_request_valid(dma_n_write_request_valid),
+    .narrow_write_request_ready(dma_n_write_request_ready),
+    .narrow_write_addr(dma_n_write_addr),
+    .narrow_write_len(dma_n_write_len),
+    .narrow_write_size(dma_n_write_size),
+    .narrow_write_burst(dma_n_write_burst),
+    .narrow_write_data(dma_n_write_data),
+    .narrow_write_data_valid(dma_n_write_data_valid),
+    .narrow_write_data_ready(dma_n_write_data_ready),
+
+    .wide_read_request_valid(dma_read_request_valid),
+    .wide_read_request_ready(dma_read_request_ready),
+    .wide_read_addr(dma_read_addr),
+    .wide_read_len(dma_read_len),
+    .wide_read_size(dma_read_size),
+    .wide_read_burst(dma_read_burst),
+    .wide_read_data(dma_read_data),
+    .wide_read_data_valid(dma_read_data_valid),
+    .wide_read_data_ready(dma_read_data_ready),
+
+    .wide_write_request_valid(dma_write_request_valid),
+    .wide_write_request_ready(dma_write_request_ready),
+    .wide_write_addr(dma_write_addr),
+    .wide_write_len(dma_write_len),
+    .wide_write_size(dma_write_size),
+    .wide_write_burst(dma_write_burst),
+    .wide_write_data(dma_write_data),
+    .wide_write_data_valid(dma_write_data_valid),
+    .wide_write_data_ready(dma_write_data_ready)
+  );
+
+  // DMem (port b)
+  SYNC_RAM_WBE #(
+    .AWIDTH(DMEM_AWIDTH),
+    .DWIDTH(DMEM_DWIDTH)
+  ) dmem (
+    .q(dmem_dout),
+    .d(dmem_din),
+    .addr(dmem_addr),
+    .wbe(dmem_wbe),
+    .en(dmem_en),
+    .clk(clk)
+  );
+
+  // IMem (port a, write only here)
+  SYNC_RAM_WBE #(
+    .AWIDTH(DMEM_AWIDTH),
+    .DWIDTH(DMEM_DWIDTH)
+  ) imem (
+    .q(),
+    .d(imem_din),
+    .addr(imem_addr),
+    .wbe(imem_wbe),
+    .en(1'b1),
+    .clk(clk)
+  );
+
+  localparam MEM_AWIDTH = 14;
+
+  mem_model #(
+    .AXI_AWIDTH(AXI_AWIDTH),
+    .AXI_DWIDTH(AXI_DWIDTH),
+    .MEM_AWIDTH(MEM_AWIDTH)
+  ) mm_unit (
+    .clk(clk),
+    .rst(rst),
+
+    .read_request_valid(dma_read_request_valid),   // input
+    .read_request_ready(dma_read_request_ready),   // output
+    .read_request_addr(dma_read_addr),             // input
+    .read_len(dma_read_len),                       // input
+    .read_size(dma_read_size),                     // input
+    .read_data(dma_read_data),                     // output
+    .read_data_valid(dma_read_data_valid),         // output
+    .read_data_ready(dma_read_data_ready),         // input
+
+    .write_request_valid(dma_write_request_valid), // input
+    .write_request_ready(dma_write_request_ready), // output
+    .write_request_addr(dma_write_addr),           // input
+    .write_len(dma_write_len),                     // input
+    .write_size(dma_write_size),                   // input
+    .write_data(dma_write_data),                   // output
+    .write_data_valid(dma_write_data_valid),       // output
+    .write_data_ready(dma_write_data_ready)        // input
+  );
+
+  integer i;
+  integer num_mismatches = 0;
+
+  // The memory model holds one AXI_DWIDTH beat per entry; these access it
+  // one 32-bit word (word address w) at a time
+  localparam MEM_RATIO = AXI_DWIDTH / 32;
+
+  task mem_write_word;
+    input integer w;
+    input [31:0] data;
+    begin
+      mm_unit.buffer.mem[w / MEM_RATIO][(w % MEM_RATIO) * 32 +: 32] = data;
+    end
+  endtask
+
+  function [31:0] mem_read_word;
+    input integer w;
+    begin
+      mem_read_word = mm_unit.buffer.mem[w / MEM_RATIO][(w % MEM_RATIO) * 32 +: 32];
+    end
+  endfunction
+
+  task check;
+    input [31:0] got;
+    input [31:0] expected;
+    input [255:0] what;
+    begin
+      if (got !== expected) begin
+        num_mismatches = num_mismatches + 1;
+        $display("Mismatch (%0s): expected %h, got %h", what, expected, got);
+      end
+    end
+  endtask
+
+  // Reference checksums of the words d000_0000 + first .. + first + n - 1
+  // (CRC32 as zlib's crc32() over the little-endian bytes)
+  function [31:0] ref_crc;
+    input integer first;
+    input integer n;
+    integer w, b;
+    reg [31:0] crc, word;
+    begin
+      crc = 32'hffff_ffff;
+      for (w = 0; w < n; w = w + 1) begin
+        word = 32'hd000_0000 + first + w;
+        for (b = 0; b < 32; b = b + 1)
+          crc = (crc >> 1) ^ ((crc[0] ^ word[b]) ? 32'hedb8_8320 : 32'h0);
+      end
+      ref_crc = ~crc;
+    end
+  endfunction
+
+  function [31:0] ref_sum;
+    input integer first;
+    input integer n;
+    integer w;
+    begin
+      ref_sum = 0;
+      for (w = 0; w < n; w = w + 1)
+        ref_sum = ref_sum + 32'hd000_0000 + first + w;
+    end
+  endfunction
+
+  // Write a descriptor at DMem word address addr
+  task write_desc;
+    input [31:0] addr;
+    input [31:0] flags;
+    input [31:0] src_addr;
+    input [31:0] dst_addr;
+    input [31:0] len;
+    input [31:0] next;
+    input [31:0] rows;
+    input [31:0] src_stride;
+    input [31:0] dst_stride;
+    begin
+      dmem.mem[addr + 0] = flags;
+      dmem.mem[addr + 1] = src_addr;
+      dmem.mem[addr + 2] = dst_addr;
+      dmem.mem[addr + 3] = len;
+      dmem.mem[addr + 4] = next;
+      dmem.mem[addr + 5] = rows;
+      dmem.mem[addr + 6] = src_stride;
+      dmem.mem[addr + 7] = dst_stride;
+    end
+  endtask
+
+  // Cycles taken by the last run_dma
+  integer run_cycles;
+  time run_start;
+
+  task run_dma;
+    input chain;
+    begin
+      @(negedge clk);
+      run_start = $time;
+      if (chain)
+        dma_desc_start = 1'b1;
+      else
+        dma_start = 1'b1;
+
+      @(negedge clk);
+      dma_start      = 1'b0;
+      dma_desc_start = 1'b0;
+
+      wait (dma_done === 1'b1);
+      run_cycles = ($time - run_start) / CPU_CLOCK_PERIOD;
+      @(posedge clk); #1;
+    end
+  endtask
+
+  // DDR layout (word addresses): source data at 0, DMem -> DDR results at 1024
+  // DMem layout (word addresses): descriptors at 0, data from 256
+  initial begin
+    #0;
+    rst = 1'b1;
+    dma_start      = 1'b0;
+    dma_desc_start = 1'b0;
+    dma_dir        = 1'b0;
+    dma_src_addr   = 0;
+    dma_dst_addr   = 0;
+    dma_len        = 0;
+    dma_desc_addr  = 0;
+
+    for (i = 0; i < 1024; i = i + 1)
+      mem_write_word(i, 32'hd000_0000 + i);
+
+    repeat (10) @(posedge clk);
+
+    @(negedge clk);
+    rst = 1'b0;
+
+    // Single transfer: 16 words DDR[0..15] -> DMem[256..271]
+    dma_dir      = 1'b0;
+    dma_src_addr = 0;
+    dma_dst_addr = 256;
+    dma_len      = 16;
+    run_dma(1'b0);
+
+    for (i = 0; i < 16; i = i + 1)
+      check(dmem.mem[256 + i], 32'hd000_0000 + i, "single");
+    check(dma_desc_count, 1, "single count");
+    check(dma_sum, ref_sum(0, 16), "single sum");
+    check(dma_crc, ref_crc(0, 16), "single crc");
+
+    // Chain of 3 (descriptors out of order in DMem):
+    //   DDR[32..39]  -> DMem[512..519]
+    //   DMem[256..263] -> DDR[1024..1031]
+    //   DDR[64..67]  -> DMem[600..603]
+    write_desc(0,  32'h0, 32 << 2, 512, 8, 16, 1, 0, 0);
+    write_desc(16, 32'h1, 256, 1024 << 2, 8, 8, 1, 0, 0);
+    write_desc(8,  32'h2, 64 << 2, 600, 4, 0, 0, 0, 0);
+
+    dma_desc_addr = 0;
+    run_dma(1'b1);
+
+    for (i = 0; i < 8; i = i + 1)
+      check(dmem.mem[512 + i], 32'hd000_0000 + 32 + i, "chain 0");
+    for (i = 0; i < 8; i = i + 1)
+      check(mem_read_word(1024 + i), 32'hd000_0000 + i, "chain 1");
+    for (i = 0; i < 4; i = i + 1)
+      check(dmem.mem[600 + i], 32'hd000_0000 + 64 + i, "chain 2");
+    check(dma_desc_count, 3, "chain count");
+
+    // 2D: a 4x3 tile out of a 16-word wide DDR image at DDR[128 + 2],
+    // packed into DMem[700..711], then written back with a 8-word pitch
+    // to DDR[1280..]
+    write_desc(0,  32'h0, (128 + 2) << 2, 700, 3, 8, 4, 16 << 2, 3);
+    write_desc(8,  32'h3, 700, 1280 << 2, 3, 0, 4, 3, 8 << 2);
+
+    dma_desc_addr = 0;
+    run_dma(1'b1);
+
+    for (i = 0; i < 12; i = i + 1)
+      check(dmem.mem[700 + i], 32'hd000_0000 + 128 + 2 + (i / 3) * 16 + (i % 3), "2D read");
+    for (i = 0; i < 12; i = i + 1)
+      check(mem_read_word(1280 + (i / 3) * 8 + (i % 3)),
+            32'hd000_0000 + 128 + 2 + (i / 3) * 16 + (i % 3), "2D write");
+    check(dma_desc_count, 2, "2D count");
+
+    // DMem -> DMem: copy DMem[256..271] to DMem[800..815], then fill
+    // DMem[900..909] with the word at DMem[256] (row length 1, source
+    // stride 0)
+    write_desc(0, 32'h4, 256, 800, 16, 8, 1, 0, 0);
+    write_desc(8, 32'h6, 256, 900, 1, 0, 10, 0, 1);
+
+    dma_desc_addr = 0;
+    run_dma(1'b1);
+
+    for (i = 0; i < 16; i = i + 1)
+      check(dmem.mem[800 + i], 32'hd000_0000 + i, "copy");
+    for (i = 0; i < 10; i = i + 1)
+      check(dmem.mem[900 + i], 32'hd000_0000, "fill");
+    check(dmem.mem[910], 32'h0, "fill end");
+    check(dma_desc_count, 2, "copy count");
+
+    // DDR -> IMem: DDR[96..127] -> IMem[64..95], DMem untouched
+    write_desc(0, 32'ha, 96 << 2, 64, 32, 0, 1, 0, 0);
+
+    dma_desc_addr = 0;
+    run_dma(1'b1);
+
+    for (i = 0; i < 32; i = i + 1)
+      check(imem.mem[64 + i], 32'hd000_0000 + 96 + i, "imem");
+    check(dmem.mem[64], 32'h0, "imem (DMem)");
+    check(dma_desc_count, 1, "imem count");
+    check(dma_sum, ref_sum(96, 32), "imem sum");
+    check(dma_crc, ref_crc(96, 32), "imem crc");
+
+    // Throughput: 256 words DDR[0..255] -> DMem[1024..1279], then back to
+    // DDR[2048..2303]
+    dma_dir      = 1'b0;
+    dma_src_addr = 0;
+    dma_dst_addr = 1024;
+    dma_len      = 256;
+    mm_unit.reset_stats;
+    run_dma(1'b0);
+    $display("%0d-bit: DDR -> DMem, 1024 bytes in %0d cycles (%0d bytes/100 cycles)",
+             AXI_DWIDTH, run_cycles, 1024 * 100 / run_cycles);
+    mm_unit.report_stats;
+
+    dma_dir      = 1'b1;
+    dma_src_addr = 1024;
+    dma_dst_addr = 2048 << 2;
+    mm_unit.reset_stats;
+    run_dma(1'b0);
+    $display("%0d-bit: DMem -> DDR, 1024 bytes in %0d cycles (%0d bytes/100 cycles)",
+             AXI_DWIDTH, run_cycles, 1024 * 100 / run_cycles);
+    mm_unit.report_stats;
+
+    for (i = 0; i < 256; i = i + 1)
+      check(mem_read_word(2048 + i), 32'hd000_0000 + i, "throughput");
+
+    if (num_mismatches == 0)
+      $display("Test passed!");
+    else
+      $display("Test failed! Num. mismatches: %d", num_mismatches);
+
+    $finish();
+  end
+
+  initial begin
+    repeat (TIMEOUT_CYCLE) @(posedge clk);
+    $display("Timeout!");
+    $finish();
+  end
+
+endmodule
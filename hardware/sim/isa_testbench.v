@@ -21,7 +21,8 @@ module isa_testbench();
     .rst(rst),
     .FPGA_SERIAL_RX(),
     .FPGA_SERIAL_TX(),
-    .csr(csr)
+    .csr(csr),
+    .dma_imem_wbe(4'd0) // no DMA writes to IMem
   );
 
   reg [31:0] cycle;
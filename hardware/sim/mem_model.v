@@ -1,12 +1,46 @@
-
-// Simple memory model for RTL simulation
+// Memory model for RTL simulation
 // Convert AXI interface to BRAM interface and vice versa
+//
+// The client requests are served with a simple DDR timing model, so the
+// cycle counts of the DMA and the accelerator are close to the board's:
+// - The first beat of a request comes DELAY cycles after the request (the
+//   controller and interconnect latency of a row hit). A request longer than
+//   MAX_BURST_LEN beats is split into AXI bursts, MAX_OUTSTANDING of them in
+//   flight (as in axi_mm_read/axi_mm_write), so burst k cannot start before
+//   DELAY cycles after burst k - MAX_OUTSTANDING is done.
+// - The DRAM has 2^BANK_WIDTH banks of 2^COL_WIDTH-byte rows (byte address =
+//   {row, bank, column}), one open row per bank. A beat to another row of its
+//   bank waits T_RP + T_RCD cycles (precharge, activate), a beat to an idle
+//   bank T_RCD cycles.
+// - Every T_REFI cycles, the DRAM is busy for T_RFC cycles refreshing, and
+//   all the rows are closed afterwards.
+// - Reads and writes share a bandwidth cap of BW_BYTES bytes every BW_CYCLES
+//   cycles.
+// The defaults are for the PYNQ-Z1 DDR3 (8 banks, 2 KB rows) behind a 64-bit
+// HP port, in cycles of the 50 MHz CPU/AXI clock.
+//
+// The backing store has 2^MEM_AWIDTH entries of AXI_DWIDTH bits. It can be
+// loaded from a $readmemh file with MEM_HEX, or at run time with
+// +mem_hex=<file> (after the testbench's own time-0 setup), and the tasks
+// load_hex/dump_hex do the same from a testbench. report_stats prints the
+// bytes moved, the average latency and the utilization since the last
+// reset_stats (or reset)
 module mem_model #(
-  parameter AXI_AWIDTH    = 32,
-  parameter AXI_DWIDTH    = 32,
-  parameter MEM_AWIDTH    = 14,
-  parameter MAX_BURST_LEN = 256,
-  parameter DELAY         = 50
+  parameter AXI_AWIDTH      = 32,
+  parameter AXI_DWIDTH      = 32,
+  parameter MEM_AWIDTH      = 20,
+  parameter MEM_HEX         = "",
+  parameter MAX_BURST_LEN   = 256,
+  parameter MAX_OUTSTANDING = 4,
+  parameter DELAY           = 30,
+  parameter COL_WIDTH       = 11,
+  parameter BANK_WIDTH      = 3,
+  parameter T_RCD           = 1,
+  parameter T_RP            = 1,
+  parameter T_REFI          = 390,  // 0: no refresh
+  parameter T_RFC           = 8,
+  parameter BW_BYTES        = 8,
+  parameter BW_CYCLES       = 1
 ) (
   input clk,
   input rst,
@@ -37,11 +71,13 @@ module mem_model #(
 
   wire [MEM_AWIDTH-1:0] mem_addr0, mem_addr1;
   wire [AXI_DWIDTH-1:0] mem_dout0, mem_din1;
-  wire                  mem_en0, mem_en1, mem_we1;
+  wire                  mem_en0, mem_en1;
+  wire [AXI_DWIDTH/8-1:0] mem_wbe1;
 
-  SYNC_RAM_DP #(
+  SYNC_RAM_DP_WBE #(
     .AWIDTH(MEM_AWIDTH),
-    .DWIDTH(AXI_DWIDTH)
+    .DWIDTH(AXI_DWIDTH),
+    .MIF_HEX(MEM_HEX)
   ) buffer (
     .clk(clk),
 
@@ -49,14 +85,14 @@ module mem_model #(
     .addr0(mem_addr0),
     .d0(),
     .q0(mem_dout0),
-    .we0(1'b0),
+    .wbe0({AXI_DWIDTH/8{1'b0}}),
     .en0(mem_en0),
 
     // for write
     .addr1(mem_addr1),
     .d1(mem_din1),
     .q1(),
-    .we1(mem_we1),
+    .wbe1(mem_wbe1),
     .en1(mem_en1)
   );
 
@@ -150,30 +186,6 @@ module mem_model #(
     .ce(write_request_fire)
   );
 
-  // 0 --> DELAY
-  wire [31:0] rdly_cnt_value, rdly_cnt_next;
-  wire rdly_cnt_ce, rdly_cnt_rst;
-
-  REGISTER_R_CE #(.N(32), .INIT(0)) rdly_cnt_reg (
-    .clk(clk),
-    .rst(rdly_cnt_rst),
-    .d(rdly_cnt_next),
-    .q(rdly_cnt_value),
-    .ce(rdly_cnt_ce)
-  );
-
-  // 0 --> DELAY
-  wire [31:0] wdly_cnt_value, wdly_cnt_next;
-  wire wdly_cnt_ce, wdly_cnt_rst;
-
-  REGISTER_R_CE #(.N(32), .INIT(0)) wdly_cnt_reg (
-    .clk(clk),
-    .rst(wdly_cnt_rst),
-    .d(wdly_cnt_next),
-    .q(wdly_cnt_value),
-    .ce(wdly_cnt_ce)
-  );
-
   wire r_idle   = state_r_value == STATE_R_IDLE;
   wire r_run    = state_r_value == STATE_R_RUN;
   wire r_run_dl = state_r_value == STATE_R_RUN_DELAY;
@@ -185,6 +197,88 @@ module mem_model #(
   wire w_delay  = state_w_value == STATE_W_MEM_DELAY;
   wire w_done   = state_w_value == STATE_W_DONE;
 
+  // One buffer entry per AXI_DWIDTH beat
+  localparam FULL_SIZE = $clog2(AXI_DWIDTH / 8);
+
+  // Byte address of the read beat on the data channel (read_cnt is one beat
+  // ahead, for the synchronous memory), and of the next write beat
+  wire [AXI_AWIDTH-1:0] read_byte_addr  = read_request_addr_value + {(read_cnt_value - 1) << read_size};
+  wire [AXI_AWIDTH-1:0] write_byte_addr = write_request_addr_value + {write_cnt_value << write_size};
+
+  // ---------------------------------------------------------------------
+  // DDR timing (simulation only)
+  // ---------------------------------------------------------------------
+  localparam NUM_BANKS = 1 << BANK_WIDTH;
+  localparam ROW_SHIFT = COL_WIDTH + BANK_WIDTH;
+  localparam BW_MAX    = 2 * ((BW_BYTES > AXI_DWIDTH / 8) ? BW_BYTES : AXI_DWIDTH / 8);
+
+  reg [31:0] cycle;
+
+  // Open row of each bank
+  reg [AXI_AWIDTH-1:0] open_row [0:NUM_BANKS-1];
+  reg [NUM_BANKS-1:0]  row_open;
+
+  // Bandwidth credit, in bytes
+  integer bw_credit;
+
+  // Request cycle, end cycle of the recent bursts, and the cycle the
+  // current wait (MEM_DELAY) is over
+  reg [31:0] r_req_cycle, w_req_cycle;
+  reg [31:0] r_end [0:MAX_OUTSTANDING-1];
+  reg [31:0] w_end [0:MAX_OUTSTANDING-1];
+  reg [31:0] r_due, w_due;
+
+  wire refresh = (T_REFI != 0) && (cycle % T_REFI < T_RFC);
+
+  wire [BANK_WIDTH-1:0] r_bank = read_byte_addr[COL_WIDTH +: BANK_WIDTH];
+  wire [BANK_WIDTH-1:0] w_bank = write_byte_addr[COL_WIDTH +: BANK_WIDTH];
+  wire [AXI_AWIDTH-1:0] r_row  = read_byte_addr >> ROW_SHIFT;
+  wire [AXI_AWIDTH-1:0] w_row  = write_byte_addr >> ROW_SHIFT;
+
+  wire r_row_hit = row_open[r_bank] && (open_row[r_bank] == r_row);
+  wire w_row_hit = row_open[w_bank] && (open_row[w_bank] == w_row);
+
+  // The row was opened for this beat (the other side may have opened
+  // another row of the bank since; the beat still goes first)
+  reg r_opened, w_opened;
+
+  wire r_row_ok = r_row_hit | r_opened;
+  wire w_row_ok = w_row_hit | w_opened;
+
+  // Open the row of the beat before it can go
+  wire r_activate = r_run_dl & ~r_row_ok & ~refresh;
+  wire w_activate = w_run    & ~w_row_ok & ~refresh;
+
+  wire [31:0] r_act_cycles = row_open[r_bank] ? T_RP + T_RCD : T_RCD;
+  wire [31:0] w_act_cycles = row_open[w_bank] ? T_RP + T_RCD : T_RCD;
+
+  wire [31:0] r_beat_bytes = 1 << read_size;
+  wire [31:0] w_beat_bytes = 1 << write_size;
+
+  // Reads go first on the shared bandwidth
+  wire r_bw_ok = bw_credit >= r_beat_bytes;
+  wire w_bw_ok = bw_credit >= w_beat_bytes + (read_data_valid ? r_beat_bytes : 0);
+
+  wire [31:0] bw_credit_next = bw_credit - (read_data_fire  ? r_beat_bytes : 0)
+                                         - (write_data_fire ? w_beat_bytes : 0)
+                                         + ((cycle % BW_CYCLES == 0) ? BW_BYTES : 0);
+
+  // The next beat starts AXI burst r_burst / w_burst
+  wire [31:0] r_burst     = read_cnt_value / MAX_BURST_LEN;
+  wire [31:0] w_burst     = (write_cnt_value + 1) / MAX_BURST_LEN;
+  wire        r_new_burst = read_cnt_value % MAX_BURST_LEN == 0;
+  wire        w_new_burst = (write_cnt_value + 1) % MAX_BURST_LEN == 0;
+
+  // Burst k is sent once burst k - MAX_OUTSTANDING is done (the burst that
+  // just ended when MAX_OUTSTANDING = 1)
+  wire [31:0] r_prev_end = (MAX_OUTSTANDING == 1) ? cycle :
+                           r_end[(r_burst - MAX_OUTSTANDING) % MAX_OUTSTANDING];
+  wire [31:0] w_prev_end = (MAX_OUTSTANDING == 1) ? cycle :
+                           w_end[(w_burst - MAX_OUTSTANDING) % MAX_OUTSTANDING];
+
+  wire [31:0] r_burst_due = (r_burst < MAX_OUTSTANDING) ? r_req_cycle + DELAY : r_prev_end + DELAY;
+  wire [31:0] w_burst_due = (w_burst < MAX_OUTSTANDING) ? w_req_cycle : w_prev_end + DELAY;
+
   always @(*) begin
     state_r_next = state_r_value;
     case (state_r_value)
@@ -194,23 +288,25 @@ module mem_model #(
       end
 
       STATE_R_RUN: begin
-        // to set up read from synchronous memory
-        state_r_next = STATE_R_RUN_DELAY;
+        // to set up read from synchronous memory, then wait for the
+        // latency of the first burst
+        state_r_next = STATE_R_MEM_DELAY;
       end
 
       STATE_R_RUN_DELAY: begin
-        // If the burst count reaches the maximum burst len,
-        // the burst request is halt for several cycles
+        // The next beat waits if it starts a burst which is not there yet,
+        // or if its row has to be opened first
 
         if (read_cnt_value == read_len_value + 1 && read_data_fire)
           state_r_next = STATE_R_DONE;
-        else if (read_cnt_value % MAX_BURST_LEN == 0)
+        else if (read_data_fire && r_new_burst && r_burst_due > cycle + 1)
+          state_r_next = STATE_R_MEM_DELAY;
+        else if (r_activate)
           state_r_next = STATE_R_MEM_DELAY;
-
       end
 
       STATE_R_MEM_DELAY: begin
-        if (rdly_cnt_value == DELAY)
+        if (cycle >= r_due)
           state_r_next = STATE_R_RUN_DELAY;
       end
 
@@ -229,17 +325,18 @@ module mem_model #(
       end
 
       STATE_W_RUN: begin
-        // If the burst count reaches the maximum burst len,
-        // the burst request is halt for several cycles
+        // Same as read; the first bursts are taken right away (posted)
 
         if (write_cnt_value == write_len_value && write_data_fire)
           state_w_next = STATE_W_DONE;
-        else if (write_cnt_value % MAX_BURST_LEN == 0)
+        else if (write_data_fire && w_new_burst && w_burst_due > cycle + 1)
+          state_w_next = STATE_W_MEM_DELAY;
+        else if (w_activate)
           state_w_next = STATE_W_MEM_DELAY;
       end
 
       STATE_W_MEM_DELAY: begin
-        if (wdly_cnt_value == DELAY)
+        if (cycle >= w_due)
           state_w_next = STATE_W_RUN;
       end
 
@@ -249,6 +346,170 @@ module mem_model #(
     endcase
   end
 
+  // Statistics since the last reset_stats
+  reg [63:0] st_start, st_busy;
+  reg [63:0] st_rd_bytes, st_wr_bytes, st_rd_reqs, st_wr_reqs;
+  reg [63:0] st_rd_lat, st_wr_lat;
+  reg [63:0] st_act_idle, st_act_conflict, st_refresh;
+  reg r_first, w_first;
+
+  task reset_stats;
+    begin
+      st_start        = cycle;
+      st_busy         = 0;
+      st_rd_bytes     = 0;
+      st_wr_bytes     = 0;
+      st_rd_reqs      = 0;
+      st_wr_reqs      = 0;
+      st_rd_lat       = 0;
+      st_wr_lat       = 0;
+      st_act_idle     = 0;
+      st_act_conflict = 0;
+      st_refresh      = 0;
+    end
+  endtask
+
+  task report_stats;
+    real cycles, rd_lat, wr_lat, bw;
+    begin
+      cycles = cycle - st_start;
+      rd_lat = st_rd_reqs ? 1.0 * st_rd_lat / st_rd_reqs : 0.0;
+      wr_lat = st_wr_reqs ? 1.0 * st_wr_lat / st_wr_reqs : 0.0;
+      bw     = cycles > 0 ? (st_rd_bytes + st_wr_bytes) / cycles : 0.0;
+      $display("[mem_model] %0d cycles: read %0d bytes in %0d requests, wrote %0d bytes in %0d requests",
+               cycle - st_start, st_rd_bytes, st_rd_reqs, st_wr_bytes, st_wr_reqs);
+      $display("[mem_model] average latency to the first beat: read %0.1f cycles, write %0.1f cycles",
+               rd_lat, wr_lat);
+      $display("[mem_model] %0.2f bytes/cycle, %0.1f%% of the bandwidth cap, data busy %0.1f%% of the cycles",
+               bw, 100.0 * bw * BW_CYCLES / BW_BYTES, cycles > 0 ? 100.0 * st_busy / cycles : 0.0);
+      $display("[mem_model] row activations: %0d idle bank, %0d row conflict; %0d refreshes",
+               st_act_idle, st_act_conflict, st_refresh);
+    end
+  endtask
+
+  task load_hex;
+    input [1023:0] file;
+    begin
+      $readmemh(file, buffer.mem);
+    end
+  endtask
+
+  task dump_hex;
+    input [1023:0] file;
+    input integer first;
+    input integer last;
+    begin
+      $writememh(file, buffer.mem, first, last);
+    end
+  endtask
+
+  reg [1023:0] mem_hex_file;
+  initial begin
+    if ($value$plusargs("mem_hex=%s", mem_hex_file)) begin
+      #1;
+      load_hex(mem_hex_file);
+    end
+  end
+
+  always @(posedge clk) begin
+    if (rst) begin
+      cycle     <= 0;
+      row_open  <= 0;
+      bw_credit <= BW_MAX;
+      r_opened  <= 1'b0;
+      w_opened  <= 1'b0;
+      r_first    = 1'b0;
+      w_first    = 1'b0;
+      reset_stats;
+      st_start   = 0;
+    end
+    else begin
+      cycle <= cycle + 1;
+
+      if (read_request_fire) begin
+        r_req_cycle <= cycle;
+        r_due       <= cycle + DELAY;
+      end
+      if (write_request_fire)
+        w_req_cycle <= cycle;
+
+      // Bursts done, and the wait for the next one
+      if (read_data_fire && r_new_burst && r_burst > 0) begin
+        r_end[(r_burst - 1) % MAX_OUTSTANDING] <= cycle;
+        r_due <= r_burst_due;
+      end
+      if (write_data_fire && w_new_burst) begin
+        w_end[(w_burst - 1) % MAX_OUTSTANDING] <= cycle;
+        w_due <= w_burst_due;
+      end
+
+      if (read_data_fire)
+        r_opened <= 1'b0;
+      if (write_data_fire)
+        w_opened <= 1'b0;
+
+      if (refresh) begin
+        row_open <= 0;
+        r_opened <= 1'b0;
+        w_opened <= 1'b0;
+      end
+      else begin
+        if (r_activate) begin
+          open_row[r_bank] <= r_row;
+          row_open[r_bank] <= 1'b1;
+          r_due            <= cycle + r_act_cycles;
+          r_opened         <= 1'b1;
+        end
+        if (w_activate) begin
+          open_row[w_bank] <= w_row;
+          row_open[w_bank] <= 1'b1;
+          w_due            <= cycle + w_act_cycles;
+          w_opened         <= 1'b1;
+        end
+      end
+
+      bw_credit <= (bw_credit_next > BW_MAX) ? BW_MAX : bw_credit_next;
+
+      // Statistics
+      if (read_request_fire) begin
+        st_rd_reqs = st_rd_reqs + 1;
+        r_first    = 1'b1;
+      end
+      if (write_request_fire) begin
+        st_wr_reqs = st_wr_reqs + 1;
+        w_first    = 1'b1;
+      end
+      if (read_data_fire) begin
+        st_rd_bytes = st_rd_bytes + r_beat_bytes;
+        if (r_first)
+          st_rd_lat = st_rd_lat + cycle - r_req_cycle;
+        r_first = 1'b0;
+      end
+      if (write_data_fire) begin
+        st_wr_bytes = st_wr_bytes + w_beat_bytes;
+        if (w_first)
+          st_wr_lat = st_wr_lat + cycle - w_req_cycle;
+        w_first = 1'b0;
+      end
+      if (read_data_fire | write_data_fire)
+        st_busy = st_busy + 1;
+      if (r_activate) begin
+        if (row_open[r_bank])
+          st_act_conflict = st_act_conflict + 1;
+        else
+          st_act_idle = st_act_idle + 1;
+      end
+      if (w_activate) begin
+        if (row_open[w_bank])
+          st_act_conflict = st_act_conflict + 1;
+        else
+          st_act_idle = st_act_idle + 1;
+      end
+      if (T_REFI != 0 && cycle % T_REFI == 0)
+        st_refresh = st_refresh + 1;
+    end
+  end
+
   assign read_request_ready  = r_idle;
   assign write_request_ready = w_idle;
 
@@ -262,33 +523,31 @@ module mem_model #(
   assign write_cnt_ce   = w_run & write_data_fire;
   assign write_cnt_rst  = w_idle;
 
-  // Delay count on read
-  assign rdly_cnt_next = rdly_cnt_value + 1;
-  assign rdly_cnt_ce   = r_delay;
-  assign rdly_cnt_rst  = r_run | rst;
-
-  // Delay count on write
-  assign wdly_cnt_next = wdly_cnt_value + 1;
-  assign wdly_cnt_ce   = w_delay;
-  assign wdly_cnt_rst  = w_run | rst;
-
   // Set up memory buffer read
   // The core (client) submits byte address, so need to convert to word address
-  // for the buffer
-  assign mem_addr0 = (read_request_addr_value + {read_cnt_value << read_size}) >> 2;
+  // for the buffer. A narrow beat reads the whole entry (its bytes are on
+  // the lanes of its address)
+  assign mem_addr0 = (read_request_addr_value + {read_cnt_value << read_size}) >> FULL_SIZE;
   assign mem_en0   = r_run | read_data_fire;
 
   // Set up memory buffer write
   // The core (client) submits byte address, so need to convert to word address
   // for the buffer
-  assign mem_addr1 = (write_request_addr_value + {write_cnt_value << write_size}) >> 2;
+
+  // A narrow beat (write_size < FULL_SIZE) only writes the 2^size bytes at
+  // its address, like the AXI write strobes
+  wire [AXI_DWIDTH/8-1:0] write_strobe = (write_size >= FULL_SIZE) ? {AXI_DWIDTH/8{1'b1}} :
+                                         ((1 << (1 << write_size)) - 1) << write_byte_addr[FULL_SIZE-1:0];
+
+  assign mem_addr1 = write_byte_addr >> FULL_SIZE;
   assign mem_din1  = write_data;
-  assign mem_we1   = write_data_fire;
+  assign mem_wbe1  = write_data_fire ? write_strobe : {AXI_DWIDTH/8{1'b0}};
   assign mem_en1   = w_run;
 
-  // Handshake on data channel
+  // Handshake on data channel: one beat per cycle, while its row is open,
+  // the DRAM is not refreshing and there is bandwidth left
   assign read_data        = mem_dout0;
-  assign read_data_valid  = r_run_dl;
-  assign write_data_ready = w_run;
+  assign read_data_valid  = r_run_dl & r_row_ok & ~refresh & r_bw_ok;
+  assign write_data_ready = w_run & w_row_ok & ~refresh & w_bw_ok;
 
 endmodule
@@ -0,0 +1,51 @@
+`timescale 1ns / 1ns
+
+module mul_int8x2_testbench;
+
+  reg  [7:0]  ifm, wt0, wt1;
+  wire [15:0] prod0, prod1;
+
+  mul_int8x2 uut (
+    .ifm(ifm),
+    .wt0(wt0),
+    .wt1(wt1),
+    .prod0(prod0),
+    .prod1(prod1)
+  );
+
+  integer a, b, c;
+  integer num_mismatches = 0;
+
+  reg [15:0] expected0, expected1;
+
+  // Exhaustive check against two independent int8 multiplies
+  initial begin
+    for (a = -128; a < 128; a = a + 1) begin
+      for (b = -128; b < 128; b = b + 1) begin
+        for (c = -128; c < 128; c = c + 1) begin
+          ifm = a;
+          wt0 = b;
+          wt1 = c;
+          expected0 = a * b;
+          expected1 = a * c;
+          #1;
+          if (prod0 !== expected0 || prod1 !== expected1) begin
+            num_mismatches = num_mismatches + 1;
+            if (num_mismatches < 10)
+              $display("Mismatch: ifm=%d wt0=%d wt1=%d, expected %d %d, got %d %d",
+                       a, b, c, $signed(expected0), $signed(expected1),
+                       $signed(prod0), $signed(prod1));
+          end
+        end
+      end
+    end
+
+    if (num_mismatches == 0)
+      $display("Test passed!");
+    else
+      $display("Test failed! Num. mismatches: %d", num_mismatches);
+
+    $finish();
+  end
+
+endmodule
@@ -25,7 +25,8 @@ module software_testbench();
     .rst(rst),
     .FPGA_SERIAL_RX(), // input
     .FPGA_SERIAL_TX(), // output
-    .csr(csr)
+    .csr(csr),
+    .dma_imem_wbe(4'd0) // no DMA writes to IMem
   );
 
   reg [31:0] cycle;
@@ -0,0 +1,396 @@
+`timescale 1ns/1ns
+
+// xcel_naive behind xcel_cdc, with the memory model on the system clock.
+// Override the layer shape and XCEL_CLOCK_PERIOD to compare the conv1/conv2
+// runtimes with the accelerator at 1x (20) and 2x (10) the system clock
+module xcel_cdc_testbench();
+  reg sys_clk, xcel_clk, rst;
+  parameter CPU_CLOCK_PERIOD  = 20;
+  parameter XCEL_CLOCK_PERIOD = 10;
+
+  initial sys_clk = 0;
+  always #(CPU_CLOCK_PERIOD/2) sys_clk = ~sys_clk;
+
+  initial xcel_clk = 0;
+  always #(XCEL_CLOCK_PERIOD/2) xcel_clk = ~xcel_clk;
+
+  localparam TIMEOUT_CYCLE = 10_000_000;
+
+  // LeNet conv2 by default; conv1 is IFM_DIM = 28, IFM_DEPTH = 1, OFM_DEPTH = 8
+  parameter IFM_DIM    = 12;
+  parameter IFM_DEPTH  = 8;
+  parameter OFM_DEPTH  = 16;
+  localparam WT_DIM    = 5;
+  localparam OFM_DIM   = IFM_DIM - WT_DIM + 1;
+
+  localparam IFM_LEN = IFM_DEPTH * IFM_DIM * IFM_DIM;
+  localparam WT_LEN  = OFM_DEPTH * IFM_DEPTH * WT_DIM * WT_DIM;
+  localparam OFM_LEN = OFM_DEPTH * OFM_DIM * OFM_DIM;
+
+  localparam AXI_AWIDTH  = 32;
+  localparam AXI_DWIDTH  = 32;
+  localparam DMEM_AWIDTH = 14;
+  localparam DMEM_DWIDTH = 32;
+
+  // System side
+  wire xcel_read_request_valid;
+  wire xcel_read_request_ready;
+  wire [AXI_AWIDTH-1:0] xcel_read_addr;
+  wire [31:0] xcel_read_len;
+  wire [2:0] xcel_read_size;
+  wire [1:0] xcel_read_burst;
+  wire [AXI_DWIDTH-1:0] xcel_read_data;
+  wire xcel_read_data_valid;
+  wire xcel_read_data_ready;
+
+  wire xcel_write_request_valid;
+  wire xcel_write_request_ready;
+  wire [AXI_AWIDTH-1:0] xcel_write_addr;
+  wire [31:0] xcel_write_len;
+  wire [2:0] xcel_write_size;
+  wire [1:0] xcel_write_burst;
+  wire [AXI_DWIDTH-1:0] xcel_write_data;
+  wire xcel_write_data_valid;
+  wire xcel_write_data_ready;
+
+  reg  xcel_start;
+  wire xcel_idle;
+  wire xcel_done;
+
+  wire [31:0] wt_ddr_addr  = 0;
+  wire [31:0] ifm_ddr_addr = ((WT_LEN+3)/4) << 2;
+  wire [31:0] ofm_ddr_addr = ((WT_LEN+3)/4 + (IFM_LEN+3)/4) << 2;
+
+  wire [31:0] ifm_dim   = IFM_DIM;
+  wire [31:0] ifm_depth = IFM_DEPTH;
+  wire [31:0] ofm_dim   = OFM_DIM;
+  wire [31:0] ofm_depth = OFM_DEPTH;
+
+  // Accelerator side
+  wire acc_read_request_valid;
+  wire acc_read_request_ready;
+  wire [AXI_AWIDTH-1:0] acc_read_addr;
+  wire [31:0] acc_read_len;
+  wire [2:0] acc_read_size;
+  wire [1:0] acc_read_burst;
+  wire [AXI_DWIDTH-1:0] acc_read_data;
+  wire acc_read_data_valid;
+  wire acc_read_data_ready;
+
+  wire acc_write_request_valid;
+  wire acc_write_request_ready;
+  wire [AXI_AWIDTH-1:0] acc_write_addr;
+  wire [31:0] acc_write_len;
+  wire [2:0] acc_write_size;
+  wire [1:0] acc_write_burst;
+  wire [AXI_DWIDTH-1:0] acc_write_data;
+  wire acc_write_data_valid;
+  wire acc_write_data_ready;
+
+  wire acc_dmem_request_valid;
+  wire acc_dmem_request_ready;
+  wire [DMEM_AWIDTH-1:0] acc_dmem_addr;
+  wire [DMEM_DWIDTH-1:0] acc_dmem_din, acc_dmem_dout;
+  wire [3:0] acc_dmem_wbe;
+  wire acc_dmem_dout_valid;
+
+  wire acc_start, acc_done, acc_idle;
+  wire [31:0] acc_progress;
+
+  wire [31:0] acc_ifm_ddr_addr, acc_wt_ddr_addr, acc_ofm_ddr_addr;
+  wire [31:0] acc_ifm_dim, acc_ifm_depth;
+  wire [31:0] acc_ofm_dim, acc_ofm_depth;
+
+  xcel_naive #(
+    .AXI_AWIDTH(AXI_AWIDTH),
+    .AXI_DWIDTH(AXI_DWIDTH),
+    .WT_DIM(WT_DIM)
+  ) dut (
+    .clk(xcel_clk),
+    .rst(rst),
+
+    .xcel_read_request_valid(acc_read_request_valid),   // output
+    .xcel_read_request_ready(acc_read_request_ready),   // input
+    .xcel_read_addr(acc_read_addr),                     // output
+    .xcel_read_len(acc_read_len),                       // output
+    .xcel_read_size(acc_read_size),                     // output
+    .xcel_read_burst(acc_read_burst),                   // output
+    .xcel_read_data(acc_read_data),                     // input
+    .xcel_read_data_valid(acc_read_data_valid),         // input
+    .xcel_read_data_ready(acc_read_data_ready),         // output
+
+    .xcel_write_request_valid(acc_write_request_valid), // output
+    .xcel_write_request_ready(acc_write_request_ready), // input
+    .xcel_write_addr(acc_write_addr),                   // output
+    .xcel_write_len(acc_write_len),                     // output
+    .xcel_write_size(acc_write_size),                   // output
+    .xcel_write_burst(acc_write_burst),                 // output
+    .xcel_write_data(acc_write_data),                   // output
+    .xcel_write_data_valid(acc_write_data_valid),       // output
+    .xcel_write_data_ready(acc_write_data_ready),       // input
+
+    .xcel_dmem_request_valid(acc_dmem_request_valid),   // output
+    .xcel_dmem_request_ready(acc_dmem_request_ready),   // input
+    .xcel_dmem_addr(acc_dmem_addr),                     // output
+    .xcel_dmem_din(acc_dmem_din),                       // output
+    .xcel_dmem_wbe(acc_dmem_wbe),                       // output
+    .xcel_dmem_dout(acc_dmem_dout),                     // input
+    .xcel_dmem_dout_valid(acc_dmem_dout_valid),         // input
+
+    .xcel_start(acc_start),       // input
+    .xcel_done(acc_done),         // output
+    .xcel_idle(acc_idle),         // output
+    .xcel_progress(acc_progress), // output
+
+    .ifm_ddr_addr(acc_ifm_ddr_addr), // input
+    .wt_ddr_addr(acc_wt_ddr_addr),   // input
+    .ofm_ddr_addr(acc_ofm_ddr_addr), // input
+
+    .ifm_dim(acc_ifm_dim),     // input
+    .ifm_depth(acc_ifm_depth), // input
+    .ofm_dim(acc_ofm_dim),     // input
+    .ofm_depth(acc_ofm_depth)  // input
+  );
+
+  xcel_cdc #(
+    .AXI_AWIDTH(AXI_AWIDTH),
+    .AXI_DWIDTH(AXI_DWIDTH),
+    .DMEM_AWIDTH(DMEM_AWIDTH),
+    .DMEM_DWIDTH(DMEM_DWIDTH)
+  ) cdc (
+    .sys_clk(sys_clk),
+    .sys_rst(rst),
+    .xcel_clk(xcel_clk),
+    .xcel_rst(rst),
+
+    .sys_xcel_start(xcel_start),
+    .sys_xcel_done(xcel_done),
+    .sys_xcel_idle(xcel_idle),
+    .sys_xcel_progress(),
+
+    .sys_ifm_ddr_addr(ifm_ddr_addr),
+    .sys_wt_ddr_addr(wt_ddr_addr),
+    .sys_ofm_ddr_addr(ofm_ddr_addr),
+    .sys_ifm_dim(ifm_dim),
+    .sys_ifm_depth(ifm_depth),
+    .sys_ofm_dim(ofm_dim),
+    .sys_ofm_depth(ofm_depth),
+
+    .sys_read_request_valid(xcel_read_request_valid),
+    .sys_read_request_ready(xcel_read_request_ready),
+    .sys_read_addr(xcel_read_addr),
+    .sys_read_len(xcel_read_len),
+    .sys_read_size(xcel_read_size),
+    .sys_read_burst(xcel_read_burst),
+    .sys_read_data(xcel_read_data),
+    .sys_read_data_valid(xcel_read_data_valid),
+    .sys_read_data_ready(xcel_read_data_ready),
+
+    .sys_write_request_valid(xcel_write_request_valid),
+    .sys_write_request_ready(xcel_write_request_ready),
+    .sys_write_addr(xcel_write_addr),
+    .sys_write_len(xcel_write_len),
+    .sys_write_size(xcel_write_size),
+    .sys_write_burst(xcel_write_burst),
+    .sys_write_data(xcel_write_data),
+    .sys_write_data_valid(xcel_write_data_valid),
+    .sys_write_data_ready(xcel_write_data_ready),
+    .sys_write_idle(1'b1), // mem_model stores a write at once
+
+    // All operands live in DDR here, so the DMem port is unused
+    .sys_dmem_request_valid(),
+    .sys_dmem_request_ready(1'b0),
+    .sys_dmem_addr(),
+    .sys_dmem_din(),
+    .sys_dmem_wbe(),
+    .sys_dmem_dout(32'd0),
+    .sys_dmem_dout_valid(1'b0),
+
+    .xcel_start(acc_start),
+    .xcel_done(acc_done),
+    .xcel_idle(acc_idle),
+    .xcel_progress(acc_progress),
+
+    .xcel_ifm_ddr_addr(acc_ifm_ddr_addr),
+    .xcel_wt_ddr_addr(acc_wt_ddr_addr),
+    .xcel_ofm_ddr_addr(acc_ofm_ddr_addr),
+    .xcel_ifm_dim(acc_ifm_dim),
+    .xcel_ifm_depth(acc_ifm_depth),
+    .xcel_ofm_dim(acc_ofm_dim),
+    .xcel_ofm_depth(acc_ofm_depth),
+
+    .xcel_read_request_valid(acc_read_request_valid),
+    .xcel_read_request_ready(acc_read_request_ready),
+    .xcel_read_addr(acc_read_addr),
+    .xcel_read_len(acc_read_len),
+    .xcel_read_size(acc_read_size),
+    .xcel_read_burst(acc_read_burst),
+    .xcel_read_data(acc_read_data),
+    .xcel_read_data_valid(acc_read_data_valid),
+    .xcel_read_data_ready(acc_read_data_ready),
+
+    .xcel_write_request_valid(acc_write_request_valid),
+    .xcel_write_request_ready(acc_write_request_ready),
+    .xcel_write_addr(acc_write_addr),
+    .xcel_write_len(acc_write_len),
+    .xcel_write_size(acc_write_size),
+    .xcel_write_burst(acc_write_burst),
+    .xcel_write_data(acc_write_data),
+    .xcel_write_data_valid(acc_write_data_valid),
+    .xcel_write_data_ready(acc_write_data_ready),
+
+    .xcel_dmem_request_valid(acc_dmem_request_valid),
+    .xcel_dmem_request_ready(acc_dmem_request_ready),
+    .xcel_dmem_addr(acc_dmem_addr),
+    .xcel_dmem_din(acc_dmem_din),
+    .xcel_dmem_wbe(acc_dmem_wbe),
+    .xcel_dmem_dout(acc_dmem_dout),
+    .xcel_dmem_dout_valid(acc_dmem_dout_valid)
+  );
+
+  localparam MEM_AWIDTH = 14;
+
+  mem_model #(
+    .AXI_AWIDTH(AXI_AWIDTH),
+    .AXI_DWIDTH(AXI_DWIDTH),
+    .MEM_AWIDTH(MEM_AWIDTH)
+  ) mm_unit (
+    .clk(sys_clk),
+    .rst(rst),
+
+    .read_request_valid(xcel_read_request_valid),   // input
+    .read_request_ready(xcel_read_request_ready),   // output
+    .read_request_addr(xcel_read_addr),             // input
+    .read_len(xcel_read_len),                       // input
+    .read_size(xcel_read_size),                     // input
+    .read_data(xcel_read_data),                     // output
+    .read_data_valid(xcel_read_data_valid),         // output
+    .read_data_ready(xcel_read_data_ready),         // input
+
+    .write_request_valid(xcel_write_request_valid), // input
+    .write_request_ready(xcel_write_request_ready), // output
+    .write_request_addr(xcel_write_addr),           // input
+    .write_len(xcel_write_len),                     // input
+    .write_size(xcel_write_size),                   // input
+    .write_data(xcel_write_data),                   // output
+    .write_data_valid(xcel_write_data_valid),       // output
+    .write_data_ready(xcel_write_data_ready)        // input
+  );
+
+  // See: sim/conv3D_sw.v
+  conv3D_sw #(
+    .IFM_DIM(IFM_DIM),
+    .IFM_DEPTH(IFM_DEPTH),
+    .OFM_DIM(OFM_DIM),
+    .OFM_DEPTH(OFM_DEPTH),
+    .WT_DIM(WT_DIM)
+  ) sw();
+
+  integer i;
+  task init_data;
+    begin
+      for (i = 0; i < WT_LEN+3; i = i + 4) begin
+        mm_unit.buffer.mem[i/4] = {sw.wt_data[i + 3][7:0],
+                                   sw.wt_data[i + 2][7:0],
+                                   sw.wt_data[i + 1][7:0],
+                                   sw.wt_data[i + 0][7:0]};
+      end
+
+      for (i = 0; i < IFM_LEN+3; i = i + 4) begin
+        mm_unit.buffer.mem[(WT_LEN+3)/4 + i/4] = {sw.ifm_data[i + 3][7:0],
+                                                  sw.ifm_data[i + 2][7:0],
+                                                  sw.ifm_data[i + 1][7:0],
+                                                  sw.ifm_data[i + 0][7:0]};
+      end
+
+      for (i = 0; i < OFM_LEN; i = i + 1) begin
+        mm_unit.buffer.mem[(WT_LEN+3)/4 + (IFM_LEN+3)/4 + i] = $random;
+      end
+    end
+  endtask
+
+  integer num_mismatches = 0;
+
+  task check_result;
+    begin
+      for (i = 0; i < OFM_LEN; i = i + 1) begin
+        if (mm_unit.buffer.mem[(WT_LEN+3)/4 + (IFM_LEN+3)/4 + i] !== sw.ofm_sw_data[i]) begin
+          num_mismatches = num_mismatches + 1;
+          $display("Mismatch at %d: expected %d, got %d",
+                   i, sw.ofm_sw_data[i], mm_unit.buffer.mem[(WT_LEN+3)/4 + (IFM_LEN+3)/4 + i]);
+        end
+      end
+      if (num_mismatches == 0)
+        $display("Test passed!");
+      else
+        $display("Test failed! Num. mismatches: %d", num_mismatches);
+    end
+  endtask
+
+  // Runtime in system clock cycles, from start until done is seen
+  reg [31:0] sim_cycle;
+  reg xcel_running;
+
+  always @(posedge sys_clk) begin
+    if (rst === 1'b1) begin
+      xcel_running <= 1'b0;
+      sim_cycle <= 1'b0;
+    end
+    else begin
+      if (xcel_start === 1'b1) begin
+        xcel_running <= 1'b1;
+        sim_cycle <= 0;
+      end
+      else if (xcel_done === 1'b1)
+        xcel_running <= 1'b0;
+      else if (xcel_running === 1'b1)
+        sim_cycle <= sim_cycle + 1;
+    end
+  end
+
+  integer k;
+
+  initial begin
+    //$dumpfile("xcel_cdc_testbench.vcd");
+    //$dumpvars;
+
+    #0;
+    rst = 1'b1;
+    xcel_start = 1'b0;
+    init_data();
+
+    repeat (10) @(posedge sys_clk);
+
+    @(negedge sys_clk);
+    rst = 1'b0;
+
+    // Run twice to make sure the status seen after a restart is fresh
+    for (k = 0; k < 2; k = k + 1) begin
+      wait (xcel_idle === 1'b1);
+
+      @(negedge sys_clk);
+      xcel_start = 1'b1;
+      $display("Start! (IFM %0dx%0dx%0d, OFM depth %0d, xcel clock %0d ns, system clock %0d ns)",
+               IFM_DIM, IFM_DIM, IFM_DEPTH, OFM_DEPTH, XCEL_CLOCK_PERIOD, CPU_CLOCK_PERIOD);
+
+      @(negedge sys_clk);
+      xcel_start = 1'b0;
+
+      wait (xcel_done === 1'b1);
+      @(posedge sys_clk); #1;
+
+      check_result();
+
+      $display("Done in %d system clock cycles!", sim_cycle);
+    end
+
+    $finish();
+  end
+
+  initial begin
+    repeat (TIMEOUT_CYCLE) @(posedge sys_clk);
+    $display("Timeout!");
+    $finish();
+  end
+
+endmodule
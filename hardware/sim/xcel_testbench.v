@@ -16,14 +16,21 @@ module xcel_testbench();
   localparam IFM_DEPTH  = 2;
   localparam WT_DIM     = 5;
   localparam OFM_DIM    = IFM_DIM - WT_DIM + 1;
-  localparam OFM_DEPTH  = 2;
+  // Odd, so that both a packed pair and the single-channel tail are tested
+  localparam OFM_DEPTH  = 3;
+  // Set to test the packed int4 weight format
+  parameter  WT_INT4    = 0;
 
   localparam IFM_LEN = IFM_DEPTH * IFM_DIM * IFM_DIM;
   localparam WT_LEN  = OFM_DEPTH * IFM_DEPTH * WT_DIM * WT_DIM;
   localparam OFM_LEN = OFM_DEPTH * OFM_DIM * OFM_DIM;
 
+  // Size of the weights in DDR (in bytes)
+  localparam WT_BYTES = WT_INT4 ? (WT_LEN + 1) / 2 : WT_LEN;
+
   localparam AXI_AWIDTH = 32;
-  localparam AXI_DWIDTH = 32;
+  // DDR data path width: 32, 64 or 128
+  parameter  AXI_DWIDTH = 32;
 
   wire xcel_read_request_valid;
   wire xcel_read_request_ready;
@@ -49,9 +56,10 @@ module xcel_testbench();
   wire xcel_idle;
   wire xcel_done;
 
-  wire [31:0] wt_ddr_addr  = 0;
-  wire [31:0] ifm_ddr_addr = ((WT_LEN+3)/4) << 2;
-  wire [31:0] ofm_ddr_addr = ((WT_LEN+3)/4 + (IFM_LEN+3)/4) << 2;
+  // Bit 30 of the WT address selects the packed int4 format
+  wire [31:0] wt_ddr_addr  = WT_INT4 ? 32'h4000_0000 : 0;
+  wire [31:0] ifm_ddr_addr = ((WT_BYTES+3)/4) << 2;
+  wire [31:0] ofm_ddr_addr = ((WT_BYTES+3)/4 + (IFM_LEN+3)/4) << 2;
 
   wire [31:0] ifm_dim   = IFM_DIM;
   wire [31:0] ifm_depth = IFM_DEPTH;
@@ -86,6 +94,11 @@ module xcel_testbench();
     .xcel_write_data_valid(xcel_write_data_valid),       // output
     .xcel_write_data_ready(xcel_write_data_ready),       // input
 
+    // All operands live in DDR here, so the DMem port is unused
+    .xcel_dmem_request_ready(1'b0), // input
+    .xcel_dmem_dout(32'd0),         // input
+    .xcel_dmem_dout_valid(1'b0),    // input
+
     .xcel_start(xcel_start), // input
     .xcel_done(xcel_done),   // output
     .xcel_idle(xcel_idle),   // output
@@ -135,28 +148,59 @@ module xcel_testbench();
     .IFM_DEPTH(IFM_DEPTH),
     .OFM_DIM(OFM_DIM),
     .OFM_DEPTH(OFM_DEPTH),
-    .WT_DIM(WT_DIM)
+    .WT_DIM(WT_DIM),
+    .WT_INT4(WT_INT4)
   ) sw();
 
+  // The memory model holds one AXI_DWIDTH beat per entry; these access it
+  // one 32-bit word (word address w) at a time
+  localparam MEM_RATIO = AXI_DWIDTH / 32;
+
+  task mem_write_word;
+    input integer w;
+    input [31:0] data;
+    begin
+      mm_unit.buffer.mem[w / MEM_RATIO][(w % MEM_RATIO) * 32 +: 32] = data;
+    end
+  endtask
+
+  function [31:0] mem_read_word;
+    input integer w;
+    begin
+      mem_read_word = mm_unit.buffer.mem[w / MEM_RATIO][(w % MEM_RATIO) * 32 +: 32];
+    end
+  endfunction
+
   integer i;
   task init_data;
     begin
-      for (i = 0; i < WT_LEN+3; i = i + 4) begin
-        mm_unit.buffer.mem[i/4] = {sw.wt_data[i + 3][7:0],
-                                   sw.wt_data[i + 2][7:0],
-                                   sw.wt_data[i + 1][7:0],
-                                   sw.wt_data[i + 0][7:0]};
+      if (WT_INT4) begin
+        // Two weights per byte, low nibble first
+        for (i = 0; i < WT_LEN+7; i = i + 8) begin
+          mem_write_word(i/8, {sw.wt_data[i + 7][3:0], sw.wt_data[i + 6][3:0],
+                               sw.wt_data[i + 5][3:0], sw.wt_data[i + 4][3:0],
+                               sw.wt_data[i + 3][3:0], sw.wt_data[i + 2][3:0],
+                               sw.wt_data[i + 1][3:0], sw.wt_data[i + 0][3:0]});
+        end
+      end
+      else begin
+        for (i = 0; i < WT_LEN+3; i = i + 4) begin
+          mem_write_word(i/4, {sw.wt_data[i + 3][7:0],
+                               sw.wt_data[i + 2][7:0],
+                               sw.wt_data[i + 1][7:0],
+                               sw.wt_data[i + 0][7:0]});
+        end
       end
 
       for (i = 0; i < IFM_LEN+3; i = i + 4) begin
-        mm_unit.buffer.mem[(WT_LEN+3)/4 + i/4] = {sw.ifm_data[i + 3][7:0],
-                                                  sw.ifm_data[i + 2][7:0],
-                                                  sw.ifm_data[i + 1][7:0],
-                                                  sw.ifm_data[i + 0][7:0]};
+        mem_write_word((WT_BYTES+3)/4 + i/4, {sw.ifm_data[i + 3][7:0],
+                                              sw.ifm_data[i + 2][7:0],
+                                              sw.ifm_data[i + 1][7:0],
+                                              sw.ifm_data[i + 0][7:0]});
       end
 
       for (i = 0; i < OFM_LEN; i = i + 1) begin
-        mm_unit.buffer.mem[(WT_LEN+3)/4 + (IFM_LEN+3)/4 + i] = $random;
+        mem_write_word((WT_BYTES+3)/4 + (IFM_LEN+3)/4 + i, $random);
       end
     end
   endtask
@@ -166,10 +210,10 @@ module xcel_testbench();
   task check_result;
     begin
       for (i = 0; i < OFM_LEN; i = i + 1) begin
-        if (mm_unit.buffer.mem[(WT_LEN+3)/4 + (IFM_LEN+3)/4 + i] !== sw.ofm_sw_data[i]) begin
+        if (mem_read_word((WT_BYTES+3)/4 + (IFM_LEN+3)/4 + i) !== sw.ofm_sw_data[i]) begin
           num_mismatches = num_mismatches + 1;
           $display("Mismatch at %d: expected %d, got %d",
-                   i, sw.ofm_sw_data[i], mm_unit.buffer.mem[(WT_LEN+3)/4 + (IFM_LEN+3)/4 + i]);
+                   i, sw.ofm_sw_data[i], mem_read_word((WT_BYTES+3)/4 + (IFM_LEN+3)/4 + i));
         end
       end
       if (num_mismatches == 0)
@@ -215,6 +259,7 @@ module xcel_testbench();
     for (k = 0; k < 2; k = k + 1) begin
       @(negedge clk);
       xcel_start = 1'b1;
+      mm_unit.reset_stats;
       $display("Start!");
 
       @(negedge clk);
@@ -225,7 +270,8 @@ module xcel_testbench();
 
       check_result();
 
-      $display("Done in %d simulation cycles!", sim_cycle);
+      $display("Done in %d simulation cycles! (%0d-bit DDR data path)", sim_cycle, AXI_DWIDTH);
+      mm_unit.report_stats;
     end
 
     $finish();
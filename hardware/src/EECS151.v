@@ -471,7 +471,7 @@ module SYNC_RAM_DP_WBE(q0, d0, addr0, en0, wbe0, q1, d1, addr1, en1, wbe1, clk);
 
   always @(posedge clk) begin
     if (en0) begin
-      for (i = 0; i < 4; i = i+1) begin
+      for (i = 0; i < DWIDTH/8; i = i+1) begin
         if (wbe0[i])
           mem[addr0][i*8 +: 8] <= d0[i*8 +: 8];
       end
@@ -481,7 +481,7 @@ module SYNC_RAM_DP_WBE(q0, d0, addr0, en0, wbe0, q1, d1, addr1, en1, wbe1, clk);
 
   always @(posedge clk) begin
     if (en1) begin
-      for (i = 0; i < 4; i = i+1) begin
+      for (i = 0; i < DWIDTH/8; i = i+1) begin
         if (wbe1[i])
           mem[addr1][i*8 +: 8] <= d1[i*8 +: 8];
         end
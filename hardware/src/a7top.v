@@ -58,7 +58,25 @@ module a7top (
     .rst(reset),
     .FPGA_SERIAL_TX(FPGA_SERIAL_TX),
     .FPGA_SERIAL_RX(FPGA_SERIAL_RX),
-    .csr(csr)
+    .csr(csr),
+
+    // No DMA or accelerator in this top-level
+    .xcel_done(1'b0),
+    .xcel_idle(1'b1),
+    .xcel_progress(32'd0),
+    .dma_done(1'b0),
+    .dma_idle(1'b1),
+    .dma_desc_count(32'd0),
+    .dma_sum(32'd0),
+    .dma_crc(32'd0),
+    .axi_mon_value(32'd0),
+    .dmem_addrb(14'd0),
+    .dmem_dinb(32'd0),
+    .dmem_web(4'd0),
+    .dmem_enb(1'b0),
+    .dma_imem_addr(14'd0),
+    .dma_imem_din(32'd0),
+    .dma_imem_wbe(4'd0)
   );
 
   assign LEDS[3:0] = csr[3:0];
@@ -1,12 +1,12 @@
 
 module arbiter #(
   parameter AXI_AWIDTH = 32,
-  parameter AXI_DWIDTH = 32
+  parameter AXI_DWIDTH = 32,
+  // transactions (per channel) granted ahead of their data
+  parameter OWNER_LOGDEPTH = 2
 ) (
-
-  // if xcel_busy is HIGH, xcel will communicate with the AXI adapter,
-  // otherwise dma
-  input xcel_busy,
+  input clk,
+  input rst,
 
   // Core (client) interface
   output                  core_read_request_valid,
@@ -28,6 +28,7 @@ module arbiter #(
   output [AXI_DWIDTH-1:0] core_write_data,
   output                  core_write_data_valid,
   input                   core_write_data_ready,
+  input                   core_write_idle,
 
   // DMA Controller interface
   input                    dma_read_request_valid,
@@ -49,6 +50,7 @@ module arbiter #(
   input [AXI_DWIDTH-1:0]   dma_write_data,
   input                    dma_write_data_valid,
   output                   dma_write_data_ready,
+  output                   dma_write_idle,
 
   // Accelerator interface
   input                    xcel_read_request_valid,
@@ -69,53 +71,209 @@ module arbiter #(
   input [1:0]              xcel_write_burst,
   input [AXI_DWIDTH-1:0]   xcel_write_data,
   input                    xcel_write_data_valid,
-  output                   xcel_write_data_ready
+  output                   xcel_write_data_ready,
+  output                   xcel_write_idle
 );
 
-  assign core_read_request_valid = xcel_busy ? xcel_read_request_valid :
-                                               dma_read_request_valid;
-  assign dma_read_request_ready  = core_read_request_ready;
-  assign xcel_read_request_ready = core_read_request_ready;
+  localparam OWNER_DMA  = 1'b0;
+  localparam OWNER_XCEL = 1'b1;
+
+  // Each channel (read, write) is granted one transaction (request) at a
+  // time, round-robin between the clients with a pending request, so
+  // neither client can starve the other: the DMA can stream images in (or
+  // OFM rows out) while the accelerator is running. The read and write
+  // channels are arbitrated independently.
+  // A grant does not wait for the data of the previous transaction: the
+  // owner and length of each granted transaction go into a FIFO (up to
+  // 2^OWNER_LOGDEPTH of them), and the data beats are routed to (read) or
+  // taken from (write) the owner at the head of the FIFO. The AXI adapter
+  // keeps the transactions in order, so the beats come back in the same
+  // order.
+  // Client i is bit i of the rr_arbiter request/grant vectors; more clients
+  // only need a wider owner and another bit in req
+  wire core_read_request_fire  = core_read_request_valid  & core_read_request_ready;
+  wire core_read_data_fire     = core_read_data_valid     & core_read_data_ready;
+  wire core_write_request_fire = core_write_request_valid & core_write_request_ready;
+  wire core_write_data_fire    = core_write_data_valid    & core_write_data_ready;
+
+  // Read channel
+  wire rd_owner_enq_ready;
+  wire rd_owner_valid;
+  wire rd_owner;
+  wire [31:0] rd_len;
+  wire rd_last_beat;
+
+  wire [1:0] rd_grant;
+  rr_arbiter #(.NUM_REQ(2)) rd_rr (
+    .clk(clk),
+    .rst(rst),
+    .req({xcel_read_request_valid, dma_read_request_valid} & {2{rd_owner_enq_ready}}),
+    .advance(core_read_request_fire),
+    .grant(rd_grant)
+  );
+
+  wire rd_sel = rd_grant[OWNER_XCEL] ? OWNER_XCEL : OWNER_DMA;
+
+  FIFO #(
+    .WIDTH(1 + 32),
+    .LOGDEPTH(OWNER_LOGDEPTH)
+  ) rd_owner_fifo (
+    .clk(clk),
+    .rst(rst),
+
+    .enq_valid(core_read_request_fire),
+    .enq_data({rd_sel, core_read_len}),
+    .enq_ready(rd_owner_enq_ready),
 
-  assign core_read_addr  = xcel_busy ? xcel_read_addr  :
-                                       dma_read_addr;
-  assign core_read_len   = xcel_busy ? xcel_read_len   :
-                                       dma_read_len;
-  assign core_read_size  = xcel_busy ? xcel_read_size  :
-                                       dma_read_size;
-  assign core_read_burst = xcel_busy ? xcel_read_burst :
-                                       dma_read_burst;
+    .deq_valid(rd_owner_valid),
+    .deq_data({rd_owner, rd_len}),
+    .deq_ready(rd_last_beat)
+  );
+
+  wire [31:0] rd_beat_cnt_value, rd_beat_cnt_next;
+  wire rd_beat_cnt_ce, rd_beat_cnt_rst;
+  REGISTER_R_CE #(.N(32), .INIT(0)) rd_beat_cnt_reg (
+    .clk(clk),
+    .rst(rd_beat_cnt_rst),
+    .d(rd_beat_cnt_next),
+    .q(rd_beat_cnt_value),
+    .ce(rd_beat_cnt_ce)
+  );
+
+  assign rd_last_beat = core_read_data_fire & (rd_beat_cnt_value == rd_len);
+
+  assign rd_beat_cnt_next = rd_beat_cnt_value + 1;
+  assign rd_beat_cnt_ce   = core_read_data_fire;
+  assign rd_beat_cnt_rst  = rd_last_beat | rst;
+
+  assign core_read_request_valid = rd_owner_enq_ready &
+                                   (rd_sel == OWNER_XCEL ? xcel_read_request_valid :
+                                                           dma_read_request_valid);
+  assign dma_read_request_ready  = core_read_request_ready & rd_owner_enq_ready &
+                                   (rd_sel == OWNER_DMA);
+  assign xcel_read_request_ready = core_read_request_ready & rd_owner_enq_ready &
+                                   (rd_sel == OWNER_XCEL);
+
+  assign core_read_addr  = (rd_sel == OWNER_XCEL) ? xcel_read_addr  :
+                                                    dma_read_addr;
+  assign core_read_len   = (rd_sel == OWNER_XCEL) ? xcel_read_len   :
+                                                    dma_read_len;
+  assign core_read_size  = (rd_sel == OWNER_XCEL) ? xcel_read_size  :
+                                                    dma_read_size;
+  assign core_read_burst = (rd_sel == OWNER_XCEL) ? xcel_read_burst :
+                                                    dma_read_burst;
 
   assign dma_read_data  = core_read_data;
   assign xcel_read_data = core_read_data;
 
-  assign dma_read_data_valid  = core_read_data_valid;
-  assign xcel_read_data_valid = core_read_data_valid;
+  assign dma_read_data_valid  = core_read_data_valid & rd_owner_valid &
+                                (rd_owner == OWNER_DMA);
+  assign xcel_read_data_valid = core_read_data_valid & rd_owner_valid &
+                                (rd_owner == OWNER_XCEL);
+
+  assign core_read_data_ready = rd_owner_valid &
+                                ((rd_owner == OWNER_XCEL) ? xcel_read_data_ready :
+                                                            dma_read_data_ready);
+
+  // Write channel
+  wire wr_owner_enq_ready;
+  wire wr_owner_valid;
+  wire wr_owner;
+  wire [31:0] wr_len;
+  wire wr_last_beat;
+
+  wire [1:0] wr_grant;
+  rr_arbiter #(.NUM_REQ(2)) wr_rr (
+    .clk(clk),
+    .rst(rst),
+    .req({xcel_write_request_valid, dma_write_request_valid} & {2{wr_owner_enq_ready}}),
+    .advance(core_write_request_fire),
+    .grant(wr_grant)
+  );
+
+  wire wr_sel = wr_grant[OWNER_XCEL] ? OWNER_XCEL : OWNER_DMA;
+
+  FIFO #(
+    .WIDTH(1 + 32),
+    .LOGDEPTH(OWNER_LOGDEPTH)
+  ) wr_owner_fifo (
+    .clk(clk),
+    .rst(rst),
+
+    .enq_valid(core_write_request_fire),
+    .enq_data({wr_sel, core_write_len}),
+    .enq_ready(wr_owner_enq_ready),
+
+    .deq_valid(wr_owner_valid),
+    .deq_data({wr_owner, wr_len}),
+    .deq_ready(wr_last_beat)
+  );
+
+  wire [31:0] wr_beat_cnt_value, wr_beat_cnt_next;
+  wire wr_beat_cnt_ce, wr_beat_cnt_rst;
+  REGISTER_R_CE #(.N(32), .INIT(0)) wr_beat_cnt_reg (
+    .clk(clk),
+    .rst(wr_beat_cnt_rst),
+    .d(wr_beat_cnt_next),
+    .q(wr_beat_cnt_value),
+    .ce(wr_beat_cnt_ce)
+  );
+
+  assign wr_last_beat = core_write_data_fire & (wr_beat_cnt_value == wr_len);
+
+  assign wr_beat_cnt_next = wr_beat_cnt_value + 1;
+  assign wr_beat_cnt_ce   = core_write_data_fire;
+  assign wr_beat_cnt_rst  = wr_last_beat | rst;
+
+  assign core_write_request_valid = wr_owner_enq_ready &
+                                    (wr_sel == OWNER_XCEL ? xcel_write_request_valid :
+                                                            dma_write_request_valid);
+
+  assign dma_write_request_ready  = core_write_request_ready & wr_owner_enq_ready &
+                                    (wr_sel == OWNER_DMA);
+  assign xcel_write_request_ready = core_write_request_ready & wr_owner_enq_ready &
+                                    (wr_sel == OWNER_XCEL);
+
+  assign core_write_addr  = (wr_sel == OWNER_XCEL) ? xcel_write_addr  :
+                                                     dma_write_addr;
+  assign core_write_len   = (wr_sel == OWNER_XCEL) ? xcel_write_len   :
+                                                     dma_write_len;
+  assign core_write_size  = (wr_sel == OWNER_XCEL) ? xcel_write_size  :
+                                                     dma_write_size;
+  assign core_write_burst = (wr_sel == OWNER_XCEL) ? xcel_write_burst :
+                                                     dma_write_burst;
+  assign core_write_data  = (wr_owner == OWNER_XCEL) ? xcel_write_data  :
+                                                       dma_write_data;
 
-  assign core_read_data_ready = xcel_busy ? xcel_read_data_ready :
-                                            dma_read_data_ready;
+  assign core_write_data_valid = wr_owner_valid &
+                                 ((wr_owner == OWNER_XCEL) ? xcel_write_data_valid :
+                                                             dma_write_data_valid);
 
-  assign core_write_request_valid = xcel_busy ? xcel_write_request_valid :
-                                                dma_write_request_valid;
+  assign dma_write_data_ready  = core_write_data_ready & wr_owner_valid &
+                                 (wr_owner == OWNER_DMA);
+  assign xcel_write_data_ready = core_write_data_ready & wr_owner_valid &
+                                 (wr_owner == OWNER_XCEL);
 
-  assign dma_write_request_ready  = core_write_request_ready;
-  assign xcel_write_request_ready = core_write_request_ready;
+  // Write completion, per client: a client's writes are done once the
+  // adapter has gone idle (every granted write sent and acknowledged) since
+  // its last write request. The write responses are not tagged with their
+  // client, so a client may also wait for the other client's writes, but
+  // only while some of its own are in flight
+  wire [1:0] wr_pending_value, wr_pending_next;
+  REGISTER_R #(.N(2), .INIT(0)) wr_pending_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(wr_pending_next),
+    .q(wr_pending_value)
+  );
 
-  assign core_write_addr  = xcel_busy ? xcel_write_addr  :
-                                        dma_write_addr;
-  assign core_write_len   = xcel_busy ? xcel_write_len   :
-                                        dma_write_len;
-  assign core_write_size  = xcel_busy ? xcel_write_size  :
-                                        dma_write_size;
-  assign core_write_burst = xcel_busy ? xcel_write_burst :
-                                        dma_write_burst;
-  assign core_write_data  = xcel_busy ? xcel_write_data  :
-                                        dma_write_data;
+  wire wr_all_idle = core_write_idle & ~wr_owner_valid;
 
-  assign core_write_data_valid = xcel_busy ? xcel_write_data_valid :
-                                             dma_write_data_valid;
+  assign wr_pending_next = (wr_pending_value & {2{~wr_all_idle}}) |
+                           ({wr_sel == OWNER_XCEL, wr_sel == OWNER_DMA} &
+                            {2{core_write_request_fire}});
 
-  assign dma_write_data_ready  = core_write_data_ready;
-  assign xcel_write_data_ready = core_write_data_ready;
+  assign dma_write_idle  = ~wr_pending_value[OWNER_DMA];
+  assign xcel_write_idle = ~wr_pending_value[OWNER_XCEL];
 
 endmodule
@@ -3,7 +3,9 @@
 module axi_mm_adapter #(
   parameter AXI_AWIDTH = 32,
   parameter AXI_DWIDTH = 32,
-  parameter AXI_MAX_BURST_LEN = 256
+  parameter AXI_MAX_BURST_LEN = 256,
+  // AXI bursts in flight per direction (see axi_mm_read/axi_mm_write)
+  parameter AXI_MAX_OUTSTANDING = 4
 ) (
   input clk,
   input resetn, // active-low reset
@@ -68,7 +70,8 @@ module axi_mm_adapter #(
   input                   core_read_data_ready,
 
   // Write request address and Write request data
-  // (no write response -- assuming write always succeeds)
+  // (no write response -- assuming write always succeeds; core_write_idle
+  // tells when the responses of all of them are in)
   input                   core_write_request_valid,
   output                  core_write_request_ready,
   input  [AXI_AWIDTH-1:0] core_write_addr,
@@ -77,10 +80,16 @@ module axi_mm_adapter #(
   input  [1:0]            core_write_burst,
   input  [AXI_DWIDTH-1:0] core_write_data,
   input                   core_write_data_valid,
-  output                  core_write_data_ready
+  output                  core_write_data_ready,
+  output                  core_write_idle
 );
 
-  axi_mm_write #(.AXI_AWIDTH(AXI_AWIDTH), .AXI_DWIDTH(AXI_DWIDTH)) write_unit (
+  axi_mm_write #(
+    .AXI_AWIDTH(AXI_AWIDTH),
+    .AXI_DWIDTH(AXI_DWIDTH),
+    .AXI_MAX_BURST_LEN(AXI_MAX_BURST_LEN),
+    .AXI_MAX_OUTSTANDING(AXI_MAX_OUTSTANDING)
+  ) write_unit (
     .clk(clk),
     .resetn(resetn),
 
@@ -116,10 +125,16 @@ module axi_mm_adapter #(
     .core_write_burst(core_write_burst),
     .core_write_data(core_write_data),
     .core_write_data_valid(core_write_data_valid),
-    .core_write_data_ready(core_write_data_ready)
+    .core_write_data_ready(core_write_data_ready),
+    .write_idle(core_write_idle)
   );
 
-  axi_mm_read #(.AXI_AWIDTH(AXI_AWIDTH), .AXI_DWIDTH(AXI_DWIDTH)) read_unit (
+  axi_mm_read #(
+    .AXI_AWIDTH(AXI_AWIDTH),
+    .AXI_DWIDTH(AXI_DWIDTH),
+    .AXI_MAX_BURST_LEN(AXI_MAX_BURST_LEN),
+    .AXI_MAX_OUTSTANDING(AXI_MAX_OUTSTANDING)
+  ) read_unit (
     .clk(clk),
     .resetn(resetn),
 
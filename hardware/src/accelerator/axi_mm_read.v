@@ -3,7 +3,11 @@
 module axi_mm_read #(
   parameter AXI_AWIDTH = 32,
   parameter AXI_DWIDTH = 32,
-  parameter AXI_MAX_BURST_LEN = 256
+  parameter AXI_MAX_BURST_LEN = 256,
+  // number of AXI read bursts that may be waiting for their data
+  parameter AXI_MAX_OUTSTANDING = 4,
+  // read data FIFO, between the AXI R channel and the core
+  parameter RDATA_LOGDEPTH = 3
 ) (
   input clk,
   input resetn, // active-low reset
@@ -47,31 +51,22 @@ module axi_mm_read #(
 
   wire core_read_request_fire  = core_read_request_valid & core_read_request_ready;
 
-  localparam STATE_AR_IDLE = 2'b00;
-  localparam STATE_AR_RUN  = 2'b01;
-  localparam STATE_AR_DONE = 2'b10;
-
-  localparam STATE_DR_IDLE = 2'b00;
-  localparam STATE_DR_RUN  = 2'b01;
-  localparam STATE_DR_DONE = 2'b10;
-
-  wire [1:0] state_ar_value;
-  reg  [1:0] state_ar_next;
-  wire [1:0] state_dr_value;
-  reg  [1:0] state_dr_next;
-
-  REGISTER_R #(.N(2), .INIT(STATE_AR_IDLE)) state_ar_reg (
-    .clk(clk),
-    .rst(~resetn),
-    .d(state_ar_next),
-    .q(state_ar_value)
-  );
-
-  REGISTER_R #(.N(2), .INIT(STATE_DR_IDLE)) state_dr_reg (
+  // The address channel runs ahead of the data channel: it sends the bursts
+  // of a request back to back, as long as fewer than AXI_MAX_OUTSTANDING
+  // bursts are waiting for their data. All bursts use the same ID, so the
+  // data comes back in request order and only needs to be counted. A new
+  // core request is taken as soon as the last burst of the previous one has
+  // been sent, so the DDR latency of consecutive requests overlaps too
+
+  // The current request still has bursts to send
+  wire ar_busy_value, ar_busy_next;
+  wire ar_busy_ce;
+  REGISTER_R_CE #(.N(1), .INIT(0)) ar_busy_reg (
     .clk(clk),
     .rst(~resetn),
-    .d(state_dr_next),
-    .q(state_dr_value)
+    .d(ar_busy_next),
+    .q(ar_busy_value),
+    .ce(ar_busy_ce)
   );
 
   wire [AXI_AWIDTH-1:0] raddr_next, raddr_value;
@@ -114,6 +109,17 @@ module axi_mm_read #(
     .ce(rburst_ce)
   );
 
+  // Number of bursts sent but not fully received yet
+  wire [31:0] outstanding_value, outstanding_next;
+  wire outstanding_ce;
+  REGISTER_R_CE #(.N(32), .INIT(0)) outstanding_reg (
+    .clk(clk),
+    .rst(~resetn),
+    .d(outstanding_next),
+    .q(outstanding_value),
+    .ce(outstanding_ce)
+  );
+
   // If a request has a burst length which is greater than the MAX_BURST_LEN,
   // we need to send multiple burst requests one after another to cover the
   // whole burst length
@@ -123,75 +129,6 @@ module axi_mm_read #(
   //      req1:     <addr0 + {MAX_BURST_LEN << size}, MAX_BURST_LEN>
   //      ...
   //      reqN:     <addr0 + {k << size}, k>
-
-  // resume the request until the burst is fully covered
-  wire rburst_resume_next, rburst_resume_value;
-  wire rburst_resume_ce, rburst_resume_rst;
-
-  REGISTER_R_CE #(.N(1), .INIT(0)) rburst_resume_reg (
-    .clk(clk),
-    .rst(rburst_resume_rst),
-    .d(rburst_resume_next),
-    .q(rburst_resume_value),
-    .ce(rburst_resume_ce)
-  );
-
-  wire ar_idle = (state_ar_value == STATE_AR_IDLE);
-  wire ar_run  = (state_ar_value == STATE_AR_RUN);
-  wire ar_done = (state_ar_value == STATE_AR_DONE);
-
-  wire dr_idle = (state_dr_value == STATE_DR_IDLE);
-  wire dr_run  = (state_dr_value == STATE_DR_RUN);
-  wire dr_done = (state_dr_value == STATE_DR_DONE);
-
-  always @(*) begin
-    state_ar_next = state_ar_value;
-    case (state_ar_value)
-      STATE_AR_IDLE: begin
-        // start the request if the core sends a request, or
-        // if we need to resume the request to finish the burst
-        if (core_read_request_fire || rburst_resume_value)
-          state_ar_next = STATE_AR_RUN;
-      end
-
-      STATE_AR_RUN: begin
-        // if the AXI has submitted the request, this is done
-        if (ar_fire) begin
-          state_ar_next = STATE_AR_DONE;
-        end
-      end
-
-      STATE_AR_DONE: begin
-        state_ar_next = STATE_AR_IDLE;
-      end
-
-    endcase
-  end
-
-  always @(*) begin
-    state_dr_next = state_dr_value;
-    case (state_dr_value)
-      STATE_DR_IDLE: begin
-        // if the AXI has submitted the request, we'll wait for the
-        // response data in the next state
-        if (ar_fire)
-          state_dr_next = STATE_DR_RUN;
-      end
-
-      STATE_DR_RUN: begin
-        // if the last data is fired, we are done
-        if (dr_fire && rlast) begin
-          state_dr_next = STATE_DR_DONE;
-        end
-      end
-
-      STATE_DR_DONE: begin
-        state_dr_next = STATE_DR_IDLE;
-      end
-
-    endcase
-  end
-
   wire full_rburst = rlen_value > AXI_MAX_BURST_LEN - 1;
 
   // register the settings from the core client
@@ -202,35 +139,51 @@ module axi_mm_read #(
   assign rburst_next = core_read_burst;
   assign rburst_ce   = core_read_request_fire;
 
-  // Recalculate the address if we need to send multiple requests to cover
-  // the full burst length
+  // Move on to the next burst of the request once this one is sent
   assign raddr_next = core_read_request_fire ? core_read_addr :
                                                raddr_value + (AXI_MAX_BURST_LEN << rsize_value);
-  assign raddr_ce   = core_read_request_fire | (dr_fire & rlast);
+  assign raddr_ce   = core_read_request_fire | ar_fire;
 
-  // Recalculate the len if we need to send multiple requests to cover
-  // the full burst length
   assign rlen_next = core_read_request_fire ? core_read_len :
                                               rlen_value - AXI_MAX_BURST_LEN;
-  assign rlen_ce   = core_read_request_fire | (dr_fire & rlast);
+  assign rlen_ce   = core_read_request_fire | ar_fire;
+
+  // Done with the request after its last (not full) burst
+  assign ar_busy_next = core_read_request_fire;
+  assign ar_busy_ce   = core_read_request_fire | (ar_fire & ~full_rburst);
 
-  // Resume the burst (or send a new request) if we yet to cover the whole burst length
-  assign rburst_resume_next = full_rburst ? 1 : 0;
-  assign rburst_resume_ce   = dr_fire & rlast;
-  assign rburst_resume_rst  = dr_idle | (~resetn);
+  wire dr_last_fire = dr_fire & rlast;
+
+  assign outstanding_next = outstanding_value + ar_fire - dr_last_fire;
+  assign outstanding_ce   = ar_fire | dr_last_fire;
 
   // Setup read request for AXI adater read
-  assign arvalid = ar_run;
+  // (outstanding_value only goes down while arvalid waits on arready)
+  assign arvalid = ar_busy_value & (outstanding_value < AXI_MAX_OUTSTANDING);
   assign araddr  = raddr_value;
   assign arlen   = full_rburst ? AXI_MAX_BURST_LEN - 1 : rlen_value;
   assign arsize  = rsize_value;
   assign arburst = rburst_value;
 
-  assign rready  = dr_run & core_read_data_ready;
+  assign core_read_request_ready = ~ar_busy_value;
+
+  // The read data FIFO keeps the R channel moving for a beat or two while
+  // the core is not ready
+  FIFO #(
+    .WIDTH(AXI_DWIDTH),
+    .LOGDEPTH(RDATA_LOGDEPTH)
+  ) rdata_fifo (
+    .clk(clk),
+    .rst(~resetn),
+
+    .enq_valid(rvalid),
+    .enq_data(rdata),
+    .enq_ready(rready),
 
-  assign core_read_request_ready = dr_idle & (~rburst_resume_value);
-  assign core_read_data          = rdata;
-  assign core_read_data_valid    = dr_run & rvalid;
+    .deq_valid(core_read_data_valid),
+    .deq_data(core_read_data),
+    .deq_ready(core_read_data_ready)
+  );
 
   // Keep it simple: use ID 0 for now
   assign arid = 0;
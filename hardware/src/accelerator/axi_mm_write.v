@@ -3,7 +3,11 @@
 module axi_mm_write #(
   parameter AXI_AWIDTH = 32,
   parameter AXI_DWIDTH = 32,
-  parameter AXI_MAX_BURST_LEN = 256
+  parameter AXI_MAX_BURST_LEN = 256,
+  // number of AXI write bursts that may be waiting for their response
+  parameter AXI_MAX_OUTSTANDING = 4,
+  // write data FIFO, between the core and the AXI W channel
+  parameter WDATA_LOGDEPTH = 3
 ) (
   input clk,
   input resetn, // active-low reset
@@ -43,7 +47,9 @@ module axi_mm_write #(
   input  [1:0]            core_write_burst,
   input  [AXI_DWIDTH-1:0] core_write_data,
   input                   core_write_data_valid,
-  output                  core_write_data_ready
+  output                  core_write_data_ready,
+  // Every accepted write has been sent and acknowledged
+  output                  write_idle
 );
 
   // number of data transfers (beats) = len + 1
@@ -54,35 +60,36 @@ module axi_mm_write #(
   wire bresp_fire = bvalid  & bready;
 
   wire core_write_request_fire = core_write_request_valid & core_write_request_ready;
-  wire core_write_data_fire    = core_write_data_valid    & core_write_data_ready;
 
   localparam NUM_DBYTES = AXI_DWIDTH / 8;
 
-  localparam STATE_AW_IDLE = 2'b00;
-  localparam STATE_AW_RUN  = 2'b01;
-  localparam STATE_AW_DONE = 2'b10;
-
-  localparam STATE_DW_IDLE = 2'b00;
-  localparam STATE_DW_RUN  = 2'b01;
-  localparam STATE_DW_DONE = 2'b10;
-
-  wire [1:0] state_aw_value;
-  reg  [1:0] state_aw_next;
-  wire [1:0] state_dw_value;
-  reg  [1:0] state_dw_next;
-
-  REGISTER_R #(.N(2), .INIT(STATE_AW_IDLE)) state_aw_reg (
+  // The address and data channels run independently: the address channel
+  // sends the bursts of a request back to back, as long as fewer than
+  // AXI_MAX_OUTSTANDING bursts are waiting for their write response, while
+  // the data channel streams the beats of the same bursts out of the write
+  // data FIFO. A new core request is taken once both are done with the
+  // previous one; its responses may still be in flight
+
+  // The current request still has bursts to send (address channel)
+  wire aw_busy_value, aw_busy_next;
+  wire aw_busy_ce;
+  REGISTER_R_CE #(.N(1), .INIT(0)) aw_busy_reg (
     .clk(clk),
     .rst(~resetn),
-    .d(state_aw_next),
-    .q(state_aw_value)
+    .d(aw_busy_next),
+    .q(aw_busy_value),
+    .ce(aw_busy_ce)
   );
 
-  REGISTER_R #(.N(2), .INIT(STATE_DW_IDLE)) state_dw_reg (
+  // The current request still has beats to send (data channel)
+  wire dw_busy_value, dw_busy_next;
+  wire dw_busy_ce;
+  REGISTER_R_CE #(.N(1), .INIT(0)) dw_busy_reg (
     .clk(clk),
     .rst(~resetn),
-    .d(state_dw_next),
-    .q(state_dw_value)
+    .d(dw_busy_next),
+    .q(dw_busy_value),
+    .ce(dw_busy_ce)
   );
 
   wire [AXI_AWIDTH-1:0] waddr_next, waddr_value;
@@ -95,6 +102,7 @@ module axi_mm_write #(
     .ce(waddr_ce)
   );
 
+  // Remaining length, as seen by the address channel
   wire [31:0] wlen_next, wlen_value;
   wire wlen_ce;
   REGISTER_R_CE #(.N(32), .INIT(0)) wlen_reg (
@@ -105,6 +113,28 @@ module axi_mm_write #(
     .ce(wlen_ce)
   );
 
+  // Remaining length, as seen by the data channel
+  wire [31:0] dlen_next, dlen_value;
+  wire dlen_ce;
+  REGISTER_R_CE #(.N(32), .INIT(0)) dlen_reg (
+    .clk(clk),
+    .rst(~resetn),
+    .d(dlen_next),
+    .q(dlen_value),
+    .ce(dlen_ce)
+  );
+
+  // Address of the next write data beat, for the write strobes
+  wire [AXI_AWIDTH-1:0] daddr_next, daddr_value;
+  wire daddr_ce;
+  REGISTER_R_CE #(.N(AXI_AWIDTH), .INIT(0)) daddr_reg (
+    .clk(clk),
+    .rst(~resetn),
+    .d(daddr_next),
+    .q(daddr_value),
+    .ce(daddr_ce)
+  );
+
   wire [2:0] wsize_next, wsize_value;
   wire wsize_ce;
   REGISTER_R_CE #(.N(3), .INIT(0)) wsize_reg (
@@ -135,6 +165,17 @@ module axi_mm_write #(
     .ce(wbeat_cnt_ce)
   );
 
+  // Number of bursts sent but not acknowledged yet
+  wire [31:0] outstanding_value, outstanding_next;
+  wire outstanding_ce;
+  REGISTER_R_CE #(.N(32), .INIT(0)) outstanding_reg (
+    .clk(clk),
+    .rst(~resetn),
+    .d(outstanding_next),
+    .q(outstanding_value),
+    .ce(outstanding_ce)
+  );
+
   // If a request has a burst length which is greater than the MAX_BURST_LEN,
   // we need to send multiple burst requests one after another to cover the
   // whole burst length
@@ -144,79 +185,8 @@ module axi_mm_write #(
   //      req1:     <addr0 + {MAX_BURST_LEN << size}, MAX_BURST_LEN>
   //      ...
   //      reqN:     <addr0 + {k << size}, k>
-
-  // resume the request until the burst is fully covered
-  wire wburst_resume_next, wburst_resume_value;
-  wire wburst_resume_ce, wburst_resume_rst;
-  REGISTER_R_CE #(.N(1), .INIT(0)) wburst_resume_reg (
-    .clk(clk),
-    .rst(wburst_resume_rst),
-    .d(wburst_resume_next),
-    .q(wburst_resume_value),
-    .ce(wburst_resume_ce)
-  );
-
-  wire aw_idle = (state_aw_value == STATE_AW_IDLE);
-  wire aw_run  = (state_aw_value == STATE_AW_RUN);
-  wire aw_done = (state_aw_value == STATE_AW_DONE);
-
-  wire dw_idle = (state_dw_value == STATE_DW_IDLE);
-  wire dw_run  = (state_dw_value == STATE_DW_RUN);
-  wire dw_done = (state_dw_value == STATE_DW_DONE);
-
-  always @(*) begin
-    state_aw_next = state_aw_value;
-    case (state_aw_value)
-      STATE_AW_IDLE: begin
-        // start the request if the core sends a request, or
-        // if we need to resume the request to finish the burst
-        if (core_write_request_fire || wburst_resume_value)
-          state_aw_next = STATE_AW_RUN;
-      end
-
-      STATE_AW_RUN: begin
-        // if the AXI has submitted the request, this is done
-        if (aw_fire) begin
-          state_aw_next = STATE_AW_DONE;
-        end
-      end
-
-      STATE_AW_DONE: begin
-        // Need to wait for the write response before done
-        if (bresp_fire)
-          state_aw_next = STATE_AW_IDLE;
-      end
-
-    endcase
-  end
-
-  always @(*) begin
-    state_dw_next = state_dw_value;
-    case (state_dw_value)
-      STATE_DW_IDLE: begin
-        // start the request if the core sends a request, or
-        // if we need to resume the request to finish the burst
-        if (core_write_request_fire || wburst_resume_value)
-          state_dw_next = STATE_DW_RUN;
-      end
-
-      STATE_DW_RUN: begin
-        // if the last data is fired, we are done
-        if (dw_fire && wlast) begin
-          state_dw_next = STATE_DW_DONE;
-        end
-      end
-
-      STATE_DW_DONE: begin
-        // Need to wait for the write response before done
-        if (bresp_fire)
-          state_dw_next = STATE_DW_IDLE;
-      end
-
-    endcase
-  end
-
   wire full_wburst = wlen_value > AXI_MAX_BURST_LEN - 1;
+  wire full_dburst = dlen_value > AXI_MAX_BURST_LEN - 1;
 
   // register the settings from the core client
   // (size, burst)
@@ -226,57 +196,93 @@ module axi_mm_write #(
   assign wburst_next = core_write_burst;
   assign wburst_ce   = core_write_request_fire;
 
-  // Recalculate the address if we need to send multiple requests to cover
-  // the full burst length
+  // Move on to the next burst of the request once this one is sent
   assign waddr_next = core_write_request_fire ? core_write_addr :
                                                 {waddr_value + {AXI_MAX_BURST_LEN << wsize_value}};
-  assign waddr_ce   = core_write_request_fire | (dw_fire & wlast);
+  assign waddr_ce   = core_write_request_fire | aw_fire;
+
+  assign daddr_next = core_write_request_fire ? core_write_addr :
+                                                {daddr_value + (1 << wsize_value)};
+  assign daddr_ce   = core_write_request_fire | dw_fire;
 
-  // Recalculate the len if we need to send multiple requests to cover
-  // the full burst length
   assign wlen_next = core_write_request_fire ? core_write_len :
                                                {wlen_value - AXI_MAX_BURST_LEN};
-  assign wlen_ce   = core_write_request_fire | (dw_fire & wlast);
+  assign wlen_ce   = core_write_request_fire | aw_fire;
 
-  // Resume the burst (or send a new request) if we yet to cover the whole burst length
-  assign wburst_resume_next = full_wburst ? 1'b1 : 1'b0;
-  assign wburst_resume_ce   = dw_fire & wlast;
-  assign wburst_resume_rst  = dw_idle | (~resetn);
+  assign dlen_next = core_write_request_fire ? core_write_len :
+                                               {dlen_value - AXI_MAX_BURST_LEN};
+  assign dlen_ce   = core_write_request_fire | (dw_fire & wlast);
+
+  // Done with the request after its last (not full) burst
+  assign aw_busy_next = core_write_request_fire;
+  assign aw_busy_ce   = core_write_request_fire | (aw_fire & ~full_wburst);
+
+  assign dw_busy_next = core_write_request_fire;
+  assign dw_busy_ce   = core_write_request_fire | (dw_fire & wlast & ~full_dburst);
+
+  assign outstanding_next = outstanding_value + aw_fire - bresp_fire;
+  assign outstanding_ce   = aw_fire | bresp_fire;
 
   // Count the number of write data beats to assert the 'last' signal
   assign wbeat_cnt_next = wbeat_cnt_value + 1;
   assign wbeat_cnt_ce   = dw_fire;
-  assign wbeat_cnt_rst  = dw_idle | (~resetn);
+  assign wbeat_cnt_rst  = (dw_fire & wlast) | (~resetn);
 
   // Setup write request address for AXI adapter read
+  // (outstanding_value only goes down while awvalid waits on awready)
   assign awaddr  = waddr_value;
-  assign awvalid = aw_run;
+  assign awvalid = aw_busy_value & (outstanding_value < AXI_MAX_OUTSTANDING);
   assign awlen   = full_wburst ? {AXI_MAX_BURST_LEN - 1} : wlen_value;
   assign awsize  = wsize_value;
   assign awburst = wburst_value;
 
   // Setup write request data for AXI adapter write
-  assign wdata   = core_write_data;
-  assign wvalid  = dw_run & core_write_data_valid;
-  assign wlast   = dw_run &
-                   ((wbeat_cnt_value == wlen_value & ~full_wburst) |
+  wire wdata_valid, wdata_fifo_ready;
+  FIFO #(
+    .WIDTH(AXI_DWIDTH),
+    .LOGDEPTH(WDATA_LOGDEPTH)
+  ) wdata_fifo (
+    .clk(clk),
+    .rst(~resetn),
+
+    .enq_valid(core_write_data_valid & dw_busy_value),
+    .enq_data(core_write_data),
+    .enq_ready(wdata_fifo_ready),
+
+    .deq_valid(wdata_valid),
+    .deq_data(wdata),
+    .deq_ready(wready & dw_busy_value)
+  );
+
+  assign wvalid  = dw_busy_value & wdata_valid;
+  assign wlast   = dw_busy_value &
+                   ((wbeat_cnt_value == dlen_value & ~full_dburst) |
                     (wbeat_cnt_value == AXI_MAX_BURST_LEN - 1));
 
-  // write response channel is only ready when write request address and request data
-  // are finally done
-  assign bready  = aw_done & dw_done;
+  // The responses are only counted (assuming write always succeeds)
+  assign bready  = 1'b1;
+
+  assign core_write_request_ready = ~aw_busy_value & ~dw_busy_value;
+  assign core_write_data_ready    = dw_busy_value & wdata_fifo_ready;
+
+  // A client that reads back what it wrote (or tells the CPU it is done)
+  // must wait for this: until its response, a burst may not have reached
+  // the memory yet, and a later read can overtake it
+  assign write_idle = ~aw_busy_value & ~dw_busy_value & ~wdata_valid &
+                      (outstanding_value == 0);
+
+  // Write strobes: all bytes for full-width beats; for narrower beats
+  // (size < log2(NUM_DBYTES)), only the 2^size bytes at the beat address
+  localparam FULL_SIZE = $clog2(NUM_DBYTES);
 
-  assign core_write_request_ready = aw_idle &
-                                    (~wburst_resume_value) &
-                                    awready;
-  assign core_write_data_ready    = dw_run & wready;
+  wire [NUM_DBYTES-1:0] narrow_wstrb = ((1 << (1 << wsize_value)) - 1) <<
+                                       daddr_value[FULL_SIZE-1:0];
 
-  // setup write strobe. Full word write for now?
-  assign wstrb = dw_run ? {NUM_DBYTES{1'b1}} : {NUM_DBYTES{1'b0}};
+  assign wstrb = ~dw_busy_value ? {NUM_DBYTES{1'b0}} :
+                 (wsize_value >= FULL_SIZE) ? {NUM_DBYTES{1'b1}} : narrow_wstrb;
 
   // Keep it simple: use ID 0 for now
   assign awid = 0;
   assign wid  = 0;
-  assign bid  = 0;
 
 endmodule
@@ -0,0 +1,251 @@
+// Passive traffic monitor on the core (client) side of the AXI adapter,
+// i.e. between the arbiter and axi_mm_adapter
+//
+// Counts, since the last reset or clear:
+// - the cycles, and the idle cycles (no read or write data beat)
+// - per master (0: DMA, 1: accelerator, as the arbiter grants them): the
+//   read and write requests (bursts) and data beats, and the latency of
+//   each read request from its handshake to its first data beat, as a sum,
+//   a maximum and a histogram of 8 log2 buckets: < 16 cycles, < 32, ...,
+//   < 1024, and >= 1024
+//
+// Like the arbiter, the beats are matched to their request in order,
+// through a FIFO of the requests in flight; LOGDEPTH must be at least the
+// arbiter's OWNER_LOGDEPTH so the FIFO can never be full.
+//
+// The counters are read out one at a time (value = counter sel):
+//   0: cycles, 1: idle cycles,
+//   16 * (m + 1) + 0: read requests of master m, + 1: read beats,
+//   + 2: write requests, + 3: write beats,
+//   + 4: read latency sum, + 5: read latency max,
+//   + 8 + b: read latency histogram bucket b
+module axi_monitor #(
+  parameter LOGDEPTH = 2
+) (
+  input clk,
+  input rst,
+  input clear,
+
+  input        read_request_valid,
+  input        read_request_ready,
+  input [31:0] read_len,
+  input        read_master,
+  input        read_data_valid,
+  input        read_data_ready,
+
+  input        write_request_valid,
+  input        write_request_ready,
+  input [31:0] write_len,
+  input        write_master,
+  input        write_data_valid,
+  input        write_data_ready,
+
+  input  [5:0]  sel,
+  output [31:0] value
+);
+
+  localparam NUM_MASTERS = 2;
+  localparam NUM_BUCKETS = 8;
+
+  wire read_request_fire  = read_request_valid  & read_request_ready;
+  wire read_data_fire     = read_data_valid     & read_data_ready;
+  wire write_request_fire = write_request_valid & write_request_ready;
+  wire write_data_fire    = write_data_valid    & write_data_ready;
+
+  wire cnt_rst = rst | clear;
+
+  // Free-running time stamp for the latencies
+  wire [31:0] now_value;
+  REGISTER_R #(.N(32), .INIT(0)) now_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(now_value + 1),
+    .q(now_value)
+  );
+
+  wire [31:0] cycles_value;
+  REGISTER_R #(.N(32), .INIT(0)) cycles_reg (
+    .clk(clk),
+    .rst(cnt_rst),
+    .d(cycles_value + 1),
+    .q(cycles_value)
+  );
+
+  wire [31:0] idle_value;
+  REGISTER_R_CE #(.N(32), .INIT(0)) idle_reg (
+    .clk(clk),
+    .rst(cnt_rst),
+    .d(idle_value + 1),
+    .q(idle_value),
+    .ce(~read_data_fire & ~write_data_fire)
+  );
+
+  // Read requests in flight: master, length, time of the handshake
+  wire        rd_head_valid;
+  wire        rd_master;
+  wire [31:0] rd_len;
+  wire [31:0] rd_start;
+  wire        rd_last_beat;
+
+  FIFO #(
+    .WIDTH(1 + 32 + 32),
+    .LOGDEPTH(LOGDEPTH)
+  ) rd_fifo (
+    .clk(clk),
+    .rst(rst),
+
+    .enq_valid(read_request_fire),
+    .enq_data({read_master, read_len, now_value}),
+    .enq_ready(),
+
+    .deq_valid(rd_head_valid),
+    .deq_data({rd_master, rd_len, rd_start}),
+    .deq_ready(rd_last_beat)
+  );
+
+  wire [31:0] rd_beat_cnt_value;
+  REGISTER_R_CE #(.N(32), .INIT(0)) rd_beat_cnt_reg (
+    .clk(clk),
+    .rst(rd_last_beat | rst),
+    .d(rd_beat_cnt_value + 1),
+    .q(rd_beat_cnt_value),
+    .ce(read_data_fire)
+  );
+
+  assign rd_last_beat = read_data_fire & (rd_beat_cnt_value == rd_len);
+
+  wire rd_first_beat = read_data_fire & rd_head_valid & (rd_beat_cnt_value == 0);
+
+  wire [31:0] rd_latency = now_value - rd_start;
+
+  wire [31:0] rd_bucket = (rd_latency < 16)  ? 0 :
+                          (rd_latency < 32)  ? 1 :
+                          (rd_latency < 64)  ? 2 :
+                          (rd_latency < 128) ? 3 :
+                          (rd_latency < 256) ? 4 :
+                          (rd_latency < 512) ? 5 :
+                          (rd_latency < 1024) ? 6 : 7;
+
+  // Write requests in flight: master, length
+  wire        wr_master;
+  wire [31:0] wr_len;
+  wire        wr_last_beat;
+
+  FIFO #(
+    .WIDTH(1 + 32),
+    .LOGDEPTH(LOGDEPTH)
+  ) wr_fifo (
+    .clk(clk),
+    .rst(rst),
+
+    .enq_valid(write_request_fire),
+    .enq_data({write_master, write_len}),
+    .enq_ready(),
+
+    .deq_valid(),
+    .deq_data({wr_master, wr_len}),
+    .deq_ready(wr_last_beat)
+  );
+
+  wire [31:0] wr_beat_cnt_value;
+  REGISTER_R_CE #(.N(32), .INIT(0)) wr_beat_cnt_reg (
+    .clk(clk),
+    .rst(wr_last_beat | rst),
+    .d(wr_beat_cnt_value + 1),
+    .q(wr_beat_cnt_value),
+    .ce(write_data_fire)
+  );
+
+  assign wr_last_beat = write_data_fire & (wr_beat_cnt_value == wr_len);
+
+  // Per-master counters, read out by sel[3:0]
+  wire [NUM_MASTERS*32-1:0] master_values;
+
+  genvar m, b;
+  generate
+    for (m = 0; m < NUM_MASTERS; m = m + 1) begin:MASTER
+      wire rd_req  = read_request_fire  & (read_master  == m);
+      wire rd_beat = read_data_fire     & (rd_master    == m);
+      wire wr_req  = write_request_fire & (write_master == m);
+      wire wr_beat = write_data_fire    & (wr_master    == m);
+      wire rd_lat  = rd_first_beat      & (rd_master    == m);
+
+      wire [31:0] rd_reqs_value, rd_beats_value, wr_reqs_value, wr_beats_value;
+      wire [31:0] lat_sum_value, lat_max_value;
+
+      REGISTER_R_CE #(.N(32), .INIT(0)) rd_reqs_reg (
+        .clk(clk),
+        .rst(cnt_rst),
+        .d(rd_reqs_value + 1),
+        .q(rd_reqs_value),
+        .ce(rd_req)
+      );
+
+      REGISTER_R_CE #(.N(32), .INIT(0)) rd_beats_reg (
+        .clk(clk),
+        .rst(cnt_rst),
+        .d(rd_beats_value + 1),
+        .q(rd_beats_value),
+        .ce(rd_beat)
+      );
+
+      REGISTER_R_CE #(.N(32), .INIT(0)) wr_reqs_reg (
+        .clk(clk),
+        .rst(cnt_rst),
+        .d(wr_reqs_value + 1),
+        .q(wr_reqs_value),
+        .ce(wr_req)
+      );
+
+      REGISTER_R_CE #(.N(32), .INIT(0)) wr_beats_reg (
+        .clk(clk),
+        .rst(cnt_rst),
+        .d(wr_beats_value + 1),
+        .q(wr_beats_value),
+        .ce(wr_beat)
+      );
+
+      REGISTER_R_CE #(.N(32), .INIT(0)) lat_sum_reg (
+        .clk(clk),
+        .rst(cnt_rst),
+        .d(lat_sum_value + rd_latency),
+        .q(lat_sum_value),
+        .ce(rd_lat)
+      );
+
+      REGISTER_R_CE #(.N(32), .INIT(0)) lat_max_reg (
+        .clk(clk),
+        .rst(cnt_rst),
+        .d(rd_latency),
+        .q(lat_max_value),
+        .ce(rd_lat & (rd_latency > lat_max_value))
+      );
+
+      wire [NUM_BUCKETS*32-1:0] hist_values;
+      for (b = 0; b < NUM_BUCKETS; b = b + 1) begin:HIST
+        REGISTER_R_CE #(.N(32), .INIT(0)) hist_reg (
+          .clk(clk),
+          .rst(cnt_rst),
+          .d(hist_values[b*32 +: 32] + 1),
+          .q(hist_values[b*32 +: 32]),
+          .ce(rd_lat & (rd_bucket == b))
+        );
+      end
+
+      assign master_values[m*32 +: 32] =
+        sel[3]          ? hist_values[sel[2:0]*32 +: 32] :
+        (sel[2:0] == 0) ? rd_reqs_value  :
+        (sel[2:0] == 1) ? rd_beats_value :
+        (sel[2:0] == 2) ? wr_reqs_value  :
+        (sel[2:0] == 3) ? wr_beats_value :
+        (sel[2:0] == 4) ? lat_sum_value  :
+        (sel[2:0] == 5) ? lat_max_value  : 32'd0;
+    end
+  endgenerate
+
+  assign value = (sel == 0) ? cycles_value :
+                 (sel == 1) ? idle_value   :
+                 (sel[5:4] != 0 && sel[5:4] <= NUM_MASTERS) ? master_values[(sel[5:4] - 1)*32 +: 32] :
+                                                               32'd0;
+
+endmodule
@@ -0,0 +1,218 @@
+`include "axi_consts.vh"
+
+// Width converter between a narrow core (client) interface, e.g. the DMA
+// with its one DMem word per beat, and a wider arbiter / AXI adapter data
+// path (WIDE_DWIDTH = RATIO * NARROW_DWIDTH).
+// The narrow client must use INCR bursts of full narrow beats, and has one
+// read and one write request in flight at a time.
+//
+// Read: the request becomes a burst of full wide beats covering the
+// narrow range (the wide address is aligned down), and each wide beat is
+// handed out one narrow lane at a time; the lanes outside the range are
+// dropped.
+// Write: an aligned request with a multiple of RATIO beats becomes a burst
+// of full wide beats, RATIO narrow beats packed per wide beat. Anything else
+// is sent as narrow beats on the wide bus (the AXI adapter sets the write
+// strobes from the address), with the narrow data copied to every lane.
+module axi_upsizer #(
+  parameter AXI_AWIDTH    = 32,
+  parameter NARROW_DWIDTH = 32,
+  parameter WIDE_DWIDTH   = 32
+) (
+  input clk,
+  input rst,
+
+  // Narrow (client) interface
+  input                      narrow_read_request_valid,
+  output                     narrow_read_request_ready,
+  input  [AXI_AWIDTH-1:0]    narrow_read_addr,
+  input  [31:0]              narrow_read_len,
+  input  [2:0]               narrow_read_size,
+  input  [1:0]               narrow_read_burst,
+  output [NARROW_DWIDTH-1:0] narrow_read_data,
+  output                     narrow_read_data_valid,
+  input                      narrow_read_data_ready,
+
+  input                      narrow_write_request_valid,
+  output                     narrow_write_request_ready,
+  input  [AXI_AWIDTH-1:0]    narrow_write_addr,
+  input  [31:0]              narrow_write_len,
+  input  [2:0]               narrow_write_size,
+  input  [1:0]               narrow_write_burst,
+  input  [NARROW_DWIDTH-1:0] narrow_write_data,
+  input                      narrow_write_data_valid,
+  output                     narrow_write_data_ready,
+
+  // Wide interface (to the arbiter)
+  output                     wide_read_request_valid,
+  input                      wide_read_request_ready,
+  output [AXI_AWIDTH-1:0]    wide_read_addr,
+  output [31:0]              wide_read_len,
+  output [2:0]               wide_read_size,
+  output [1:0]               wide_read_burst,
+  input  [WIDE_DWIDTH-1:0]   wide_read_data,
+  input                      wide_read_data_valid,
+  output                     wide_read_data_ready,
+
+  output                     wide_write_request_valid,
+  input                      wide_write_request_ready,
+  output [AXI_AWIDTH-1:0]    wide_write_addr,
+  output [31:0]              wide_write_len,
+  output [2:0]               wide_write_size,
+  output [1:0]               wide_write_burst,
+  output [WIDE_DWIDTH-1:0]   wide_write_data,
+  output                     wide_write_data_valid,
+  input                      wide_write_data_ready
+);
+
+  localparam RATIO       = WIDE_DWIDTH / NARROW_DWIDTH;
+  localparam NARROW_SIZE = $clog2(NARROW_DWIDTH / 8);
+  localparam WIDE_SIZE   = $clog2(WIDE_DWIDTH / 8);
+  localparam LANE_BITS   = WIDE_SIZE - NARROW_SIZE;
+
+  generate
+    if (RATIO == 1) begin:PASS
+      assign wide_read_request_valid   = narrow_read_request_valid;
+      assign narrow_read_request_ready = wide_read_request_ready;
+      assign wide_read_addr            = narrow_read_addr;
+      assign wide_read_len             = narrow_read_len;
+      assign wide_read_size            = narrow_read_size;
+      assign wide_read_burst           = narrow_read_burst;
+      assign narrow_read_data          = wide_read_data;
+      assign narrow_read_data_valid    = wide_read_data_valid;
+      assign wide_read_data_ready      = narrow_read_data_ready;
+
+      assign wide_write_request_valid   = narrow_write_request_valid;
+      assign narrow_write_request_ready = wide_write_request_ready;
+      assign wide_write_addr            = narrow_write_addr;
+      assign wide_write_len             = narrow_write_len;
+      assign wide_write_size            = narrow_write_size;
+      assign wide_write_burst           = narrow_write_burst;
+      assign wide_write_data            = narrow_write_data;
+      assign wide_write_data_valid      = narrow_write_data_valid;
+      assign narrow_write_data_ready    = wide_write_data_ready;
+    end
+    else begin:CONV
+      wire narrow_read_request_fire   = narrow_read_request_valid  & narrow_read_request_ready;
+      wire narrow_read_data_fire      = narrow_read_data_valid     & narrow_read_data_ready;
+      wire narrow_write_request_fire  = narrow_write_request_valid & narrow_write_request_ready;
+      wire narrow_write_data_fire     = narrow_write_data_valid    & narrow_write_data_ready;
+
+      // Read
+      wire [LANE_BITS-1:0] rd_first_lane = narrow_read_addr[WIDE_SIZE-1:NARROW_SIZE];
+
+      wire rd_busy_value;
+      wire [LANE_BITS-1:0] rd_lane_value;
+      wire [31:0] rd_left_value;
+      REGISTER_R_CE #(.N(1), .INIT(0)) rd_busy_reg (
+        .clk(clk),
+        .rst(rst),
+        .d(narrow_read_request_fire),
+        .q(rd_busy_value),
+        .ce(narrow_read_request_fire | narrow_read_data_fire & (rd_left_value == 0))
+      );
+
+      // Current lane of the wide beat
+      REGISTER_R_CE #(.N(LANE_BITS), .INIT(0)) rd_lane_reg (
+        .clk(clk),
+        .rst(rst),
+        .d(narrow_read_request_fire ? rd_first_lane : rd_lane_value + 1),
+        .q(rd_lane_value),
+        .ce(narrow_read_request_fire | narrow_read_data_fire)
+      );
+
+      // Narrow beats left after the current one
+      REGISTER_R_CE #(.N(32), .INIT(0)) rd_left_reg (
+        .clk(clk),
+        .rst(rst),
+        .d(narrow_read_request_fire ? narrow_read_len : rd_left_value - 1),
+        .q(rd_left_value),
+        .ce(narrow_read_request_fire | narrow_read_data_fire)
+      );
+
+      assign wide_read_request_valid   = narrow_read_request_valid & ~rd_busy_value;
+      assign narrow_read_request_ready = wide_read_request_ready & ~rd_busy_value;
+      assign wide_read_addr  = {narrow_read_addr[AXI_AWIDTH-1:WIDE_SIZE], {WIDE_SIZE{1'b0}}};
+      assign wide_read_len   = (rd_first_lane + narrow_read_len) >> LANE_BITS;
+      assign wide_read_size  = WIDE_SIZE;
+      assign wide_read_burst = narrow_read_burst;
+
+      assign narrow_read_data       = wide_read_data[rd_lane_value * NARROW_DWIDTH +: NARROW_DWIDTH];
+      assign narrow_read_data_valid = wide_read_data_valid & rd_busy_value;
+
+      // Move on to the next wide beat after its last lane (or the last beat)
+      assign wide_read_data_ready = narrow_read_data_ready & rd_busy_value &
+                                    ((rd_lane_value == RATIO - 1) | (rd_left_value == 0));
+
+      // Write
+      wire wr_wide_req = (narrow_write_addr[WIDE_SIZE-1:0] == 0) &
+                         (narrow_write_len[LANE_BITS-1:0] == RATIO - 1);
+
+      wire wr_busy_value;
+      wire [31:0] wr_left_value;
+      REGISTER_R_CE #(.N(1), .INIT(0)) wr_busy_reg (
+        .clk(clk),
+        .rst(rst),
+        .d(narrow_write_request_fire),
+        .q(wr_busy_value),
+        .ce(narrow_write_request_fire | narrow_write_data_fire & (wr_left_value == 0))
+      );
+
+      wire wr_wide_value;
+      REGISTER_CE #(.N(1)) wr_wide_reg (
+        .clk(clk),
+        .d(wr_wide_req),
+        .q(wr_wide_value),
+        .ce(narrow_write_request_fire)
+      );
+
+      wire [LANE_BITS-1:0] wr_lane_value;
+      REGISTER_R_CE #(.N(LANE_BITS), .INIT(0)) wr_lane_reg (
+        .clk(clk),
+        .rst(rst | narrow_write_request_fire),
+        .d(wr_lane_value + 1),
+        .q(wr_lane_value),
+        .ce(narrow_write_data_fire)
+      );
+
+      REGISTER_R_CE #(.N(32), .INIT(0)) wr_left_reg (
+        .clk(clk),
+        .rst(rst),
+        .d(narrow_write_request_fire ? narrow_write_len : wr_left_value - 1),
+        .q(wr_left_value),
+        .ce(narrow_write_request_fire | narrow_write_data_fire)
+      );
+
+      // Lanes 0 .. RATIO-2 of the wide beat being packed
+      wire [WIDE_DWIDTH-NARROW_DWIDTH-1:0] wr_pack_value;
+      genvar i;
+      for (i = 0; i < RATIO - 1; i = i + 1) begin:PACK
+        REGISTER_CE #(.N(NARROW_DWIDTH)) wr_pack_reg (
+          .clk(clk),
+          .d(narrow_write_data),
+          .q(wr_pack_value[i * NARROW_DWIDTH +: NARROW_DWIDTH]),
+          .ce(narrow_write_data_fire & (wr_lane_value == i))
+        );
+      end
+
+      wire wr_last_lane = wr_lane_value == RATIO - 1;
+
+      assign wide_write_request_valid   = narrow_write_request_valid & ~wr_busy_value;
+      assign narrow_write_request_ready = wide_write_request_ready & ~wr_busy_value;
+      assign wide_write_addr  = narrow_write_addr;
+      assign wide_write_len   = wr_wide_req ? (narrow_write_len >> LANE_BITS) : narrow_write_len;
+      assign wide_write_size  = wr_wide_req ? WIDE_SIZE : NARROW_SIZE;
+      assign wide_write_burst = narrow_write_burst;
+
+      assign wide_write_data       = wr_wide_value ? {narrow_write_data, wr_pack_value} :
+                                                     {RATIO{narrow_write_data}};
+      assign wide_write_data_valid = narrow_write_data_valid & wr_busy_value &
+                                     (~wr_wide_value | wr_last_lane);
+
+      // The packed lanes are taken right away, the last one with the wide beat
+      assign narrow_write_data_ready = wr_busy_value &
+                                       ((wr_wide_value & ~wr_last_lane) | wide_write_data_ready);
+    end
+  endgenerate
+
+endmodule
@@ -0,0 +1,23 @@
+// One step of the (reflected) CRC-32 used by zlib/Ethernet, polynomial
+// 0x04c11db7 (0xedb88320 reflected), over a 32-bit word taken LSB first,
+// i.e. its 4 bytes in little-endian order. Starting from 0xffffffff and
+// inverting the final value gives the same result as zlib's crc32() over
+// the byte stream
+module crc32_word (
+  input  [31:0] crc_in,
+  input  [31:0] data,
+  output [31:0] crc_out
+);
+
+  reg [31:0] crc;
+  integer i;
+
+  always @(*) begin
+    crc = crc_in;
+    for (i = 0; i < 32; i = i + 1)
+      crc = (crc >> 1) ^ ((crc[0] ^ data[i]) ? 32'hedb88320 : 32'h0);
+  end
+
+  assign crc_out = crc;
+
+endmodule
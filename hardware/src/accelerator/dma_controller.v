@@ -1,6 +1,27 @@
 `include "axi_consts.vh"
 
 // DMA controller for sending data between RISC-V DMem and off-chip DDR
+// (or from DMem to DMem, or from DDR to IMem)
+//
+// Besides the single transfer set up by the dma_* registers, the controller
+// can walk a chain of descriptors in DMem (dma_desc_start). A descriptor is
+// DESC_WORDS consecutive DMem words:
+//   0: flags (bit 0: direction, same as dma_dir; bit 1: last descriptor;
+//             bit 2: DMem -> DMem copy, the direction is then ignored;
+//             bit 3: DDR -> IMem, the destination is an IMem word address)
+//   1: source address
+//   2: destination address
+//   3: row length (number of 32-bit data transfers)
+//   4: DMem word address of the next descriptor (ignored on the last one)
+//   5: number of rows (0 is the same as 1)
+//   6: source stride (from one row to the next)
+//   7: destination stride
+// Addresses and strides are in bytes on the DDR side, in words on the DMem
+// (and IMem) side. The transfers run back to back; dma_desc_count counts the
+// finished ones.
+// Every data word moved is also added to a running sum (dma_sum) and a
+// CRC32 (dma_crc, same as zlib's crc32() over the bytes), both restarted by
+// dma_start/dma_desc_start
 module dma_controller #(
   parameter AXI_AWIDTH  = 32,
   parameter AXI_DWIDTH  = 32,
@@ -33,6 +54,8 @@ module dma_controller #(
   output [AXI_DWIDTH-1:0] dma_write_data,
   output                  dma_write_data_valid,
   input                   dma_write_data_ready,
+  // every DDR write of this client acknowledged (see arbiter)
+  input                   dma_write_idle,
  
   // For interfacing with the IO controller logic in Riscv151
   input  dma_start,
@@ -42,13 +65,23 @@ module dma_controller #(
   input [31:0] dma_src_addr,
   input [31:0] dma_dst_addr,
   input [31:0] dma_len,
+  input  dma_desc_start,
+  input  [31:0] dma_desc_addr, // DMem word address of the first descriptor
+  output [31:0] dma_desc_count,
+  output [31:0] dma_sum,
+  output [31:0] dma_crc,
 
   // For interfacing with the DMem (port b) in Riscv151
   output [DMEM_AWIDTH-1:0]   dmem_addr,
   output [DMEM_DWIDTH-1:0]   dmem_din,
   input  [DMEM_DWIDTH-1:0]   dmem_dout,
   output [DMEM_DWIDTH/8-1:0] dmem_wbe,
-  output                     dmem_en
+  output                     dmem_en,
+
+  // For writing the IMem (port a) in Riscv151, on DDR -> IMem transfers
+  output [DMEM_AWIDTH-1:0]   imem_addr,
+  output [DMEM_DWIDTH-1:0]   imem_din,
+  output [DMEM_DWIDTH/8-1:0] imem_wbe
 );
 
   wire dma_write_request_fire = dma_write_request_valid & dma_write_request_ready;
@@ -56,21 +89,182 @@ module dma_controller #(
   wire dma_read_request_fire  = dma_read_request_valid  & dma_read_request_ready;
   wire dma_read_data_fire     = dma_read_data_valid     & dma_read_data_ready;
 
-  localparam STATE_IDLE          = 3'b000;
-  localparam STATE_WRITE_DDR_ST1 = 3'b001;
-  localparam STATE_WRITE_DDR_ST2 = 3'b010;
-  localparam STATE_READ_DDR      = 3'b011;
-  localparam STATE_DONE          = 3'b100;
+  localparam STATE_IDLE          = 4'b0000;
+  localparam STATE_WRITE_DDR_ST1 = 4'b0001;
+  localparam STATE_WRITE_DDR_ST2 = 4'b0010;
+  localparam STATE_READ_DDR      = 4'b0011;
+  localparam STATE_DONE          = 4'b0100;
+  localparam STATE_READ_DDR_REQ  = 4'b0101;
+  localparam STATE_DESC_FETCH    = 4'b0110;
+  localparam STATE_NEXT          = 4'b0111;
+  localparam STATE_COPY_RD       = 4'b1000;
+  localparam STATE_COPY_WR       = 4'b1001;
+  localparam STATE_ROW           = 4'b1010;
+
+  localparam DESC_WORDS = 8;
 
-  wire [2:0] state_value;
-  reg  [2:0] state_next;
-  REGISTER_R #(.N(3), .INIT(STATE_IDLE)) state_reg (
+  wire [3:0] state_value;
+  reg  [3:0] state_next;
+  REGISTER_R #(.N(4), .INIT(STATE_IDLE)) state_reg (
     .clk(clk),
     .rst(~resetn),
     .d(state_next),
     .q(state_value)
   );
 
+  wire idle       = state_value == STATE_IDLE;
+  wire read_req   = state_value == STATE_READ_DDR_REQ;
+  wire read_ddr   = state_value == STATE_READ_DDR;
+  wire write_ddr1 = state_value == STATE_WRITE_DDR_ST1;
+  wire write_ddr2 = state_value == STATE_WRITE_DDR_ST2;
+  wire desc_fetch = state_value == STATE_DESC_FETCH;
+  wire next_xfer  = state_value == STATE_NEXT;
+  wire copy_rd    = state_value == STATE_COPY_RD;
+  wire copy_wr    = state_value == STATE_COPY_WR;
+  wire row        = state_value == STATE_ROW;
+  wire done       = state_value == STATE_DONE;
+
+  wire start = idle & (dma_start | dma_desc_start);
+
+  // Walking a descriptor chain (as opposed to a single transfer)
+  wire chain_value;
+  REGISTER_R_CE #(.N(1), .INIT(0)) chain_reg (
+    .clk(clk),
+    .rst(~resetn),
+    .d(dma_desc_start),
+    .q(chain_value),
+    .ce(start)
+  );
+
+  // Descriptor fetch: one DMem word is requested per cycle, and its data
+  // comes back on the next one
+  wire [3:0] desc_idx_value, desc_idx_next;
+  wire desc_idx_rst;
+  REGISTER_R #(.N(4), .INIT(0)) desc_idx_reg (
+    .clk(clk),
+    .rst(desc_idx_rst),
+    .d(desc_idx_next),
+    .q(desc_idx_value)
+  );
+
+  wire [31:0] desc_addr_value, desc_addr_next;
+  wire desc_addr_ce;
+  REGISTER_CE #(.N(32)) desc_addr_reg (
+    .clk(clk),
+    .d(desc_addr_next),
+    .q(desc_addr_value),
+    .ce(desc_addr_ce)
+  );
+
+  // Parameters of the current transfer: loaded from the dma_* registers on
+  // a single transfer, or from the descriptor words
+  wire desc_word_ce0 = desc_fetch & (desc_idx_value == 1);
+  wire desc_word_ce1 = desc_fetch & (desc_idx_value == 2);
+  wire desc_word_ce2 = desc_fetch & (desc_idx_value == 3);
+  wire desc_word_ce3 = desc_fetch & (desc_idx_value == 4);
+  wire desc_word_ce4 = desc_fetch & (desc_idx_value == 5);
+  wire desc_word_ce5 = desc_fetch & (desc_idx_value == 6);
+  wire desc_word_ce6 = desc_fetch & (desc_idx_value == 7);
+  wire desc_word_ce7 = desc_fetch & (desc_idx_value == 8);
+
+  wire cur_dir, cur_last, cur_copy, cur_imem;
+  REGISTER_CE #(.N(4)) cur_flags_reg (
+    .clk(clk),
+    .d(idle ? {2'b00, 1'b1, dma_dir} : dmem_dout[3:0]),
+    .q({cur_imem, cur_copy, cur_last, cur_dir}),
+    .ce((idle & dma_start) | desc_word_ce0)
+  );
+
+  wire [31:0] cur_rows;
+  REGISTER_CE #(.N(32)) cur_rows_reg (
+    .clk(clk),
+    .d(idle ? 32'd1 : dmem_dout),
+    .q(cur_rows),
+    .ce((idle & dma_start) | desc_word_ce5)
+  );
+
+  wire [31:0] cur_src_stride;
+  REGISTER_CE #(.N(32)) cur_src_stride_reg (
+    .clk(clk),
+    .d(dmem_dout),
+    .q(cur_src_stride),
+    .ce(desc_word_ce6)
+  );
+
+  wire [31:0] cur_dst_stride;
+  REGISTER_CE #(.N(32)) cur_dst_stride_reg (
+    .clk(clk),
+    .d(dmem_dout),
+    .q(cur_dst_stride),
+    .ce(desc_word_ce7)
+  );
+
+  // rows of the current transfer done so far
+  wire [31:0] row_cnt_value, row_cnt_next;
+  wire row_cnt_ce, row_cnt_rst;
+  REGISTER_R_CE #(.N(32), .INIT(0)) row_cnt_reg (
+    .clk(clk),
+    .rst(row_cnt_rst),
+    .d(row_cnt_next),
+    .q(row_cnt_value),
+    .ce(row_cnt_ce)
+  );
+
+  // move on to the next row of a 2D transfer
+  wire row_advance = row & (row_cnt_value + 1 < cur_rows);
+
+  // source/destination address of the current row
+  wire [31:0] cur_src_addr;
+  REGISTER_CE #(.N(32)) cur_src_addr_reg (
+    .clk(clk),
+    .d(idle       ? dma_src_addr :
+       desc_fetch ? dmem_dout    : (cur_src_addr + cur_src_stride)),
+    .q(cur_src_addr),
+    .ce((idle & dma_start) | desc_word_ce1 | row_advance)
+  );
+
+  wire [31:0] cur_dst_addr;
+  REGISTER_CE #(.N(32)) cur_dst_addr_reg (
+    .clk(clk),
+    .d(idle       ? dma_dst_addr :
+       desc_fetch ? dmem_dout    : (cur_dst_addr + cur_dst_stride)),
+    .q(cur_dst_addr),
+    .ce((idle & dma_start) | desc_word_ce2 | row_advance)
+  );
+
+  // first state of a row, by transfer type
+  wire [3:0] row_first_state = cur_copy ? STATE_COPY_RD       :
+                               cur_imem ? STATE_READ_DDR_REQ  :
+                               cur_dir  ? STATE_WRITE_DDR_ST1 :
+                                          STATE_READ_DDR_REQ;
+
+  wire [31:0] cur_len;
+  REGISTER_CE #(.N(32)) cur_len_reg (
+    .clk(clk),
+    .d(idle ? dma_len : dmem_dout),
+    .q(cur_len),
+    .ce((idle & dma_start) | desc_word_ce3)
+  );
+
+  wire [31:0] desc_next_addr;
+  REGISTER_CE #(.N(32)) desc_next_addr_reg (
+    .clk(clk),
+    .d(dmem_dout),
+    .q(desc_next_addr),
+    .ce(desc_word_ce4)
+  );
+
+  // number of finished transfers since the last start
+  wire [31:0] desc_count_value, desc_count_next;
+  wire desc_count_ce, desc_count_rst;
+  REGISTER_R_CE #(.N(32), .INIT(0)) desc_count_reg (
+    .clk(clk),
+    .rst(desc_count_rst),
+    .d(desc_count_next),
+    .q(desc_count_value),
+    .ce(desc_count_ce)
+  );
+
   // count the number of data write transfers
   // use this to index to the DMem on a write transaction
   wire [31:0] write_cnt_next, write_cnt_value;
@@ -108,27 +302,35 @@ module dma_controller #(
     .ce(dma_done_ce)
   );
 
-  wire idle       = state_value == STATE_IDLE;
-  wire read_ddr   = state_value == STATE_READ_DDR;
-  wire write_ddr1 = state_value == STATE_WRITE_DDR_ST1;
-  wire write_ddr2 = state_value == STATE_WRITE_DDR_ST2;
-  wire done       = state_value == STATE_DONE;
-
   always @(*) begin
     state_next = state_value;
     case (state_value)
     STATE_IDLE: begin
-      if (dma_start) begin
+      if (dma_desc_start)
+        state_next = STATE_DESC_FETCH;
+      else if (dma_start) begin
         if (dma_dir == 0)
-          state_next = STATE_READ_DDR;
+          state_next = STATE_READ_DDR_REQ;
         else
           state_next = STATE_WRITE_DDR_ST1;
       end
     end
 
+    STATE_DESC_FETCH: begin
+      // the flags (hence the transfer type) arrived a few cycles ago
+      if (desc_idx_value == DESC_WORDS)
+        state_next = row_first_state;
+    end
+
+    // Request once, then take the data beats
+    STATE_READ_DDR_REQ: begin
+      if (dma_read_request_fire)
+        state_next = STATE_READ_DDR;
+    end
+
     STATE_READ_DDR: begin
-      if (read_cnt_value == dma_len)
-        state_next = STATE_DONE;
+      if (read_cnt_value == cur_len)
+        state_next = STATE_ROW;
     end
 
     STATE_WRITE_DDR_ST1: begin
@@ -139,12 +341,44 @@ module dma_controller #(
     end
 
     STATE_WRITE_DDR_ST2: begin
-      if (write_cnt_value == dma_len)
+      if (write_cnt_value == cur_len)
+        state_next = STATE_ROW;
+    end
+
+    // DMem -> DMem: DMem port b reads a word, then writes it back
+    STATE_COPY_RD: begin
+      if (cur_len == 0)
+        state_next = STATE_ROW;
+      else
+        state_next = STATE_COPY_WR;
+    end
+
+    STATE_COPY_WR: begin
+      if (read_cnt_value + 1 == cur_len)
+        state_next = STATE_ROW;
+      else
+        state_next = STATE_COPY_RD;
+    end
+
+    STATE_ROW: begin
+      if (row_advance)
+        state_next = row_first_state;
+      else
+        state_next = STATE_NEXT;
+    end
+
+    STATE_NEXT: begin
+      if (chain_value & ~cur_last)
+        state_next = STATE_DESC_FETCH;
+      else
         state_next = STATE_DONE;
     end
 
+    // The last write bursts may still be on their way to DDR: do not let
+    // the CPU (or a read) see the transfer as done before their responses
     STATE_DONE: begin
-      state_next = STATE_IDLE;
+      if (dma_write_idle)
+        state_next = STATE_IDLE;
     end
 
     endcase
@@ -154,46 +388,105 @@ module dma_controller #(
   assign dma_done = dma_done_value;
 
   assign dma_done_next = 1'b1;
-  assign dma_done_ce   = done;
-  assign dma_done_rst  = (idle & dma_start);
+  assign dma_done_ce   = done & dma_write_idle;
+  assign dma_done_rst  = start;
+
+  assign dma_desc_count = desc_count_value;
+
+  // Checksums of the data words, as they are written to their destination
+  wire xfer_word_valid = (read_ddr & dma_read_data_fire) | dma_write_data_fire | copy_wr;
+  wire [31:0] xfer_word = read_ddr ? dma_read_data[31:0] : dmem_dout;
+
+  wire [31:0] sum_value;
+  REGISTER_R_CE #(.N(32), .INIT(0)) sum_reg (
+    .clk(clk),
+    .rst(~resetn | start),
+    .d(sum_value + xfer_word),
+    .q(sum_value),
+    .ce(xfer_word_valid)
+  );
+
+  wire [31:0] crc_value, crc_next;
+  crc32_word crc_step (
+    .crc_in(crc_value),
+    .data(xfer_word),
+    .crc_out(crc_next)
+  );
+
+  REGISTER_R_CE #(.N(32), .INIT(32'hffff_ffff)) crc_reg (
+    .clk(clk),
+    .rst(~resetn | start),
+    .d(crc_next),
+    .q(crc_value),
+    .ce(xfer_word_valid)
+  );
+
+  assign dma_sum = sum_value;
+  assign dma_crc = ~crc_value;
+
+  assign desc_count_next = desc_count_value + 1;
+  assign desc_count_ce   = next_xfer;
+  assign desc_count_rst  = start;
+
+  assign row_cnt_next = row_cnt_value + 1;
+  assign row_cnt_ce   = row_advance;
+  assign row_cnt_rst  = ~resetn | idle | desc_fetch;
+
+  assign desc_idx_next = desc_idx_value + 1;
+  assign desc_idx_rst  = ~desc_fetch;
+
+  assign desc_addr_next = idle ? dma_desc_addr : desc_next_addr;
+  assign desc_addr_ce   = (idle & dma_desc_start) | next_xfer;
 
   assign write_cnt_next = write_cnt_value + 1;
   assign write_cnt_ce   = (write_ddr1 && dma_write_request_fire) | dma_write_data_fire;
-  assign write_cnt_rst  = idle;
+  assign write_cnt_rst  = idle | row;
 
   assign read_cnt_next = read_cnt_value + 1;
-  assign read_cnt_ce   = dma_read_data_fire;
-  assign read_cnt_rst  = idle;
+  assign read_cnt_ce   = dma_read_data_fire | copy_wr;
+  assign read_cnt_rst  = idle | row;
 
   // setup DMA write request address and data
-  // use burst mode INCR with a length of dma_len and 4 bytes per data beat
+  // use burst mode INCR with the transfer length and 4 bytes per data beat
   assign dma_write_request_valid = write_ddr1;
-  assign dma_write_addr          = dma_dst_addr;
-  assign dma_write_len           = dma_len - 1;
+  assign dma_write_addr          = cur_dst_addr;
+  assign dma_write_len           = cur_len - 1;
   assign dma_write_burst         = `BURST_INCR;
   assign dma_write_size          = 3'd2; // 2^2 bytes
   assign dma_write_data_valid    = write_ddr2;
   assign dma_write_data          = dmem_dout;
 
   // setup DMA read request address and read response data
-  // use burst mode INCR with a length of dma_len and 4 bytes per data beat
-  assign dma_read_request_valid = read_ddr;
-  assign dma_read_addr          = dma_src_addr;
-  assign dma_read_len           = dma_len - 1;
+  // use burst mode INCR with the transfer length and 4 bytes per data beat
+  // (in a chain, a read waits for the writes of the earlier transfers,
+  // which may cover the same DDR words)
+  assign dma_read_request_valid = read_req & dma_write_idle;
+  assign dma_read_addr          = cur_src_addr;
+  assign dma_read_len           = cur_len - 1;
   assign dma_read_burst         = `BURST_INCR;
   assign dma_read_size          = 3'd2; // 2^2 bytes
   assign dma_read_data_ready    = read_ddr;
 
   // setup DMem access
   // write to DMem on a read from DDR, and read from DMem on a write from DDR
-  assign dmem_addr = read_ddr ? (dma_dst_addr + read_cnt_value) :
-                                (dma_src_addr + write_cnt_value);
-  assign dmem_wbe  = (read_ddr & dma_read_data_fire) ? 4'b1111 : 4'b0;
-  assign dmem_din  = dma_read_data;
+  // (or read the descriptor words, or copy within DMem)
+  assign dmem_addr = desc_fetch             ? (desc_addr_value + desc_idx_value) :
+                     (read_ddr | copy_wr)   ? (cur_dst_addr + read_cnt_value) :
+                     copy_rd                ? (cur_src_addr + read_cnt_value) :
+                                              (cur_src_addr + write_cnt_value);
+  assign dmem_wbe  = ((read_ddr & dma_read_data_fire & ~cur_imem) | copy_wr) ? 4'b1111 : 4'b0;
+  assign dmem_din  = copy_wr ? dmem_dout : dma_read_data;
+
+  // DDR -> IMem: the read data goes to IMem instead
+  assign imem_addr = cur_dst_addr + read_cnt_value;
+  assign imem_din  = dma_read_data;
+  assign imem_wbe  = (read_ddr & dma_read_data_fire & cur_imem) ? 4'b1111 : 4'b0;
 
   // use the enable pin of DMem to make sure that the DMem dout
   // won't get updated when there is no handshake on write/read data
   assign dmem_en   = write_ddr1 |
                      dma_write_data_fire |
-                     dma_read_data_fire;
+                     (dma_read_data_fire & ~cur_imem) |
+                     (copy_rd & (cur_len != 0)) | copy_wr |
+                     (desc_fetch & (desc_idx_value < DESC_WORDS));
 endmodule
@@ -0,0 +1,68 @@
+
+module dmem_arbiter #(
+  parameter DMEM_AWIDTH = 14,
+  parameter DMEM_DWIDTH = 32
+) (
+  input clk,
+  input rst,
+
+  // Riscv151 DMem port b
+  output [DMEM_AWIDTH-1:0]   dmem_addr,
+  output [DMEM_DWIDTH-1:0]   dmem_din,
+  input  [DMEM_DWIDTH-1:0]   dmem_dout,
+  output [DMEM_DWIDTH/8-1:0] dmem_wbe,
+  output                     dmem_en,
+
+  // DMA Controller interface
+  input  [DMEM_AWIDTH-1:0]   dma_dmem_addr,
+  input  [DMEM_DWIDTH-1:0]   dma_dmem_din,
+  output [DMEM_DWIDTH-1:0]   dma_dmem_dout,
+  input  [DMEM_DWIDTH/8-1:0] dma_dmem_wbe,
+  input                      dma_dmem_en,
+  input                      dma_idle,
+
+  // Accelerator interface
+  // A request with a zero wbe is a read, else a write. Each one is answered
+  // by one dout_valid pulse: the read data, or the write is done
+  input                      xcel_dmem_request_valid,
+  output                     xcel_dmem_request_ready,
+  input  [DMEM_AWIDTH-1:0]   xcel_dmem_addr,
+  input  [DMEM_DWIDTH-1:0]   xcel_dmem_din,
+  input  [DMEM_DWIDTH/8-1:0] xcel_dmem_wbe,
+  output [DMEM_DWIDTH-1:0]   xcel_dmem_dout,
+  output                     xcel_dmem_dout_valid
+);
+
+  // The DMA owns the port for a whole transfer: it relies on the DMem read
+  // data staying put while it waits on the DDR write handshake, so the
+  // accelerator is only let in while the DMA is idle. The DMA never enables
+  // the port in its idle state, and a read issued by the accelerator in the
+  // last idle cycle is still held on dout during the first DMA cycle
+  wire sel_xcel = dma_idle;
+
+  wire xcel_dmem_request_fire = xcel_dmem_request_valid & xcel_dmem_request_ready;
+
+  // The read data shows up one cycle after the request. Writes are
+  // acknowledged the same way, so the accelerator never reports an OFM row
+  // done while its last words are still on their way to DMem
+  wire xcel_request_pending;
+  REGISTER_R #(.N(1), .INIT(0)) xcel_request_pending_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(xcel_dmem_request_fire),
+    .q(xcel_request_pending)
+  );
+
+  assign xcel_dmem_request_ready = sel_xcel;
+
+  assign dmem_addr = sel_xcel ? xcel_dmem_addr         : dma_dmem_addr;
+  assign dmem_din  = sel_xcel ? xcel_dmem_din          : dma_dmem_din;
+  assign dmem_wbe  = sel_xcel ? xcel_dmem_wbe          : dma_dmem_wbe;
+  assign dmem_en   = sel_xcel ? xcel_dmem_request_fire : dma_dmem_en;
+
+  assign dma_dmem_dout  = dmem_dout;
+  assign xcel_dmem_dout = dmem_dout;
+
+  assign xcel_dmem_dout_valid = xcel_request_pending;
+
+endmodule
@@ -0,0 +1,29 @@
+
+// Two signed int8 x int8 multiplies that share one operand, packed into a
+// single DSP48E1 multiply (25x18):
+//   wt_pk = wt1 * 2^16 + wt0                (fits the 25-bit A port)
+//   prod  = ifm * wt_pk = ifm * wt1 * 2^16 + ifm * wt0
+// The low half is ifm * wt0 exactly (|ifm * wt0| <= 2^14 fits 16 bits).
+// The high half comes out one less than ifm * wt1 whenever the low half is
+// negative (the sign extension of the low product borrows from it), so its
+// sign bit is added back
+module mul_int8x2 (
+  input  [7:0]  ifm,
+  input  [7:0]  wt0,
+  input  [7:0]  wt1,
+  output [15:0] prod0, // ifm * wt0
+  output [15:0] prod1  // ifm * wt1
+);
+
+  wire signed [17:0] ifm_s = $signed(ifm);
+  wire signed [24:0] wt0_s = $signed(wt0);
+  wire signed [24:0] wt1_s = $signed(wt1);
+
+  wire signed [24:0] wt_pk = (wt1_s <<< 16) + wt0_s;
+
+  (* use_dsp48 = "yes" *) wire signed [42:0] prod = ifm_s * wt_pk;
+
+  assign prod0 = prod[15:0];
+  assign prod1 = prod[31:16] + {15'b0, prod[15]};
+
+endmodule
@@ -0,0 +1,57 @@
+// Round-robin arbiter for NUM_REQ (>= 2) requesters
+// grant is one-hot (or zero when nobody requests). The requester right after
+// the last granted one has the highest priority. A grant is held until
+// advance (e.g. the request handshake of the granted requester), so the
+// winner keeps the downstream valid/payload stable while it waits on ready
+module rr_arbiter #(
+  parameter NUM_REQ = 2
+) (
+  input clk,
+  input rst,
+
+  input  [NUM_REQ-1:0] req,
+  input                advance,
+  output [NUM_REQ-1:0] grant
+);
+
+  // One-hot, highest priority requester
+  wire [NUM_REQ-1:0] prio_value, prio_next;
+  wire prio_ce;
+  REGISTER_R_CE #(.N(NUM_REQ), .INIT(1)) prio_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(prio_next),
+    .q(prio_value),
+    .ce(prio_ce)
+  );
+
+  // Find the first requester at or after prio, wrapping around: with the
+  // requests repeated twice, subtracting prio clears every bit from prio up
+  // to (and sets) the first request bit at or after it
+  wire [2*NUM_REQ-1:0] req_twice   = {req, req};
+  wire [2*NUM_REQ-1:0] grant_twice = req_twice & ~(req_twice - {{NUM_REQ{1'b0}}, prio_value});
+
+  wire [NUM_REQ-1:0] rr_grant = grant_twice[NUM_REQ-1:0] |
+                                grant_twice[2*NUM_REQ-1:NUM_REQ];
+
+  wire lock_value;
+  REGISTER_R #(.N(1), .INIT(0)) lock_reg (
+    .clk(clk),
+    .rst(rst),
+    .d((|grant) & ~advance),
+    .q(lock_value)
+  );
+
+  wire [NUM_REQ-1:0] locked_grant;
+  REGISTER #(.N(NUM_REQ)) locked_grant_reg (
+    .clk(clk),
+    .d(grant),
+    .q(locked_grant)
+  );
+
+  assign grant = lock_value ? locked_grant : rr_grant;
+
+  assign prio_next = {grant[NUM_REQ-2:0], grant[NUM_REQ-1]};
+  assign prio_ce   = advance & (|grant);
+
+endmodule
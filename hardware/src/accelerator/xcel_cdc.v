@@ -0,0 +1,392 @@
+
+// Clock-domain crossing between the system side (CPU, DMA, arbiters,
+// AXI adapter) and an accelerator running on its own clock.
+// Everything goes through ASYNC_FIFOs:
+//   - MMIO command (start + layer configuration): sys -> xcel
+//   - MMIO status (idle, done, progress): xcel -> sys
+//   - read request, write request, write data: xcel -> sys
+//   - read data: sys -> xcel
+//   - DMem request: xcel -> sys, DMem read data / write ack: sys -> xcel
+module xcel_cdc #(
+  parameter AXI_AWIDTH  = 32,
+  parameter AXI_DWIDTH  = 32,
+  parameter DMEM_AWIDTH = 14,
+  parameter DMEM_DWIDTH = 32
+) (
+  input sys_clk,
+  input sys_rst,
+  input xcel_clk,
+  input xcel_rst,
+
+  // System side: Riscv151 IO
+  input         sys_xcel_start,
+  output        sys_xcel_done,
+  output        sys_xcel_idle,
+  output [31:0] sys_xcel_progress,
+
+  input [31:0]  sys_ifm_ddr_addr,
+  input [31:0]  sys_wt_ddr_addr,
+  input [31:0]  sys_ofm_ddr_addr,
+  input [31:0]  sys_ifm_dim,
+  input [31:0]  sys_ifm_depth,
+  input [31:0]  sys_ofm_dim,
+  input [31:0]  sys_ofm_depth,
+
+  // System side: arbiter (accelerator interface)
+  output                  sys_read_request_valid,
+  input                   sys_read_request_ready,
+  output [AXI_AWIDTH-1:0] sys_read_addr,
+  output [31:0]           sys_read_len,
+  output [2:0]            sys_read_size,
+  output [1:0]            sys_read_burst,
+  input  [AXI_DWIDTH-1:0] sys_read_data,
+  input                   sys_read_data_valid,
+  output                  sys_read_data_ready,
+
+  output                  sys_write_request_valid,
+  input                   sys_write_request_ready,
+  output [AXI_AWIDTH-1:0] sys_write_addr,
+  output [31:0]           sys_write_len,
+  output [2:0]            sys_write_size,
+  output [1:0]            sys_write_burst,
+  output [AXI_DWIDTH-1:0] sys_write_data,
+  output                  sys_write_data_valid,
+  input                   sys_write_data_ready,
+  // every DDR write of the accelerator acknowledged (see arbiter)
+  input                   sys_write_idle,
+
+  // System side: DMem arbiter (accelerator interface)
+  output                     sys_dmem_request_valid,
+  input                      sys_dmem_request_ready,
+  output [DMEM_AWIDTH-1:0]   sys_dmem_addr,
+  output [DMEM_DWIDTH-1:0]   sys_dmem_din,
+  output [DMEM_DWIDTH/8-1:0] sys_dmem_wbe,
+  input  [DMEM_DWIDTH-1:0]   sys_dmem_dout,
+  input                      sys_dmem_dout_valid,
+
+  // Accelerator side
+  output        xcel_start,
+  input         xcel_done,
+  input         xcel_idle,
+  input  [31:0] xcel_progress,
+
+  output [31:0] xcel_ifm_ddr_addr,
+  output [31:0] xcel_wt_ddr_addr,
+  output [31:0] xcel_ofm_ddr_addr,
+  output [31:0] xcel_ifm_dim,
+  output [31:0] xcel_ifm_depth,
+  output [31:0] xcel_ofm_dim,
+  output [31:0] xcel_ofm_depth,
+
+  input                   xcel_read_request_valid,
+  output                  xcel_read_request_ready,
+  input  [AXI_AWIDTH-1:0] xcel_read_addr,
+  input  [31:0]           xcel_read_len,
+  input  [2:0]            xcel_read_size,
+  input  [1:0]            xcel_read_burst,
+  output [AXI_DWIDTH-1:0] xcel_read_data,
+  output                  xcel_read_data_valid,
+  input                   xcel_read_data_ready,
+
+  input                   xcel_write_request_valid,
+  output                  xcel_write_request_ready,
+  input  [AXI_AWIDTH-1:0] xcel_write_addr,
+  input  [31:0]           xcel_write_len,
+  input  [2:0]            xcel_write_size,
+  input  [1:0]            xcel_write_burst,
+  input  [AXI_DWIDTH-1:0] xcel_write_data,
+  input                   xcel_write_data_valid,
+  output                  xcel_write_data_ready,
+
+  input                      xcel_dmem_request_valid,
+  output                     xcel_dmem_request_ready,
+  input  [DMEM_AWIDTH-1:0]   xcel_dmem_addr,
+  input  [DMEM_DWIDTH-1:0]   xcel_dmem_din,
+  input  [DMEM_DWIDTH/8-1:0] xcel_dmem_wbe,
+  output [DMEM_DWIDTH-1:0]   xcel_dmem_dout,
+  output                     xcel_dmem_dout_valid
+);
+
+  // Wide enough to tell apart every start that can be in flight: the 4
+  // queued in cmd_fifo, the one being launched and the one running
+  localparam SEQ_WIDTH    = 3;
+  localparam CMD_WIDTH    = SEQ_WIDTH + 7 * 32;
+  localparam STATUS_WIDTH = SEQ_WIDTH + 32 + 2;
+  localparam REQ_WIDTH    = AXI_AWIDTH + 32 + 3 + 2;
+  localparam DMEM_WIDTH   = DMEM_AWIDTH + DMEM_DWIDTH + DMEM_DWIDTH / 8;
+
+  // -------------------------------------------------------------------------
+  // MMIO command: every start carries a snapshot of the layer configuration
+  // and a sequence number. The accelerator echoes the sequence number of the
+  // run it last started in its status, so the system side can tell a stale
+  // status (from an earlier run, or still in flight) from the one of the
+  // latest start
+  // -------------------------------------------------------------------------
+  wire cmd_enq_ready, cmd_deq_valid, cmd_deq_ready;
+  wire [CMD_WIDTH-1:0] cmd_deq_data;
+
+  wire [SEQ_WIDTH-1:0] cmd_seq_value;
+  wire [SEQ_WIDTH-1:0] cmd_seq_next = cmd_seq_value + 1;
+  wire cmd_enq_fire = sys_xcel_start & cmd_enq_ready;
+
+  REGISTER_R_CE #(.N(SEQ_WIDTH), .INIT(0)) cmd_seq_reg (
+    .clk(sys_clk),
+    .rst(sys_rst),
+    .d(cmd_seq_next),
+    .q(cmd_seq_value),
+    .ce(cmd_enq_fire)
+  );
+
+  ASYNC_FIFO #(
+    .WIDTH(CMD_WIDTH),
+    .LOGDEPTH(2)
+  ) cmd_fifo (
+    .enq_clk(sys_clk),
+    .enq_rst(sys_rst),
+    .enq_valid(sys_xcel_start),
+    .enq_data({cmd_seq_next,
+               sys_ifm_ddr_addr, sys_wt_ddr_addr, sys_ofm_ddr_addr,
+               sys_ifm_dim, sys_ifm_depth, sys_ofm_dim, sys_ofm_depth}),
+    .enq_ready(cmd_enq_ready),
+
+    .deq_clk(xcel_clk),
+    .deq_rst(xcel_rst),
+    .deq_valid(cmd_deq_valid),
+    .deq_data(cmd_deq_data),
+    .deq_ready(cmd_deq_ready)
+  );
+
+  // Hold the configuration of the current run in the accelerator domain
+  wire cmd_deq_fire = cmd_deq_valid & cmd_deq_ready;
+  wire [CMD_WIDTH-SEQ_WIDTH-1:0] cfg_value;
+
+  REGISTER_CE #(.N(CMD_WIDTH - SEQ_WIDTH)) cfg_reg (
+    .clk(xcel_clk),
+    .d(cmd_deq_data[CMD_WIDTH-SEQ_WIDTH-1:0]),
+    .q(cfg_value),
+    .ce(cmd_deq_fire)
+  );
+
+  assign {xcel_ifm_ddr_addr, xcel_wt_ddr_addr, xcel_ofm_ddr_addr,
+          xcel_ifm_dim, xcel_ifm_depth, xcel_ofm_dim, xcel_ofm_depth} = cfg_value;
+
+  wire [SEQ_WIDTH-1:0] cmd_next_seq_value;
+  REGISTER_CE #(.N(SEQ_WIDTH)) cmd_next_seq_reg (
+    .clk(xcel_clk),
+    .d(cmd_deq_data[CMD_WIDTH-1 -: SEQ_WIDTH]),
+    .q(cmd_next_seq_value),
+    .ce(cmd_deq_fire)
+  );
+
+  // Start the accelerator a few cycles after the configuration is captured
+  // so that the layer sizes xcel_naive derives from it have settled
+  wire [2:0] launch_value;
+  REGISTER_R #(.N(3), .INIT(0)) launch_reg (
+    .clk(xcel_clk),
+    .rst(xcel_rst),
+    .d({launch_value[1:0], cmd_deq_fire}),
+    .q(launch_value)
+  );
+
+  wire launch_pending = |launch_value;
+
+  assign xcel_start = launch_value[2];
+
+  // Only take the next command once the accelerator is idle, so that a start
+  // issued while the accelerator is busy runs after the current one
+  assign cmd_deq_ready = xcel_idle & ~launch_pending;
+
+  // The sequence number of the run that the status refers to. It changes
+  // together with the accelerator's done/progress reset on start
+  wire [SEQ_WIDTH-1:0] run_seq_value;
+  REGISTER_R_CE #(.N(SEQ_WIDTH), .INIT(0)) run_seq_reg (
+    .clk(xcel_clk),
+    .rst(xcel_rst),
+    .d(cmd_next_seq_value),
+    .q(run_seq_value),
+    .ce(xcel_start)
+  );
+
+  // -------------------------------------------------------------------------
+  // MMIO status: send a new snapshot whenever the status changes
+  // -------------------------------------------------------------------------
+  localparam [STATUS_WIDTH-1:0] STATUS_INIT = {{SEQ_WIDTH{1'b0}}, 32'd0, 1'b0, 1'b1};
+
+  wire [STATUS_WIDTH-1:0] status_now = {run_seq_value, xcel_progress, xcel_done,
+                                        xcel_idle & ~launch_pending};
+  wire [STATUS_WIDTH-1:0] status_sent_value;
+  wire status_enq_ready;
+  wire status_enq_valid = status_now != status_sent_value;
+
+  REGISTER_R_CE #(.N(STATUS_WIDTH), .INIT(STATUS_INIT)) status_sent_reg (
+    .clk(xcel_clk),
+    .rst(xcel_rst),
+    .d(status_now),
+    .q(status_sent_value),
+    .ce(status_enq_valid & status_enq_ready)
+  );
+
+  wire status_deq_valid;
+  wire [STATUS_WIDTH-1:0] status_deq_data;
+
+  ASYNC_FIFO #(
+    .WIDTH(STATUS_WIDTH),
+    .LOGDEPTH(2)
+  ) status_fifo (
+    .enq_clk(xcel_clk),
+    .enq_rst(xcel_rst),
+    .enq_valid(status_enq_valid),
+    .enq_data(status_now),
+    .enq_ready(status_enq_ready),
+
+    .deq_clk(sys_clk),
+    .deq_rst(sys_rst),
+    .deq_valid(status_deq_valid),
+    .deq_data(status_deq_data),
+    .deq_ready(1'b1)
+  );
+
+  wire [STATUS_WIDTH-1:0] status_value;
+  REGISTER_R_CE #(.N(STATUS_WIDTH), .INIT(STATUS_INIT)) status_reg (
+    .clk(sys_clk),
+    .rst(sys_rst),
+    .d(status_deq_data),
+    .q(status_value),
+    .ce(status_deq_valid)
+  );
+
+  wire [SEQ_WIDTH-1:0] status_seq = status_value[STATUS_WIDTH-1 -: SEQ_WIDTH];
+  wire [31:0] status_progress = status_value[33:2];
+  wire        status_done     = status_value[1];
+  wire        status_idle     = status_value[0];
+
+  // Until the status of the latest start comes back, report busy (even with
+  // earlier starts still queued, the sequence numbers do not wrap around)
+  wire status_current = status_seq == cmd_seq_value;
+
+  // When the OFMs go to DDR, the last row is only written once its write
+  // responses are in, not when its data leaves the accelerator: hold
+  // done/idle while writes are still in the FIFOs below or in flight past
+  // the arbiter. The done status is sent after the last write data, so it
+  // cannot get here ahead of it
+  wire sys_writes_done = sys_write_idle & ~sys_write_request_valid &
+                         ~sys_write_data_valid;
+
+  assign sys_xcel_done     = status_current & status_done & sys_writes_done;
+  assign sys_xcel_idle     = status_current & status_idle & sys_writes_done;
+  assign sys_xcel_progress = status_current ? status_progress : 32'd0;
+
+  // -------------------------------------------------------------------------
+  // Read request and read data
+  // -------------------------------------------------------------------------
+  ASYNC_FIFO #(
+    .WIDTH(REQ_WIDTH),
+    .LOGDEPTH(2)
+  ) read_request_fifo (
+    .enq_clk(xcel_clk),
+    .enq_rst(xcel_rst),
+    .enq_valid(xcel_read_request_valid),
+    .enq_data({xcel_read_addr, xcel_read_len, xcel_read_size, xcel_read_burst}),
+    .enq_ready(xcel_read_request_ready),
+
+    .deq_clk(sys_clk),
+    .deq_rst(sys_rst),
+    .deq_valid(sys_read_request_valid),
+    .deq_data({sys_read_addr, sys_read_len, sys_read_size, sys_read_burst}),
+    .deq_ready(sys_read_request_ready)
+  );
+
+  ASYNC_FIFO #(
+    .WIDTH(AXI_DWIDTH),
+    .LOGDEPTH(2)
+  ) read_data_fifo (
+    .enq_clk(sys_clk),
+    .enq_rst(sys_rst),
+    .enq_valid(sys_read_data_valid),
+    .enq_data(sys_read_data),
+    .enq_ready(sys_read_data_ready),
+
+    .deq_clk(xcel_clk),
+    .deq_rst(xcel_rst),
+    .deq_valid(xcel_read_data_valid),
+    .deq_data(xcel_read_data),
+    .deq_ready(xcel_read_data_ready)
+  );
+
+  // -------------------------------------------------------------------------
+  // Write request and write data
+  // -------------------------------------------------------------------------
+  ASYNC_FIFO #(
+    .WIDTH(REQ_WIDTH),
+    .LOGDEPTH(2)
+  ) write_request_fifo (
+    .enq_clk(xcel_clk),
+    .enq_rst(xcel_rst),
+    .enq_valid(xcel_write_request_valid),
+    .enq_data({xcel_write_addr, xcel_write_len, xcel_write_size, xcel_write_burst}),
+    .enq_ready(xcel_write_request_ready),
+
+    .deq_clk(sys_clk),
+    .deq_rst(sys_rst),
+    .deq_valid(sys_write_request_valid),
+    .deq_data({sys_write_addr, sys_write_len, sys_write_size, sys_write_burst}),
+    .deq_ready(sys_write_request_ready)
+  );
+
+  ASYNC_FIFO #(
+    .WIDTH(AXI_DWIDTH),
+    .LOGDEPTH(2)
+  ) write_data_fifo (
+    .enq_clk(xcel_clk),
+    .enq_rst(xcel_rst),
+    .enq_valid(xcel_write_data_valid),
+    .enq_data(xcel_write_data),
+    .enq_ready(xcel_write_data_ready),
+
+    .deq_clk(sys_clk),
+    .deq_rst(sys_rst),
+    .deq_valid(sys_write_data_valid),
+    .deq_data(sys_write_data),
+    .deq_ready(sys_write_data_ready)
+  );
+
+  // -------------------------------------------------------------------------
+  // DMem request and read data (or write acknowledge)
+  // At most one request is in flight (the memif waits for its dout_valid),
+  // so the read data FIFO always has room
+  // -------------------------------------------------------------------------
+  ASYNC_FIFO #(
+    .WIDTH(DMEM_WIDTH),
+    .LOGDEPTH(2)
+  ) dmem_request_fifo (
+    .enq_clk(xcel_clk),
+    .enq_rst(xcel_rst),
+    .enq_valid(xcel_dmem_request_valid),
+    .enq_data({xcel_dmem_addr, xcel_dmem_din, xcel_dmem_wbe}),
+    .enq_ready(xcel_dmem_request_ready),
+
+    .deq_clk(sys_clk),
+    .deq_rst(sys_rst),
+    .deq_valid(sys_dmem_request_valid),
+    .deq_data({sys_dmem_addr, sys_dmem_din, sys_dmem_wbe}),
+    .deq_ready(sys_dmem_request_ready)
+  );
+
+  ASYNC_FIFO #(
+    .WIDTH(DMEM_DWIDTH),
+    .LOGDEPTH(2)
+  ) dmem_read_data_fifo (
+    .enq_clk(sys_clk),
+    .enq_rst(sys_rst),
+    .enq_valid(sys_dmem_dout_valid),
+    .enq_data(sys_dmem_dout),
+    .enq_ready(),
+
+    .deq_clk(xcel_clk),
+    .deq_rst(xcel_rst),
+    .deq_valid(xcel_dmem_dout_valid),
+    .deq_data(xcel_dmem_dout),
+    .deq_ready(1'b1)
+  );
+
+endmodule
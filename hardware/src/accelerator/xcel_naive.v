@@ -7,9 +7,11 @@
 // software program runnning on the CPU via Memory-mapped IO addresses
 // (dynamically configured)
 module xcel_naive #(
-  parameter AXI_AWIDTH = 32,
-  parameter AXI_DWIDTH = 32,
-  parameter WT_DIM     = 5
+  parameter AXI_AWIDTH  = 32,
+  parameter AXI_DWIDTH  = 32,
+  parameter DMEM_AWIDTH = 14,
+  parameter DMEM_DWIDTH = 32,
+  parameter WT_DIM      = 5
 ) (
   input clk,
   input rst,
@@ -38,11 +40,23 @@ module xcel_naive #(
   output                  xcel_write_data_valid,
   input                   xcel_write_data_ready,
 
+  // For interfacing with the RISC-V DMem (through the DMem arbiter)
+  output                     xcel_dmem_request_valid,
+  input                      xcel_dmem_request_ready,
+  output [DMEM_AWIDTH-1:0]   xcel_dmem_addr,
+  output [DMEM_DWIDTH-1:0]   xcel_dmem_din,
+  output [DMEM_DWIDTH/8-1:0] xcel_dmem_wbe,
+  input  [DMEM_DWIDTH-1:0]   xcel_dmem_dout,
+  input                      xcel_dmem_dout_valid,
+
   // For interfacing with IO controller logic in Riscv151
   input  xcel_start,
   output xcel_done,
   output xcel_idle,
+  output [31:0] xcel_progress, // number of finished OFM rows
 
+  // Bit 31 set: the operand lives in DMem instead of DDR
+  // Bit 30 set (WT only): the weights are packed int4
   input [31:0] ifm_ddr_addr, // IFM address in DDR
   input [31:0] wt_ddr_addr,  // WT address in DDR
   input [31:0] ofm_ddr_addr, // OFM address in DDR
@@ -162,6 +176,7 @@ module xcel_naive #(
     .compute_start(compute_start),     // input
     .compute_idle(compute_idle),       // output
     .compute_done(compute_done),       // output
+    .compute_progress(xcel_progress),  // output
 
     // parameters
     .ifm_dim(ifm_dim),
@@ -178,10 +193,12 @@ module xcel_naive #(
     .ofm_len(ofm_len)
   );
 
-  // Memory Interface unit: handles DDR read and write transactions
+  // Memory Interface unit: handles DDR and DMem read and write transactions
   xcel_naive_memif #(
     .AXI_AWIDTH(AXI_AWIDTH),
     .AXI_DWIDTH(AXI_DWIDTH),
+    .DMEM_AWIDTH(DMEM_AWIDTH),
+    .DMEM_DWIDTH(DMEM_DWIDTH),
     .WT_DIM(WT_DIM)
   ) memif_unit (
     .clk(clk),
@@ -209,11 +226,22 @@ module xcel_naive #(
     .xcel_write_data_valid(xcel_write_data_valid),       // output
     .xcel_write_data_ready(xcel_write_data_ready),       // input
 
+    // DMem interface (<-> DMem arbiter)
+    .xcel_dmem_request_valid(xcel_dmem_request_valid),   // output
+    .xcel_dmem_request_ready(xcel_dmem_request_ready),   // input
+    .xcel_dmem_addr(xcel_dmem_addr),                     // output
+    .xcel_dmem_din(xcel_dmem_din),                       // output
+    .xcel_dmem_wbe(xcel_dmem_wbe),                       // output
+    .xcel_dmem_dout(xcel_dmem_dout),                     // input
+    .xcel_dmem_dout_valid(xcel_dmem_dout_valid),         // input
+
     // DDR addresses of IFM, WT, OFM
     .ifm_ddr_addr(ifm_ddr_addr),       // input
     .wt_ddr_addr(wt_ddr_addr),         // input
     .ofm_ddr_addr(ofm_ddr_addr),       // input
 
+    .wt_cache_flush(xcel_start),       // input
+
     // IFM read (response to the compute_unit)
     .ifm_addr(ifm_addr),               // input
     .ifm_dout(ifm_dout),               // output
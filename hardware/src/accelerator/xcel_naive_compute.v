@@ -37,6 +37,7 @@ module xcel_naive_compute #(
   input  compute_start,
   output compute_idle,
   output compute_done,
+  output [31:0] compute_progress,
 
   // parameters
   input [31:0] ifm_dim,
@@ -91,6 +92,7 @@ module xcel_naive_compute #(
   );
 
   // output channel count: 0 -> ofm_depth - 1
+  // (steps by 2, each pass computes the channels oc and oc + 1)
   wire [31:0] oc_cnt_next, oc_cnt_value;
   wire oc_cnt_ce, oc_cnt_rst;
 
@@ -265,6 +267,42 @@ module xcel_naive_compute #(
     .ce(ofm_data_ce)
   );
 
+  // For holding OFM read data of the second output channel
+  wire [31:0] ofm1_data_next, ofm1_data_value;
+  wire ofm1_data_ce, ofm1_data_rst;
+
+  REGISTER_R_CE #(.N(32), .INIT(0)) ofm1_data_reg (
+    .clk(clk),
+    .rst(ofm1_data_rst),
+    .d(ofm1_data_next),
+    .q(ofm1_data_value),
+    .ce(ofm1_data_ce)
+  );
+
+  // Which of the two output channels is being fetched (weights)
+  wire wt_lane_next, wt_lane_value;
+  wire wt_lane_ce, wt_lane_rst;
+
+  REGISTER_R_CE #(.N(1), .INIT(0)) wt_lane_reg (
+    .clk(clk),
+    .rst(wt_lane_rst),
+    .d(wt_lane_next),
+    .q(wt_lane_value),
+    .ce(wt_lane_ce)
+  );
+
+  // Which of the two output channels is being read/written (OFM)
+  wire ofm_lane_next, ofm_lane_value;
+  wire ofm_lane_ce, ofm_lane_rst;
+
+  REGISTER_R_CE #(.N(1), .INIT(0)) ofm_lane_reg (
+    .clk(clk),
+    .rst(ofm_lane_rst),
+    .d(ofm_lane_next),
+    .q(ofm_lane_value),
+    .ce(ofm_lane_ce)
+  );
+
   // keep the state of the done signal
   // It needs to stay HIGH after the compute is done
   // and restart to 0 once the compute starts again
@@ -278,6 +316,19 @@ module xcel_naive_compute #(
     .ce(compute_done_ce)
   );
 
+  // Number of OFM rows (flattened across output channels) whose final value
+  // has been written back. Rows finish in order, so row r of the OFM is
+  // complete once progress > r. Cleared when a new computation starts
+  wire [31:0] progress_next, progress_value;
+  wire progress_ce, progress_rst;
+  REGISTER_R_CE #(.N(32), .INIT(0)) progress_reg (
+    .clk(clk),
+    .rst(progress_rst),
+    .d(progress_next),
+    .q(progress_value),
+    .ce(progress_ce)
+  );
+
   wire [DWIDTH-1:0] wt_sr_next [0:WT_SIZE-1];
   wire [DWIDTH-1:0] wt_sr_value[0:WT_SIZE-1];
   wire wt_sr_ce [0:WT_SIZE-1];
@@ -296,6 +347,24 @@ module xcel_naive_compute #(
     end
   endgenerate
 
+  // Weights of the second output channel
+  wire [DWIDTH-1:0] wt1_sr_next [0:WT_SIZE-1];
+  wire [DWIDTH-1:0] wt1_sr_value[0:WT_SIZE-1];
+  wire wt1_sr_ce [0:WT_SIZE-1];
+  wire wt1_sr_rst[0:WT_SIZE-1];
+
+  generate
+    for (i = 0; i < WT_SIZE; i = i + 1) begin
+      REGISTER_R_CE #(.N(DWIDTH), .INIT(0)) wt1_sr_reg (
+        .clk(clk),
+        .rst(wt1_sr_rst[i]),
+        .d(wt1_sr_next[i]),
+        .q(wt1_sr_value[i]),
+        .ce(wt1_sr_ce[i])
+      );
+    end
+  endgenerate
+
   wire [DWIDTH-1:0] ifm_sr_next [0:WT_SIZE-1];
   wire [DWIDTH-1:0] ifm_sr_value[0:WT_SIZE-1];
   wire ifm_sr_ce [0:WT_SIZE-1];
@@ -324,12 +393,37 @@ module xcel_naive_compute #(
     .ce(acc_ce)
   );
 
+  wire [31:0] acc1_next, acc1_value;
+  wire acc1_ce, acc1_rst;
+
+  REGISTER_R_CE #(.N(32), .INIT(0)) acc1_reg (
+    .clk(clk),
+    .rst(acc1_rst),
+    .d(acc1_next),
+    .q(acc1_value),
+    .ce(acc1_ce)
+  );
+
   wire [31:0] window_index = window_y_value * WT_DIM + window_x_value;
 
-  assign wt_addr   = wt_offset0_value  + wt_offset1_value  + window_index;
+  // The second output channel is wt_volume (weights) and ofm_size (OFM)
+  // after the first one
+  wire [31:0] wt_lane_offset  = wt_lane_value  ? wt_volume : 32'd0;
+  wire [31:0] ofm_lane_offset = ofm_lane_value ? ofm_size  : 32'd0;
+
+  assign wt_addr   = wt_offset0_value  + wt_offset1_value  + wt_lane_offset + window_index;
   assign ifm_addr  = ifm_offset0_value + ifm_offset1_value + ofm_x_value + ifm_idx_value;
-  assign ofm_addr0 = ofm_offset0_value + ofm_offset1_value + ofm_x_value;
-  assign ofm_addr1 = ofm_offset0_value + ofm_offset1_value + ofm_x_value;
+  assign ofm_addr0 = ofm_offset0_value + ofm_offset1_value + ofm_lane_offset + ofm_x_value;
+  assign ofm_addr1 = ofm_offset0_value + ofm_offset1_value + ofm_lane_offset + ofm_x_value;
+
+  // The second output channel only exists if ofm_depth is not exhausted
+  // (odd ofm_depth: the last pass computes a single channel; LeNet's conv1
+  // and conv2, with 8 and 16 channels, never take it)
+  wire lane1_en = (oc_cnt_value + 1) < ofm_depth;
+  wire last_oc  = (oc_cnt_value + 2) >= ofm_depth;
+
+  wire wt_last_lane  = wt_lane_value  | ~lane1_en;
+  wire ofm_last_lane = ofm_lane_value | ~lane1_en;
 
   wire idle          = state_value == STATE_IDLE;
   wire fetch_ofm     = state_value == STATE_FETCH_OFM;
@@ -344,7 +438,8 @@ module xcel_naive_compute #(
   wire read_wt_success   = fetch_wt  & wt_dout_fire;
   wire read_ifm_success  = fetch_ifm & ifm_dout_fire;
   wire read_ofm_success  = fetch_ofm & ofm_dout0_fire;
-  wire write_ofm_success = write_ofm & ofm_din1_fire;
+  // an OFM element is written once both output channels are written
+  wire write_ofm_success = write_ofm & ofm_din1_fire & ofm_last_lane;
 
   // conv2D is done when we write the last OFM result
   wire conv2D_done = write_ofm_success &
@@ -352,10 +447,10 @@ module xcel_naive_compute #(
                      (ofm_y_value == ofm_dim - 1);
 
   // conv3D is done when we write the last OFM result
-  // of the last ifm channel of the last ofm channel
+  // of the last ifm channel of the last ofm channel (pair)
   wire conv3D_done = conv2D_done &
                      (ic_cnt_value == ifm_depth - 1) &
-                     (oc_cnt_value == ofm_depth - 1);
+                     last_oc;
 
   // Read from OFM when we need to accumulate the past (partial) OFM result
   // with the current computing result
@@ -377,13 +472,13 @@ module xcel_naive_compute #(
       end
 
       STATE_FETCH_OFM: begin
-        if (ofm_dout0_fire)
+        if (ofm_dout0_fire && ofm_last_lane)
           state_next = STATE_FETCH_WT;
       end
 
-      // fetch WT_SIZE weight elements
+      // fetch WT_SIZE weight elements for each of the two output channels
       STATE_FETCH_WT: begin
-        if (window_index == WT_SIZE - 1 && wt_dout_fire)
+        if (window_index == WT_SIZE - 1 && wt_dout_fire && wt_last_lane)
           state_next = STATE_FETCH_IFM;
       end
 
@@ -400,7 +495,7 @@ module xcel_naive_compute #(
       end
 
       STATE_WRITE_OFM: begin
-        if (ofm_din1_fire) begin
+        if (write_ofm_success) begin
           if (conv3D_done)
             state_next = STATE_DONE;
           else begin
@@ -433,9 +528,23 @@ module xcel_naive_compute #(
   assign compute_done_ce   = done;
   assign compute_done_rst  = (idle & compute_start) | rst;
 
+  // An OFM row is final once its last element is written while
+  // accumulating the last input channel. Rows of the second output channel
+  // finish together with the first one, but only count once the whole first
+  // channel is done, so that progress stays a prefix of the flattened OFM
+  assign compute_progress = progress_value;
+
+  assign progress_next = ((ofm_y_value == ofm_dim - 1) & lane1_en) ?
+                         (progress_value + ofm_dim + 1) :
+                         (progress_value + 1);
+  assign progress_ce   = write_ofm_success &
+                         (ofm_x_value == ofm_dim - 1) &
+                         (ic_cnt_value == ifm_depth - 1);
+  assign progress_rst  = (idle & compute_start) | rst;
+
   // update output channel counter when we finish conv2D of all IFM channel
   // (convolving with the current weight)
-  assign oc_cnt_next = oc_cnt_value + 1;
+  assign oc_cnt_next = oc_cnt_value + 2;
   assign oc_cnt_ce   = (conv2D_done & ic_cnt_value == ifm_depth - 1);
   assign oc_cnt_rst  = idle;
 
@@ -444,21 +553,21 @@ module xcel_naive_compute #(
   //
   // current result of the sliding window
   assign ofm_x_next = ofm_x_value + 1;
-  assign ofm_x_ce   = write_ofm & ofm_din1_fire;
-  assign ofm_x_rst  = (write_ofm & ofm_din1_fire & (ofm_x_value == ofm_dim - 1)) | idle;
+  assign ofm_x_ce   = write_ofm_success;
+  assign ofm_x_rst  = (write_ofm_success & (ofm_x_value == ofm_dim - 1)) | idle;
 
   // current result of the sliding window
   assign ofm_y_next = ofm_y_value + 1;
-  assign ofm_y_ce   = write_ofm & ofm_din1_fire & (ofm_x_value == ofm_dim - 1);
+  assign ofm_y_ce   = write_ofm_success & (ofm_x_value == ofm_dim - 1);
   assign ofm_y_rst  = conv2D_done | idle;
 
   // next OFM row
   assign ofm_offset1_next = ofm_offset1_value + ofm_dim;
-  assign ofm_offset1_ce   = write_ofm & ofm_din1_fire & (ofm_x_value == ofm_dim - 1);
+  assign ofm_offset1_ce   = write_ofm_success & (ofm_x_value == ofm_dim - 1);
   assign ofm_offset1_rst  = conv2D_done | idle;
 
-  // next OFM channel
-  assign ofm_offset0_next = ofm_offset0_value + ofm_size;
+  // next OFM channel (pair)
+  assign ofm_offset0_next = ofm_offset0_value + (ofm_size << 1);
   assign ofm_offset0_ce   = (conv2D_done & ic_cnt_value == ifm_depth - 1);
   assign ofm_offset0_rst  = idle;
 
@@ -494,11 +603,22 @@ module xcel_naive_compute #(
   assign wt_offset1_ce   = conv2D_done;
   assign wt_offset1_rst  = (conv2D_done & ic_cnt_value == ifm_depth - 1) | idle;
 
-  // next WT (set of new WT channels)
-  assign wt_offset0_next = wt_offset0_value + wt_volume;
+  // next WT (set of new WT channels, for the next output channel pair)
+  assign wt_offset0_next = wt_offset0_value + (wt_volume << 1);
   assign wt_offset0_ce   = (conv2D_done & ic_cnt_value == ifm_depth - 1);
   assign wt_offset0_rst  = idle;
 
+  // switch to the weights of the second output channel once the first
+  // channel's window is fetched
+  assign wt_lane_next = ~wt_lane_value;
+  assign wt_lane_ce   = read_wt_success & (window_index == WT_SIZE - 1) & lane1_en;
+  assign wt_lane_rst  = idle;
+
+  // read/write the first then the second output channel's OFM element
+  assign ofm_lane_next = ~ofm_lane_value;
+  assign ofm_lane_ce   = ((fetch_ofm & ofm_dout0_fire) | (write_ofm & ofm_din1_fire)) & lane1_en;
+  assign ofm_lane_rst  = idle;
+
   // current sliding window (x)
   assign window_x_next = window_x_value + 1;
   assign window_x_ce   = read_wt_success | read_ifm_success;
@@ -519,7 +639,8 @@ module xcel_naive_compute #(
   assign ofm_dout0_ready = fetch_ofm;
 
   // Write request to the Memory Interface unit
-  assign ofm_din1       = ofm_data_value + acc_value;
+  assign ofm_din1       = ofm_lane_value ? (ofm1_data_value + acc1_value) :
+                                         (ofm_data_value  + acc_value);
   assign ofm_din1_valid = write_ofm;
   assign ofm_we1        = ofm_din1_fire;
 
@@ -531,11 +652,23 @@ module xcel_naive_compute #(
       else
         assign wt_sr_next[i] = wt_sr_value[i + 1];
 
-      assign wt_sr_ce[i]  = read_wt_success | compute;
+      assign wt_sr_ce[i]  = (read_wt_success & ~wt_lane_value) | compute;
       assign wt_sr_rst[i] = idle;
     end
   endgenerate
 
+  generate
+    for (i = 0; i < WT_SIZE; i = i + 1) begin
+      if (i == WT_SIZE - 1)
+        assign wt1_sr_next[i] = fetch_wt ? wt_dout : wt1_sr_value[0];
+      else
+        assign wt1_sr_next[i] = wt1_sr_value[i + 1];
+
+      assign wt1_sr_ce[i]  = (read_wt_success & wt_lane_value) | compute;
+      assign wt1_sr_rst[i] = idle;
+    end
+  endgenerate
+
   // Shift registers to hold ifm data
   generate
     for (i = 0; i < WT_SIZE; i = i + 1) begin
@@ -551,10 +684,15 @@ module xcel_naive_compute #(
 
   // Reg the read OFM data from the DDR
   assign ofm_data_next = ofm_dout0;
-  assign ofm_data_ce   = read_ofm_success;
+  assign ofm_data_ce   = read_ofm_success & ~ofm_lane_value;
   assign ofm_data_rst  = (conv2D_done & ic_cnt_value == ifm_depth - 1) | idle;
 
-  // A single multiply-accumulator to compute one sliding-window computation of an OFM element
+  assign ofm1_data_next = ofm_dout0;
+  assign ofm1_data_ce   = read_ofm_success & ofm_lane_value;
+  assign ofm1_data_rst  = (conv2D_done & ic_cnt_value == ifm_depth - 1) | idle;
+
+  // Two multiply-accumulators (sharing one DSP48 multiply) compute one
+  // sliding-window computation of an OFM element of two output channels
   //        wt[0] <-- wt[1] <-- wt[2] <-- ... <-- wt[WT_SIZE-1]
   //        |                                        ^
   //        |________________________________________|
@@ -564,19 +702,27 @@ module xcel_naive_compute #(
   //        |                                        |
   //        |                                        v
   //        ifm[0] <-- ifm[1] <-- ifm[2] <-- ... <-- ifm[WT_SIZE-1]
-
-  // Use of DSP block here is not necessary unless we'd like to optimize
-  // for higher clock frequency (< 8ns), since 8b signed multiplication
-  // is not very expensive when implementing with LUTs
-
-  wire signed [15:0] ifm_s0 = $signed(ifm_sr_value[0]);
-  wire signed [15:0] wt_s0  = $signed(wt_sr_value[0]);
-  (* use_dsp48 = "yes" *) wire signed [15:0] tmp  = ifm_s0 * wt_s0;
+  //
+  // acc1 is the same with the wt1 shift registers (second output channel)
+
+  // See mul_int8x2.v for the packing of both weights into a single multiply
+  wire [15:0] tmp, tmp1;
+  mul_int8x2 mul (
+    .ifm(ifm_sr_value[0]),
+    .wt0(wt_sr_value[0]),
+    .wt1(wt1_sr_value[0]),
+    .prod0(tmp),
+    .prod1(tmp1)
+  );
 
   assign acc_next = acc_value + {{16{tmp[15]}}, tmp[15:0]};
   assign acc_ce   = compute;
   assign acc_rst  = fetch_ifm | idle;
 
+  assign acc1_next = acc1_value + {{16{tmp1[15]}}, tmp1[15:0]};
+  assign acc1_ce   = compute;
+  assign acc1_rst  = fetch_ifm | idle;
+
   // shift count. Count WT_SIZE cycles to finish one sliding-window computation
   assign shift_cnt_next = shift_cnt_value + 1;
   assign shift_cnt_ce   = compute;
@@ -2,10 +2,12 @@
 `include "lenet_consts.vh"
 
 module xcel_naive_memif #(
-  parameter AXI_AWIDTH = 32,
-  parameter AXI_DWIDTH = 32,
-  parameter DWIDTH     = 8,
-  parameter WT_DIM     = 5
+  parameter AXI_AWIDTH  = 32,
+  parameter AXI_DWIDTH  = 32,
+  parameter DMEM_AWIDTH = 14,
+  parameter DMEM_DWIDTH = 32,
+  parameter DWIDTH      = 8,
+  parameter WT_DIM      = 5
 ) (
   input clk,
   input rst,
@@ -34,10 +36,28 @@ module xcel_naive_memif #(
   output                  xcel_write_data_valid,
   input                   xcel_write_data_ready,
 
+  // For interfacing with the RISC-V DMem (port b, shared with the DMA)
+  // A request with a zero wbe is a read, else a write. Each one is answered
+  // by one dout_valid pulse: the read data, or the write is done
+  output                     xcel_dmem_request_valid,
+  input                      xcel_dmem_request_ready,
+  output [DMEM_AWIDTH-1:0]   xcel_dmem_addr,
+  output [DMEM_DWIDTH-1:0]   xcel_dmem_din,
+  output [DMEM_DWIDTH/8-1:0] xcel_dmem_wbe,
+  input  [DMEM_DWIDTH-1:0]   xcel_dmem_dout,
+  input                      xcel_dmem_dout_valid,
+
+  // Operand base addresses. Bit 31 selects the address space:
+  // 0: DDR byte address, 1: RISC-V DMem byte address (in the low bits)
+  // Bit 30 of the WT address selects packed int4 weights (two per byte,
+  // low nibble first), which are sign-extended to int8 here
   input [31:0] ifm_ddr_addr, // IFM address in DDR
   input [31:0] wt_ddr_addr,  // WT address in DDR
   input [31:0] ofm_ddr_addr, // OFM address in DDR
 
+  // Drops the cached WT word (the weights may have changed between runs)
+  input wt_cache_flush,
+
   // IFM read
   input  [31:0]       ifm_addr,
   output [DWIDTH-1:0] ifm_dout,
@@ -66,10 +86,16 @@ module xcel_naive_memif #(
 
   localparam integer WT_SIZE = WT_DIM * WT_DIM;
 
+  // One AXI beat holds RATIO DMem words
+  localparam NUM_DBYTES = AXI_DWIDTH / 8;
+  localparam BEAT_SIZE  = $clog2(NUM_DBYTES);
+  localparam RATIO      = AXI_DWIDTH / DMEM_DWIDTH;
+
   wire xcel_read_request_fire  = xcel_read_request_valid & xcel_read_request_ready;
   wire xcel_read_data_fire     = xcel_read_data_valid & xcel_read_data_ready;
   wire xcel_write_request_fire = xcel_write_request_valid & xcel_write_request_ready;
   wire xcel_write_data_fire    = xcel_write_data_valid & xcel_write_data_ready;
+  wire xcel_dmem_request_fire  = xcel_dmem_request_valid & xcel_dmem_request_ready;
 
   wire fetch_ifm = ifm_dout_ready;
   wire fetch_wt  = wt_dout_ready;
@@ -151,10 +177,15 @@ module xcel_naive_memif #(
   localparam STATE_WRITE_DDR_REQ = 3;
   localparam STATE_WRITE_DDR     = 4;
   localparam STATE_DONE          = 5;
-
-  wire [2:0] state_value;
-  reg  [2:0] state_next;
-  REGISTER_R #(.N(3), .INIT(STATE_IDLE)) state_reg (
+  localparam STATE_READ_DMEM_REQ = 6;
+  localparam STATE_READ_DMEM     = 7;
+  localparam STATE_WRITE_DMEM    = 8;
+  localparam STATE_READ_WT_HIT   = 9;
+  localparam STATE_WRITE_DMEM_REQ = 10;
+
+  wire [3:0] state_value;
+  reg  [3:0] state_next;
+  REGISTER_R #(.N(4), .INIT(STATE_IDLE)) state_reg (
     .clk(clk),
     .rst(rst),
     .d(state_next),
@@ -169,15 +200,75 @@ module xcel_naive_memif #(
   wire write_ddr_req = state_value == STATE_WRITE_DDR_REQ;
   wire write_ddr     = state_value == STATE_WRITE_DDR;
   wire done          = state_value == STATE_DONE;
+  wire read_dmem_req = state_value == STATE_READ_DMEM_REQ;
+  wire read_dmem     = state_value == STATE_READ_DMEM;
+  wire write_dmem    = state_value == STATE_WRITE_DMEM;
+  wire read_wt_hit   = state_value == STATE_READ_WT_HIT;
+  wire write_dmem_req = state_value == STATE_WRITE_DMEM_REQ;
+
+  // Address space of the operand being accessed
+  wire ifm_in_dmem = ifm_ddr_addr[31];
+  wire wt_in_dmem  = wt_ddr_addr[31];
+  wire ofm_in_dmem = ofm_ddr_addr[31];
+
+  wire read_in_dmem = fetch_ofm_pipe ? ofm_in_dmem :
+                      fetch_wt_pipe  ? wt_in_dmem  :
+                                       ifm_in_dmem;
+
+  // Byte address of the weight being fetched
+  wire wt_int4 = wt_ddr_addr[30];
+  wire [31:0] wt_base      = {wt_ddr_addr[31], 1'b0, wt_ddr_addr[29:0]};
+  wire [31:0] wt_byte_addr = wt_base + (wt_int4 ? (wt_addr_pipe >> 1) : wt_addr_pipe);
+
+  // Weights are read a whole line at a time: an AXI beat from DDR, a word
+  // from DMem. The compute unit walks them sequentially, so the last line
+  // read is kept around and the following int8 (or int4) weights are served
+  // from it without a memory access
+  wire [AXI_DWIDTH-1:0] read_data;
+  wire read_data_valid;
+
+  wire [31:0] wt_line_mask = wt_in_dmem ? 32'hffff_fffc : ~(NUM_DBYTES - 1);
+  wire [31:0] wt_line_addr = wt_byte_addr & wt_line_mask;
+
+  wire [AXI_DWIDTH-1:0] wt_word_value;
+  wire [31:0] wt_word_addr_value;
+  wire wt_word_valid_value;
+  wire wt_word_ce = fetch_wt_pipe & read_data_valid;
+
+  REGISTER_CE #(.N(AXI_DWIDTH)) wt_word_reg (
+    .clk(clk),
+    .d(read_data),
+    .q(wt_word_value),
+    .ce(wt_word_ce)
+  );
+
+  REGISTER_CE #(.N(32)) wt_word_addr_reg (
+    .clk(clk),
+    .d(wt_line_addr),
+    .q(wt_word_addr_value),
+    .ce(wt_word_ce)
+  );
+
+  REGISTER_R_CE #(.N(1), .INIT(0)) wt_word_valid_reg (
+    .clk(clk),
+    .rst(rst | wt_cache_flush),
+    .d(1'b1),
+    .q(wt_word_valid_value),
+    .ce(wt_word_ce)
+  );
+
+  wire wt_word_hit = wt_word_valid_value & (wt_word_addr_value == wt_line_addr);
 
   always @(*) begin
     state_next = state_value;
     case (state_value)
     STATE_IDLE: begin
-      if (fetch_ifm_pipe | fetch_wt_pipe | fetch_ofm_pipe)
-        state_next = STATE_READ_DDR_REQ;
+      if (fetch_wt_pipe & wt_word_hit)
+        state_next = STATE_READ_WT_HIT;
+      else if (fetch_ifm_pipe | fetch_wt_pipe | fetch_ofm_pipe)
+        state_next = read_in_dmem ? STATE_READ_DMEM_REQ : STATE_READ_DDR_REQ;
       else if (write_ofm_pipe)
-        state_next = STATE_WRITE_DDR_REQ;
+        state_next = ofm_in_dmem ? STATE_WRITE_DMEM_REQ : STATE_WRITE_DDR_REQ;
     end
 
     STATE_READ_DDR_REQ: begin
@@ -200,6 +291,35 @@ module xcel_naive_memif #(
         state_next = STATE_DONE;
     end
 
+    // DMem port b is shared with the DMA controller, so a request may have
+    // to wait before it is accepted
+    STATE_READ_DMEM_REQ: begin
+      if (xcel_dmem_request_fire)
+        state_next = STATE_READ_DMEM;
+    end
+
+    STATE_READ_DMEM: begin
+      if (xcel_dmem_dout_valid)
+        state_next = STATE_DONE;
+    end
+
+    // A DMem write is done once it is acknowledged, not once it is queued
+    // (on the clock crossing): the compute unit only reports a row done
+    // after its last write, and the CPU may read the row right away
+    STATE_WRITE_DMEM_REQ: begin
+      if (xcel_dmem_request_fire)
+        state_next = STATE_WRITE_DMEM;
+    end
+
+    STATE_WRITE_DMEM: begin
+      if (xcel_dmem_dout_valid)
+        state_next = STATE_DONE;
+    end
+
+    STATE_READ_WT_HIT: begin
+      state_next = STATE_DONE;
+    end
+
     STATE_DONE: begin
       state_next = STATE_IDLE;
     end
@@ -208,47 +328,68 @@ module xcel_naive_memif #(
   end
 
   // Setup read request and read data
-  // Reading WT and IFM one byte per transfer
-  // Reading OFM 4 bytes per transfer
+  // Reading IFM one byte per transfer
+  // Reading OFM 4 bytes per transfer, WT a full beat per transfer
   assign xcel_read_request_valid  = read_ddr_req;
   assign xcel_read_addr           = fetch_ofm_pipe ? (ofm_ddr_addr + {ofm_addr0_pipe << 2}) :
-                                    fetch_wt_pipe  ? (wt_ddr_addr  + {wt_addr_pipe   << 0}) :
+                                    fetch_wt_pipe  ? wt_line_addr :
                                                      (ifm_ddr_addr + {ifm_addr_pipe  << 0});
   assign xcel_read_len            = 1 - 1; // no burst (one data beat per transfer)
   assign xcel_read_burst          = `BURST_INCR;
-  assign xcel_read_size           = fetch_ofm_pipe ? 3'd2 : 3'd0; // 4 bytes if fetching ofm, otherwise 1 byte
+  assign xcel_read_size           = fetch_wt_pipe  ? BEAT_SIZE :
+                                    fetch_ofm_pipe ? 3'd2 : 3'd0; // a beat for wt, 4 bytes for ofm, otherwise 1 byte
   assign xcel_read_data_ready     = read_ddr;
 
   // Setup write request and write data
-  // Write OFM 4 bytes per transfer
+  // Write OFM 4 bytes per transfer (on every word lane of the beat; the AXI
+  // adapter only enables the lane of the address)
   assign xcel_write_request_valid = write_ddr_req;
   assign xcel_write_addr          = ofm_ddr_addr + {ofm_addr1_pipe << 2};
   assign xcel_write_len           = 1 - 1; // no burst (one data beat per transfer)
   assign xcel_write_burst         = `BURST_INCR;
   assign xcel_write_size          = 3'd2; // 4 bytes;
   assign xcel_write_data_valid    = write_ddr;
-  assign xcel_write_data          = ofm_din1;
+  assign xcel_write_data          = {RATIO{ofm_din1}};
+
+  // Setup DMem access
+  // Same byte addresses as the DDR requests; DMem is word-addressed, so the
+  // byte offset is dropped here and applied by the byte select below
+  assign xcel_dmem_request_valid = read_dmem_req | write_dmem_req;
+  assign xcel_dmem_addr = write_dmem_req ? xcel_write_addr[DMEM_AWIDTH+1:2] :
+                                           xcel_read_addr[DMEM_AWIDTH+1:2];
+  assign xcel_dmem_din  = ofm_din1;
+  assign xcel_dmem_wbe  = write_dmem_req ? {(DMEM_DWIDTH/8){1'b1}} : {(DMEM_DWIDTH/8){1'b0}};
+
+  // A DMem word is copied to every word lane, so that the lane selects
+  // below work the same for both address spaces
+  assign read_data = read_dmem ? {RATIO{xcel_dmem_dout}} : xcel_read_data;
+
+  wire [AXI_DWIDTH-1:0] wt_word = read_wt_hit ? wt_word_value : read_data;
 
   // extract the correct byte from the read data based on the byte offset
-  wire [DWIDTH-1:0] byte_wt = wt_addr_pipe[1:0] == 2'b00 ? xcel_read_data[7:0]   :
-                              wt_addr_pipe[1:0] == 2'b01 ? xcel_read_data[15:8]  :
-                              wt_addr_pipe[1:0] == 2'b10 ? xcel_read_data[23:16] :
-                                                           xcel_read_data[31:24];
+  // (within the beat)
+  wire [7:0] byte_wt = wt_word[wt_byte_addr[BEAT_SIZE-1:0] * 8 +: 8];
 
-  wire [DWIDTH-1:0] byte_ifm = ifm_addr_pipe[1:0] == 2'b00 ? xcel_read_data[7:0]   :
-                               ifm_addr_pipe[1:0] == 2'b01 ? xcel_read_data[15:8]  :
-                               ifm_addr_pipe[1:0] == 2'b10 ? xcel_read_data[23:16] :
-                                                             xcel_read_data[31:24];
+  // then the nibble of a packed int4 weight, sign-extended
+  wire [3:0] nibble_wt = wt_addr_pipe[0] ? byte_wt[7:4] : byte_wt[3:0];
+
+  wire [DWIDTH-1:0] byte_ifm = read_data[xcel_read_addr[BEAT_SIZE-1:0] * 8 +: 8];
+
+  wire [31:0] word_ofm = read_data[(xcel_read_addr[BEAT_SIZE-1:0] >> 2) * 32 +: 32];
 
   // Read response to the compute_unit
-  assign wt_dout   = byte_wt;
+  assign wt_dout   = wt_int4 ? {{4{nibble_wt[3]}}, nibble_wt} : byte_wt;
   assign ifm_dout  = byte_ifm;
-  assign ofm_dout0 = xcel_read_data;
+  assign ofm_dout0 = word_ofm;
+
+  assign read_data_valid = (read_ddr  & xcel_read_data_valid) |
+                           (read_dmem & xcel_dmem_dout_valid);
 
-  assign wt_dout_valid   = read_ddr & xcel_read_data_valid;
-  assign ifm_dout_valid  = read_ddr & xcel_read_data_valid;
-  assign ofm_dout0_valid = read_ddr & xcel_read_data_valid;
+  assign wt_dout_valid   = read_data_valid | read_wt_hit;
+  assign ifm_dout_valid  = read_data_valid;
+  assign ofm_dout0_valid = read_data_valid;
 
-  assign ofm_din1_ready = write_ddr & xcel_write_data_ready;
+  assign ofm_din1_ready = (write_ddr & xcel_write_data_ready) |
+                          (write_dmem & xcel_dmem_dout_valid);
 
 endmodule
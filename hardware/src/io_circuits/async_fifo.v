@@ -0,0 +1,112 @@
+
+// Dual-clock FIFO for crossing clock domains
+// The read and write pointers are Gray-coded and synchronized into the other
+// domain, so the full/empty flags are conservative: a slot only becomes
+// visible to the other side a couple of cycles after it is written/freed
+module ASYNC_FIFO #(
+  parameter WIDTH    = 32, // data width is 32-bit
+  parameter LOGDEPTH = 3   // 2^3 = 8 entries (at least 4 entries)
+) (
+  // Write interface (enqueue), in the enq_clk domain
+  input  enq_clk,
+  input  enq_rst,
+  input  enq_valid,
+  input  [WIDTH-1:0] enq_data,
+  output enq_ready,
+
+  // Read interface (dequeue), in the deq_clk domain
+  input  deq_clk,
+  input  deq_rst,
+  output deq_valid,
+  output [WIDTH-1:0] deq_data,
+  input  deq_ready
+);
+
+  wire enq_fire = enq_valid & enq_ready;
+  wire deq_fire = deq_valid & deq_ready;
+
+  // The pointers carry one extra wrap-around bit to tell full from empty
+  wire [LOGDEPTH:0] write_ptr_value, write_ptr_next;
+  wire [LOGDEPTH:0] read_ptr_value, read_ptr_next;
+
+  REGISTER_R_CE #(.N(LOGDEPTH + 1)) write_ptr_reg (
+    .q(write_ptr_value),
+    .d(write_ptr_next),
+    .ce(enq_fire),
+    .rst(enq_rst),
+    .clk(enq_clk)
+  );
+
+  REGISTER_R_CE #(.N(LOGDEPTH + 1)) read_ptr_reg (
+    .q(read_ptr_value),
+    .d(read_ptr_next),
+    .ce(deq_fire),
+    .rst(deq_rst),
+    .clk(deq_clk)
+  );
+
+  assign write_ptr_next = write_ptr_value + 1;
+  assign read_ptr_next  = read_ptr_value + 1;
+
+  // Gray-coded copies of the pointers (registered, so that no combinational
+  // glitch can be sampled by the other domain)
+  wire [LOGDEPTH:0] write_ptr_gray, read_ptr_gray;
+
+  REGISTER_R #(.N(LOGDEPTH + 1)) write_ptr_gray_reg (
+    .q(write_ptr_gray),
+    .d(write_ptr_value ^ (write_ptr_value >> 1)),
+    .rst(enq_rst),
+    .clk(enq_clk)
+  );
+
+  REGISTER_R #(.N(LOGDEPTH + 1)) read_ptr_gray_reg (
+    .q(read_ptr_gray),
+    .d(read_ptr_value ^ (read_ptr_value >> 1)),
+    .rst(deq_rst),
+    .clk(deq_clk)
+  );
+
+  wire [LOGDEPTH:0] write_ptr_gray_sync, read_ptr_gray_sync;
+
+  synchronizer #(.WIDTH(LOGDEPTH + 1)) write_ptr_sync (
+    .async_signal(write_ptr_gray),
+    .clk(deq_clk),
+    .sync_signal(write_ptr_gray_sync)
+  );
+
+  synchronizer #(.WIDTH(LOGDEPTH + 1)) read_ptr_sync (
+    .async_signal(read_ptr_gray),
+    .clk(enq_clk),
+    .sync_signal(read_ptr_gray_sync)
+  );
+
+  // Full: the write pointer is one lap ahead of the read pointer
+  // (in Gray code: the two MSBs differ, the rest are equal)
+  wire [LOGDEPTH:0] write_ptr_gray_now = write_ptr_value ^ (write_ptr_value >> 1);
+  wire [LOGDEPTH:0] read_ptr_gray_now  = read_ptr_value  ^ (read_ptr_value  >> 1);
+
+  assign enq_ready = write_ptr_gray_now !=
+                     {~read_ptr_gray_sync[LOGDEPTH:LOGDEPTH-1], read_ptr_gray_sync[LOGDEPTH-2:0]};
+  assign deq_valid = read_ptr_gray_now != write_ptr_gray_sync;
+
+  // The write port lives in the enq_clk domain, reads are asynchronous
+  ASYNC_RAM_DP #(
+    .AWIDTH(LOGDEPTH),
+    .DWIDTH(WIDTH)
+  ) buffer (
+    .clk(enq_clk),
+
+    // Port 0 (write)
+    .q0(),
+    .d0(enq_data),
+    .addr0(write_ptr_value[LOGDEPTH-1:0]),
+    .we0(enq_fire),
+
+    // Port 1 (read)
+    .q1(deq_data),
+    .d1({WIDTH{1'b0}}),
+    .addr1(read_ptr_value[LOGDEPTH-1:0]),
+    .we1(1'b0)
+  );
+
+endmodule
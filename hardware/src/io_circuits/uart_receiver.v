@@ -1,11 +1,11 @@
 
-module uart_receiver #(
-  parameter CLOCK_FREQ = 125_000_000,
-  parameter BAUD_RATE  = 115_200
-) (
+module uart_receiver (
   input clk,
   input rst,
 
+  // Clock cycles per bit (CLOCK_FREQ / BAUD_RATE), set at run time
+  input [15:0] symbol_edge_time,
+
   output [7:0] data_out,
   output data_out_valid,
   input data_out_ready,
@@ -14,9 +14,9 @@ module uart_receiver #(
 );
 
   // See diagram in the lab guide
-  localparam integer SYMBOL_EDGE_TIME = CLOCK_FREQ / BAUD_RATE;
-  localparam integer SAMPLE_TIME      = SYMBOL_EDGE_TIME / 2;
-  localparam CLOCK_COUNTER_WIDTH      = $clog2(SYMBOL_EDGE_TIME);
+  localparam CLOCK_COUNTER_WIDTH = 16;
+
+  wire [15:0] sample_time_value = symbol_edge_time >> 1;
 
   wire [9:0] rx_shift_value;
   wire [9:0] rx_shift_next;
@@ -57,8 +57,9 @@ module uart_receiver #(
 
   wire data_out_fire = data_out_valid & data_out_ready;
 
-  wire symbol_edge = (clock_counter_value == SYMBOL_EDGE_TIME - 1);
-  wire sample_time = (clock_counter_value == SAMPLE_TIME - 1);
+  // (>=: a shorter symbol time set mid-symbol must not wrap the counter)
+  wire symbol_edge = (clock_counter_value >= symbol_edge_time - 1);
+  wire sample_time = (clock_counter_value == sample_time_value - 1);
   wire done        = (bit_counter_value == 10 - 1) & sample_time;
 
   // 'has_byte' becomes HIGH once we finish sampling all 10 bits
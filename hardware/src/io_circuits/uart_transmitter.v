@@ -1,11 +1,11 @@
 
-module uart_transmitter #(
-  parameter CLOCK_FREQ = 125_000_000,
-  parameter BAUD_RATE = 115_200
-) (
+module uart_transmitter (
   input clk,
   input rst,
 
+  // Clock cycles per bit (CLOCK_FREQ / BAUD_RATE), set at run time
+  input [15:0] symbol_edge_time,
+
   input [7:0] data_in,
   input data_in_valid,
   output data_in_ready,
@@ -13,8 +13,7 @@ module uart_transmitter #(
   output serial_out
 );
 
-  localparam integer SYMBOL_EDGE_TIME = CLOCK_FREQ / BAUD_RATE;
-  localparam CLOCK_COUNTER_WIDTH      = $clog2(SYMBOL_EDGE_TIME);
+  localparam CLOCK_COUNTER_WIDTH = 16;
 
   wire [9:0] tx_shift_value;
   wire [9:0] tx_shift_next;
@@ -53,7 +52,8 @@ module uart_transmitter #(
   );
 
   wire data_in_fire   = data_in_valid & data_in_ready;
-  wire symbol_edge = (clock_counter_value == SYMBOL_EDGE_TIME - 1);
+  // (>=: a shorter symbol time set mid-symbol must not wrap the counter)
+  wire symbol_edge = (clock_counter_value >= symbol_edge_time - 1);
 
   assign clock_counter_next = clock_counter_value + 1;
   assign clock_counter_ce = 1'b1;
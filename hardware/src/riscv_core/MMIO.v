@@ -2,6 +2,8 @@ module MMIO #(
   parameter AWIDTH = 32,
   parameter DWIDTH = 32
 ) (
+  input clk,
+  input rst,
   input [AWIDTH - 1:0] addr_in,
   input [DWIDTH - 1:0] data_in,
   input re_in,
@@ -10,23 +12,57 @@ module MMIO #(
   input [7:0] data_uart_rx_in,
   input [DWIDTH - 1:0] data_cycle_counter_in,
   input [DWIDTH - 1:0] data_inst_counter_in,
+  input [DWIDTH - 1:0] data_xcel_progress_in,
+  input [DWIDTH - 1:0] data_dma_desc_count_in,
+  input [DWIDTH - 1:0] data_dma_sum_in,
+  input [DWIDTH - 1:0] data_dma_crc_in,
+  input [DWIDTH - 1:0] data_axi_mon_in,
+  input [DWIDTH - 1:0] data_uart_fifo_level_in,
+  input [DWIDTH - 1:0] data_uart_baud_in,
   // Peripheral data in
   input ctrl_uart_tx_ready_in,
   input ctrl_uart_rx_valid_in,
+  input ctrl_uart_tx_idle_in,
+  input ctrl_dma_done_in,
+  input ctrl_dma_idle_in,
+  input ctrl_xcel_done_in,
+  input ctrl_xcel_idle_in,
 
   output reg [DWIDTH - 1:0] data_reg_out,
   // Peripheral data out
   output [7:0] data_uart_tx_out,
+  output [DWIDTH - 1:0] data_uart_tx_word_out,
+  output [DWIDTH - 1:0] data_dma_src_addr_out,
+  output [DWIDTH - 1:0] data_dma_dst_addr_out,
+  output [DWIDTH - 1:0] data_dma_len_out,
+  output [DWIDTH - 1:0] data_dma_desc_addr_out,
+  output [DWIDTH - 1:0] data_ifm_ddr_addr_out,
+  output [DWIDTH - 1:0] data_wt_ddr_addr_out,
+  output [DWIDTH - 1:0] data_ofm_ddr_addr_out,
+  output [DWIDTH - 1:0] data_ifm_dim_out,
+  output [DWIDTH - 1:0] data_ifm_depth_out,
+  output [DWIDTH - 1:0] data_ofm_dim_out,
+  output [DWIDTH - 1:0] data_ofm_depth_out,
+  output [DWIDTH - 1:0] data_axi_mon_sel_out,
   // Peripheral control out
   output ctrl_uart_tx_valid_out,
+  output ctrl_uart_tx_word_valid_out,
   output ctrl_uart_rx_ready_out,
-  output ctrl_counter_rst_out
+  output ctrl_uart_baud_we_out,
+  output ctrl_counter_rst_out,
+  output ctrl_dma_start_out,
+  output ctrl_dma_dir_out,
+  output ctrl_dma_desc_start_out,
+  output ctrl_xcel_start_out,
+  output ctrl_axi_mon_clear_out
 );
 
 
   wire is_mmio_addr;
   assign is_mmio_addr = (addr_in[31] == 1'b1);
 
+  wire mmio_we = is_mmio_addr && we_in;
+
   always @(*) begin
     if (is_mmio_addr) begin
       if (addr_in[7:0] == 8'h10) begin
@@ -34,12 +70,39 @@ module MMIO #(
       end else if (addr_in[7:0] == 8'h14) begin
         // Instruction counter
         data_reg_out = data_inst_counter_in;
+      end else if (addr_in[7:0] == 8'h34) begin
+        // DMA status
+        data_reg_out = {{(DWIDTH - 2) {1'b0}}, ctrl_dma_idle_in, ctrl_dma_done_in};
+      end else if (addr_in[7:0] == 8'h4c) begin
+        // DMA descriptor chain progress (number of finished transfers)
+        data_reg_out = data_dma_desc_count_in;
+      end else if (addr_in[7:0] == 8'h78) begin
+        // Sum of the data words moved by the last DMA run
+        data_reg_out = data_dma_sum_in;
+      end else if (addr_in[7:0] == 8'h7c) begin
+        // CRC32 of the data words moved by the last DMA run
+        data_reg_out = data_dma_crc_in;
+      end else if (addr_in[7:0] == 8'h54) begin
+        // Accelerator status
+        data_reg_out = {{(DWIDTH - 2) {1'b0}}, ctrl_xcel_idle_in, ctrl_xcel_done_in};
+      end else if (addr_in[7:0] == 8'h74) begin
+        // Accelerator progress (number of finished OFM rows)
+        data_reg_out = data_xcel_progress_in;
+      end else if (addr_in[7:0] == 8'h80) begin
+        // AXI traffic monitor counter, selected by a store to this address
+        data_reg_out = data_axi_mon_in;
       end else if (ctrl_uart_rx_ready_out && ctrl_uart_rx_valid_in) begin
         // Uart receiver data
         data_reg_out = data_uart_rx_in;
       end else if (addr_in[7:0] == 8'h00) begin
         // Uart control
-        data_reg_out = {{(DWIDTH - 2) {1'b0}}, ctrl_uart_rx_valid_in, ctrl_uart_tx_ready_in};
+        data_reg_out = {{(DWIDTH - 3) {1'b0}}, ctrl_uart_tx_idle_in, ctrl_uart_rx_valid_in, ctrl_uart_tx_ready_in};
+      end else if (addr_in[7:0] == 8'h0c) begin
+        // Uart FIFO levels: {received bytes, free transmit entries}
+        data_reg_out = data_uart_fifo_level_in;
+      end else if (addr_in[7:0] == 8'h1c) begin
+        // Uart clock cycles per bit
+        data_reg_out = data_uart_baud_in;
       end else begin
         data_reg_out = {DWIDTH{1'b0}};
       end
@@ -48,11 +111,129 @@ module MMIO #(
     end
   end
 
+  // DMA setting registers
+  REGISTER_R_CE #(.N(1), .INIT(0)) dma_dir_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(data_in[0]),
+    .q(ctrl_dma_dir_out),
+    .ce(mmio_we && addr_in[7:0] == 8'h38)
+  );
+
+  REGISTER_R_CE #(.N(DWIDTH), .INIT(0)) dma_src_addr_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(data_in),
+    .q(data_dma_src_addr_out),
+    .ce(mmio_we && addr_in[7:0] == 8'h3c)
+  );
+
+  REGISTER_R_CE #(.N(DWIDTH), .INIT(0)) dma_dst_addr_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(data_in),
+    .q(data_dma_dst_addr_out),
+    .ce(mmio_we && addr_in[7:0] == 8'h40)
+  );
+
+  REGISTER_R_CE #(.N(DWIDTH), .INIT(0)) dma_len_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(data_in),
+    .q(data_dma_len_out),
+    .ce(mmio_we && addr_in[7:0] == 8'h44)
+  );
+
+  REGISTER_R_CE #(.N(DWIDTH), .INIT(0)) dma_desc_addr_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(data_in),
+    .q(data_dma_desc_addr_out),
+    .ce(mmio_we && addr_in[7:0] == 8'h48)
+  );
+
+  // Accelerator setting registers
+  REGISTER_R_CE #(.N(DWIDTH), .INIT(0)) ifm_ddr_addr_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(data_in),
+    .q(data_ifm_ddr_addr_out),
+    .ce(mmio_we && addr_in[7:0] == 8'h58)
+  );
+
+  REGISTER_R_CE #(.N(DWIDTH), .INIT(0)) wt_ddr_addr_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(data_in),
+    .q(data_wt_ddr_addr_out),
+    .ce(mmio_we && addr_in[7:0] == 8'h5c)
+  );
+
+  REGISTER_R_CE #(.N(DWIDTH), .INIT(0)) ofm_ddr_addr_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(data_in),
+    .q(data_ofm_ddr_addr_out),
+    .ce(mmio_we && addr_in[7:0] == 8'h60)
+  );
+
+  REGISTER_R_CE #(.N(DWIDTH), .INIT(0)) ifm_dim_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(data_in),
+    .q(data_ifm_dim_out),
+    .ce(mmio_we && addr_in[7:0] == 8'h64)
+  );
+
+  REGISTER_R_CE #(.N(DWIDTH), .INIT(0)) ifm_depth_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(data_in),
+    .q(data_ifm_depth_out),
+    .ce(mmio_we && addr_in[7:0] == 8'h68)
+  );
+
+  REGISTER_R_CE #(.N(DWIDTH), .INIT(0)) ofm_dim_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(data_in),
+    .q(data_ofm_dim_out),
+    .ce(mmio_we && addr_in[7:0] == 8'h6c)
+  );
+
+  REGISTER_R_CE #(.N(DWIDTH), .INIT(0)) ofm_depth_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(data_in),
+    .q(data_ofm_depth_out),
+    .ce(mmio_we && addr_in[7:0] == 8'h70)
+  );
+
+  // AXI traffic monitor counter select
+  REGISTER_R_CE #(.N(DWIDTH), .INIT(0)) axi_mon_sel_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(data_in),
+    .q(data_axi_mon_sel_out),
+    .ce(mmio_we && addr_in[7:0] == 8'h80)
+  );
+
   assign ctrl_counter_rst_out = (is_mmio_addr && addr_in[7:0] == 8'h18 && we_in);
   assign ctrl_uart_tx_valid_out = (is_mmio_addr && addr_in[7:0] == 8'h08 && we_in && ctrl_uart_tx_ready_in);
   assign ctrl_uart_rx_ready_out = (is_mmio_addr && addr_in[7:0] == 8'h04 && re_in);
+  // A word store to 0x0c sends its four bytes, lowest byte first
+  assign ctrl_uart_tx_word_valid_out = (is_mmio_addr && addr_in[7:0] == 8'h0c && we_in && ctrl_uart_tx_ready_in);
+  // New baud rate, as clock cycles per bit (data_in[15:0])
+  assign ctrl_uart_baud_we_out = (mmio_we && addr_in[7:0] == 8'h1c);
+
+  // Start pulses: a store to the control address kicks off the DMA/accelerator
+  assign ctrl_dma_start_out  = (mmio_we && addr_in[7:0] == 8'h30);
+  assign ctrl_dma_desc_start_out = (mmio_we && addr_in[7:0] == 8'h4c);
+  assign ctrl_xcel_start_out = (mmio_we && addr_in[7:0] == 8'h50);
+  assign ctrl_axi_mon_clear_out = (mmio_we && addr_in[7:0] == 8'h84);
 
   assign data_uart_tx_out = data_in & 32'h0000_00ff;
+  assign data_uart_tx_word_out = data_in;
 
 
 endmodule
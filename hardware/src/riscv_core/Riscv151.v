@@ -10,7 +10,55 @@ module Riscv151 #(
   input rst,
   input FPGA_SERIAL_RX,
   output FPGA_SERIAL_TX,
-  output [31:0] csr
+  output [31:0] csr,
+
+  // Accelerator Interfacing
+  output xcel_start,
+  input  xcel_done,
+  input  xcel_idle,
+  input  [31:0] xcel_progress,
+
+  output [31:0] ifm_ddr_addr,
+  output [31:0] wt_ddr_addr,
+  output [31:0] ofm_ddr_addr,
+
+  output [31:0] ifm_dim,
+  output [31:0] ifm_depth,
+
+  output [31:0] ofm_dim,
+  output [31:0] ofm_depth,
+
+  // DMA Interfacing
+  output dma_start,
+  input  dma_done,
+  input  dma_idle,
+  output dma_dir,
+  output [31:0] dma_src_addr,
+  output [31:0] dma_dst_addr,
+  output [31:0] dma_len,
+  output dma_desc_start,
+  output [31:0] dma_desc_addr,
+  input  [31:0] dma_desc_count,
+  input  [31:0] dma_sum,
+  input  [31:0] dma_crc,
+
+  // AXI traffic monitor (axi_monitor) readout
+  output [31:0] axi_mon_sel,
+  output        axi_mon_clear,
+  input  [31:0] axi_mon_value,
+
+  // DMem Interfacing (Port b)
+  input  [13:0] dmem_addrb,
+  input  [31:0] dmem_dinb,
+  output [31:0] dmem_doutb,
+  input  [3:0]  dmem_web,
+  input         dmem_enb,
+
+  // IMem Interfacing (Port a, DMA writes; they take priority over the
+  // CPU stores to IMem)
+  input  [13:0] dma_imem_addr,
+  input  [31:0] dma_imem_din,
+  input  [3:0]  dma_imem_wbe
 );
   // Memories
   localparam BIOS_AWIDTH = 11;
@@ -50,29 +98,41 @@ module Riscv151 #(
   // Synchronous read: read takes one cycle
   // Synchronous write: write takes one cycle
   // Write-byte-enaBLe: select which of the four bytes to write
-  SYNC_RAM_WBE #(
+  // Port a: CPU load/store, port b: DMA controller
+  SYNC_RAM_DP_WBE #(
     .AWIDTH(DMEM_AWIDTH),
     .DWIDTH(DMEM_DWIDTH)
   ) dmem (
-    .q(dmem_douta),    // output
-    .d(dmem_dina),     // input
-    .addr(dmem_addra), // input
-    .wbe(dmem_wea),    // input
-    .en(1'b1),
+    .q0(dmem_douta),    // output
+    .d0(dmem_dina),     // input
+    .addr0(dmem_addra), // input
+    .wbe0(dmem_wea),    // input
+    .en0(1'b1),
+
+    .q1(dmem_doutb),    // output
+    .d1(dmem_dinb),     // input
+    .addr1(dmem_addrb), // input
+    .wbe1(dmem_web),    // input
+    .en1(dmem_enb),
+
     .clk(clk)
   );
 
+  // UART bit time in clock cycles: BAUD_RATE after reset, then set by the
+  // software (MMIO 0x1c), e.g. to load programs at a few Mbaud
+  localparam integer UART_SYMBOL_EDGE_TIME = CPU_CLOCK_FREQ / BAUD_RATE;
+
+  wire [15:0] uart_baud_value;
+
   // UART Receiver
   wire [7:0] uart_rx_data_out;
   wire uart_rx_data_out_valid;
   wire uart_rx_data_out_ready;
 
-  uart_receiver #(
-    .CLOCK_FREQ(CPU_CLOCK_FREQ),
-    .BAUD_RATE (BAUD_RATE)
-  ) uart_rx (
+  uart_receiver uart_rx (
     .clk           (clk),
     .rst           (rst),
+    .symbol_edge_time(uart_baud_value),  // input
     .data_out      (uart_rx_data_out),  // output
     .data_out_valid(uart_rx_data_out_valid),  // output
     .data_out_ready(uart_rx_data_out_ready),  // input
@@ -84,12 +144,10 @@ module Riscv151 #(
   wire uart_tx_data_in_valid;
   wire uart_tx_data_in_ready;
 
-  uart_transmitter #(
-    .CLOCK_FREQ(CPU_CLOCK_FREQ),
-    .BAUD_RATE (BAUD_RATE)
-  ) uart_tx (
+  uart_transmitter uart_tx (
     .clk          (clk),
     .rst          (rst),
+    .symbol_edge_time(uart_baud_value),  // input
     .data_in      (uart_tx_data_in),  // input
     .data_in_valid(uart_tx_data_in_valid),  // input
     .data_in_ready(uart_tx_data_in_ready),  // output
@@ -545,7 +603,8 @@ module Riscv151 #(
 
   assign bios_addrb = alu_out[13:2];
   assign dmem_addra = alu_out[15:2];
-  assign imem_addra = alu_out[15:2];
+  wire dma_imem_we = dma_imem_wbe != 4'h0;
+  assign imem_addra = dma_imem_we ? dma_imem_addr : alu_out[15:2];
 
   wire [DMEM_DWIDTH - 1:0] mem_gen_din;
   wire [DMEM_DWIDTH - 1:0] mem_din;
@@ -573,6 +632,9 @@ module Riscv151 #(
   wire [7:0] mmio_uart_tx_out, mmio_uart_rx_in;
   wire mmio_uart_tx_ready_in, mmio_uart_rx_valid_in;
   wire mmio_uart_tx_valid_out, mmio_uart_rx_ready_out;
+  wire [31:0] mmio_uart_tx_word_out, mmio_uart_fifo_level_in;
+  wire mmio_uart_tx_word_valid_out, mmio_uart_tx_idle_in;
+  wire mmio_uart_baud_we_out;
   wire mmio_counter_rst_out;
 
   // MMIO and other peripherals
@@ -580,20 +642,62 @@ module Riscv151 #(
     .AWIDTH(MMIO_AWIDTH),
     .DWIDTH(DMEM_DWIDTH)
   ) mmio (
+    .clk(clk),
+    .rst(rst),
     .addr_in(mmio_addr_in),
     .data_in(mmio_data_in),
     .data_uart_rx_in(mmio_uart_rx_in),
     .data_cycle_counter_in(mmio_cycle_counter_in),
     .data_inst_counter_in(mmio_inst_counter_in),
+    .data_xcel_progress_in(xcel_progress),
+    .data_dma_desc_count_in(dma_desc_count),
+    .data_dma_sum_in(dma_sum),
+    .data_dma_crc_in(dma_crc),
+    .data_axi_mon_in(axi_mon_value),
+    .data_uart_fifo_level_in(mmio_uart_fifo_level_in),
+    .data_uart_baud_in({16'd0, uart_baud_value}),
     .ctrl_uart_tx_ready_in(mmio_uart_tx_ready_in),
     .ctrl_uart_rx_valid_in(mmio_uart_rx_valid_in),
+    .ctrl_uart_tx_idle_in(mmio_uart_tx_idle_in),
+    .ctrl_dma_done_in(dma_done),
+    .ctrl_dma_idle_in(dma_idle),
+    .ctrl_xcel_done_in(xcel_done),
+    .ctrl_xcel_idle_in(xcel_idle),
     .we_in(mmio_we_in),
     .re_in(mmio_re_in),
     .data_reg_out(mmio_data_out),
     .data_uart_tx_out(mmio_uart_tx_out),
+    .data_uart_tx_word_out(mmio_uart_tx_word_out),
+    .data_dma_src_addr_out(dma_src_addr),
+    .data_dma_dst_addr_out(dma_dst_addr),
+    .data_dma_len_out(dma_len),
+    .data_dma_desc_addr_out(dma_desc_addr),
+    .data_ifm_ddr_addr_out(ifm_ddr_addr),
+    .data_wt_ddr_addr_out(wt_ddr_addr),
+    .data_ofm_ddr_addr_out(ofm_ddr_addr),
+    .data_ifm_dim_out(ifm_dim),
+    .data_ifm_depth_out(ifm_depth),
+    .data_ofm_dim_out(ofm_dim),
+    .data_ofm_depth_out(ofm_depth),
+    .data_axi_mon_sel_out(axi_mon_sel),
     .ctrl_uart_tx_valid_out(mmio_uart_tx_valid_out),
+    .ctrl_uart_tx_word_valid_out(mmio_uart_tx_word_valid_out),
     .ctrl_uart_rx_ready_out(mmio_uart_rx_ready_out),
-    .ctrl_counter_rst_out(mmio_counter_rst_out)
+    .ctrl_uart_baud_we_out(mmio_uart_baud_we_out),
+    .ctrl_counter_rst_out(mmio_counter_rst_out),
+    .ctrl_dma_start_out(dma_start),
+    .ctrl_dma_dir_out(dma_dir),
+    .ctrl_dma_desc_start_out(dma_desc_start),
+    .ctrl_xcel_start_out(xcel_start),
+    .ctrl_axi_mon_clear_out(axi_mon_clear)
+  );
+
+  REGISTER_R_CE #(.N(16), .INIT(UART_SYMBOL_EDGE_TIME)) uart_baud_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(mmio_data_in[15:0]),
+    .q(uart_baud_value),
+    .ce(mmio_uart_baud_we_out)
   );
 
   wire cycle_counter_rst;
@@ -622,13 +726,20 @@ module Riscv151 #(
     .counter_out(inst_counter_value)
   );
 
-  wire [7:0] uart_tx_fifo_enq_data, uart_tx_fifo_deq_data;
+  // UART FIFOs, so the software can queue a whole line (or take in a burst
+  // of input) without waiting on the serial line. A transmit FIFO entry is
+  // one byte (store to 0x08) or one word (store to 0x0c), as {number of
+  // bytes - 1, data}; the bytes of an entry go out lowest first
+  localparam UART_TX_LOGDEPTH = 9;
+  localparam UART_RX_LOGDEPTH = 10;
+
+  wire [33:0] uart_tx_fifo_enq_data, uart_tx_fifo_deq_data;
   wire uart_tx_fifo_enq_ready, uart_tx_fifo_enq_valid;
   wire uart_tx_fifo_deq_ready, uart_tx_fifo_deq_valid;
 
   FIFO #(
-    .WIDTH(8),
-    .LOGDEPTH(5)
+    .WIDTH(2 + 32),
+    .LOGDEPTH(UART_TX_LOGDEPTH)
   ) uart_tx_fifo (
     .clk(clk),
     .rst(rst),
@@ -640,12 +751,27 @@ module Riscv151 #(
     .deq_data(uart_tx_fifo_deq_data)
   );
 
-  assign uart_tx_fifo_enq_data = mmio_uart_tx_out;
-  assign uart_tx_fifo_enq_valid = mmio_uart_tx_valid_out;
-  assign mmio_uart_tx_ready_in = uart_tx_fifo_enq_ready;
-  assign uart_tx_data_in = uart_tx_fifo_deq_data;
-  assign uart_tx_data_in_valid = uart_tx_fifo_deq_valid;
-  assign uart_tx_fifo_deq_ready = uart_tx_data_in_ready;
+  assign uart_tx_fifo_enq_data  = mmio_uart_tx_word_valid_out ? {2'd3, mmio_uart_tx_word_out} :
+                                                                {2'd0, 24'd0, mmio_uart_tx_out};
+  assign uart_tx_fifo_enq_valid = mmio_uart_tx_valid_out | mmio_uart_tx_word_valid_out;
+  assign mmio_uart_tx_ready_in  = uart_tx_fifo_enq_ready;
+
+  // Byte of the FIFO head entry being sent
+  wire [1:0] uart_tx_byte_value;
+  wire uart_tx_fire = uart_tx_data_in_valid & uart_tx_data_in_ready;
+  wire uart_tx_last = uart_tx_byte_value == uart_tx_fifo_deq_data[33:32];
+
+  REGISTER_R_CE #(.N(2), .INIT(0)) uart_tx_byte_reg (
+    .clk(clk),
+    .rst(rst | (uart_tx_fire & uart_tx_last)),
+    .d(uart_tx_byte_value + 1),
+    .q(uart_tx_byte_value),
+    .ce(uart_tx_fire)
+  );
+
+  assign uart_tx_data_in        = uart_tx_fifo_deq_data[uart_tx_byte_value * 8 +: 8];
+  assign uart_tx_data_in_valid  = uart_tx_fifo_deq_valid;
+  assign uart_tx_fifo_deq_ready = uart_tx_data_in_ready & uart_tx_last;
 
   wire [7:0] uart_rx_fifo_enq_data, uart_rx_fifo_deq_data;
   wire uart_rx_fifo_enq_ready, uart_rx_fifo_enq_valid;
@@ -653,7 +779,7 @@ module Riscv151 #(
 
   FIFO #(
     .WIDTH(8),
-    .LOGDEPTH(5)
+    .LOGDEPTH(UART_RX_LOGDEPTH)
   ) uart_rx_fifo (
     .clk(clk),
     .rst(rst),
@@ -672,6 +798,38 @@ module Riscv151 #(
   assign mmio_uart_rx_valid_in = uart_rx_fifo_deq_valid;
   assign uart_rx_fifo_deq_ready = mmio_uart_rx_ready_out;
 
+  // FIFO levels: transmit entries in use, received bytes waiting
+  wire [UART_TX_LOGDEPTH:0] uart_tx_count_value;
+  wire uart_tx_enq_fire = uart_tx_fifo_enq_valid & uart_tx_fifo_enq_ready;
+  wire uart_tx_deq_fire = uart_tx_fifo_deq_valid & uart_tx_fifo_deq_ready;
+
+  REGISTER_R_CE #(.N(UART_TX_LOGDEPTH + 1), .INIT(0)) uart_tx_count_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(uart_tx_count_value + uart_tx_enq_fire - uart_tx_deq_fire),
+    .q(uart_tx_count_value),
+    .ce(uart_tx_enq_fire ^ uart_tx_deq_fire)
+  );
+
+  wire [UART_RX_LOGDEPTH:0] uart_rx_count_value;
+  wire uart_rx_enq_fire = uart_rx_fifo_enq_valid & uart_rx_fifo_enq_ready;
+  wire uart_rx_deq_fire = uart_rx_fifo_deq_valid & uart_rx_fifo_deq_ready;
+
+  REGISTER_R_CE #(.N(UART_RX_LOGDEPTH + 1), .INIT(0)) uart_rx_count_reg (
+    .clk(clk),
+    .rst(rst),
+    .d(uart_rx_count_value + uart_rx_enq_fire - uart_rx_deq_fire),
+    .q(uart_rx_count_value),
+    .ce(uart_rx_enq_fire ^ uart_rx_deq_fire)
+  );
+
+  wire [15:0] uart_tx_free  = (1 << UART_TX_LOGDEPTH) - uart_tx_count_value;
+  wire [15:0] uart_rx_level = uart_rx_count_value;
+
+  assign mmio_uart_fifo_level_in = {uart_rx_level, uart_tx_free};
+  // Everything sent (the transmitter is ready only between bytes)
+  assign mmio_uart_tx_idle_in = ~uart_tx_fifo_deq_valid & uart_tx_data_in_ready;
+
   assign inst_counter_opcode_in = inst_ex_in[6:0];
   assign inst_counter_rst = rst | mmio_counter_rst_out;
   assign mmio_cycle_counter_in = cycle_counter_value;
@@ -683,12 +841,13 @@ module Riscv151 #(
 
 
   assign dmem_dina = mem_din;
-  assign imem_dina = mem_din;
+  assign imem_dina = dma_imem_we ? dma_imem_din : mem_din;
 
   // Note: see Address Space table
   assign dmem_wea = ((alu_out[31:28] & 4'b1101) == 4'b0001 && ctrl_mem_we_ex_in == 1'b1) ? mem_din_mask : 4'h0;
   // Instruction Memory can be writted only if PC[30] == 1'b1;
-  assign imem_wea = (((alu_out[31:29] & 3'b111) == 3'b001) && (pc_ex_in[30] == 1'b1) && (ctrl_mem_we_ex_in == 1'b1)) ? mem_din_mask : 4'h0;
+  assign imem_wea = dma_imem_we ? dma_imem_wbe :
+                    (((alu_out[31:29] & 3'b111) == 3'b001) && (pc_ex_in[30] == 1'b1) && (ctrl_mem_we_ex_in == 1'b1)) ? mem_din_mask : 4'h0;
 
 
   wire [1:0] mem_mask_byte_addr;
@@ -2,9 +2,16 @@
 
 module z1top_axi #(
   parameter AXI_AWIDTH = 32,
+  // DDR data path width (32, 64 or 128). The DMA moves 32-bit DMem words
+  // and goes through axi_upsizer; the accelerator reads full-width beats
   parameter AXI_DWIDTH = 32,
   parameter AXI_MAX_BURST_LEN = 256,
-  parameter CPU_CLOCK_FREQ = 50_000_000
+  // AXI bursts in flight per direction in the AXI adapter
+  parameter AXI_MAX_OUTSTANDING = 4,
+  parameter CPU_CLOCK_FREQ = 50_000_000,
+  // The accelerator runs in its own clock domain, generated from the 125 MHz
+  // board clock. The CPU, DMA and AXI side run on axi_clk (CPU_CLOCK_FREQ)
+  parameter XCEL_CLOCK_PERIOD = 10
 ) (
   input  CLK_125MHZ_FPGA,
   input  [3:0] BUTTONS,
@@ -66,6 +73,23 @@ module z1top_axi #(
 );
 
   wire cpu_clk;
+  wire xcel_clk, xcel_clk_locked;
+
+  // Clocking wizard IP from Vivado (wrapper of the PLLE module)
+  // Generate the accelerator clock (1000 / XCEL_CLOCK_PERIOD MHz) from 125 MHz clock
+  // PLL FREQ = (CLKFBOUT_MULT_F * 1000 / (CLKINx_PERIOD * DIVCLK_DIVIDE) must be within (800.000 MHz - 1600.000 MHz)
+  // CLKOUTx_PERIOD = CLKINx_PERIOD x DIVCLK_DIVIDE x CLKOUT0_DIVIDE / CLKFBOUT_MULT_F
+  clk_wiz #(
+    .CLKIN1_PERIOD(8),
+    .CLKFBOUT_MULT_F(8),
+    .DIVCLK_DIVIDE(1),
+    .CLKOUT0_DIVIDE(XCEL_CLOCK_PERIOD)
+  ) xcel_clk_wiz (
+    .clk_out1(xcel_clk),        // output
+    .reset(1'b0),               // input
+    .locked(xcel_clk_locked),   // output
+    .clk_in1(CLK_125MHZ_FPGA)   // input
+  );
 
   // Button parser
   // Sample the button signal every 500us
@@ -93,8 +117,15 @@ module z1top_axi #(
 
   wire dma_start, dma_done, dma_idle, dma_dir;
   wire [31:0] dma_src_addr, dma_dst_addr, dma_len;
+  wire dma_desc_start;
+  wire [31:0] dma_desc_addr, dma_desc_count;
+  wire [31:0] dma_sum, dma_crc;
+
+  wire [31:0] axi_mon_sel, axi_mon_value;
+  wire axi_mon_clear;
 
   wire xcel_start, xcel_idle, xcel_done;
+  wire [31:0] xcel_progress;
 
   wire [31:0] ifm_ddr_addr, wt_ddr_addr, ofm_ddr_addr;
   wire [31:0] ifm_dim;
@@ -110,6 +141,16 @@ module z1top_axi #(
   wire [3:0]  dmem_web;
   wire dmem_enb;
 
+  wire [DMEM_AWIDTH-1:0] dma_dmem_addr, xcel_dmem_addr;
+  wire [DMEM_DWIDTH-1:0] dma_dmem_din, dma_dmem_dout;
+  wire [DMEM_DWIDTH-1:0] xcel_dmem_din, xcel_dmem_dout;
+  wire [3:0] dma_dmem_wbe, xcel_dmem_wbe;
+  wire dma_dmem_en;
+
+  wire [DMEM_AWIDTH-1:0] dma_imem_addr;
+  wire [DMEM_DWIDTH-1:0] dma_imem_din;
+  wire [3:0] dma_imem_wbe;
+
   Riscv151 #(
     .CPU_CLOCK_FREQ(CPU_CLOCK_FREQ)
   ) cpu (
@@ -123,6 +164,7 @@ module z1top_axi #(
     .xcel_start(xcel_start),
     .xcel_idle(xcel_idle & (~xcel_start)),
     .xcel_done(xcel_done & (~xcel_start)),
+    .xcel_progress(xcel_progress),
 
     .ifm_ddr_addr(ifm_ddr_addr),
     .wt_ddr_addr(wt_ddr_addr),
@@ -136,19 +178,34 @@ module z1top_axi #(
 
     // DMA Interfacing
     .dma_start(dma_start),
-    .dma_done(dma_done & (~dma_start)),
-    .dma_idle(dma_idle & (~dma_start)),
+    .dma_done(dma_done & (~dma_start) & (~dma_desc_start)),
+    .dma_idle(dma_idle & (~dma_start) & (~dma_desc_start)),
     .dma_dir(dma_dir),
     .dma_src_addr(dma_src_addr),
     .dma_dst_addr(dma_dst_addr),
     .dma_len(dma_len),
+    .dma_desc_start(dma_desc_start),
+    .dma_desc_addr(dma_desc_addr),
+    .dma_desc_count(dma_desc_count),
+    .dma_sum(dma_sum),
+    .dma_crc(dma_crc),
+
+    // AXI traffic monitor readout
+    .axi_mon_sel(axi_mon_sel),
+    .axi_mon_clear(axi_mon_clear),
+    .axi_mon_value(axi_mon_value),
 
     // Riscv151 DMem Interfacing
     .dmem_addrb(dmem_addrb),
     .dmem_dinb(dmem_dinb),
     .dmem_doutb(dmem_doutb),
     .dmem_web(dmem_web),
-    .dmem_enb(dmem_enb)
+    .dmem_enb(dmem_enb),
+
+    // Riscv151 IMem Interfacing (DDR -> IMem DMA transfers)
+    .dma_imem_addr(dma_imem_addr),
+    .dma_imem_din(dma_imem_din),
+    .dma_imem_wbe(dma_imem_wbe)
   );
 
   assign LEDS[5:4] = 2'b11;
@@ -172,10 +229,13 @@ module z1top_axi #(
   wire [AXI_DWIDTH-1:0] core_write_data;
   wire                  core_write_data_valid;
   wire                  core_write_data_ready;
+  wire                  core_write_idle;
 
   axi_mm_adapter #(
     .AXI_AWIDTH(AXI_AWIDTH),
-    .AXI_DWIDTH(AXI_DWIDTH)
+    .AXI_DWIDTH(AXI_DWIDTH),
+    .AXI_MAX_BURST_LEN(AXI_MAX_BURST_LEN),
+    .AXI_MAX_OUTSTANDING(AXI_MAX_OUTSTANDING)
   ) axi_mm_core (
     .clk(axi_clk),
     .resetn(axi_resetn | ~reset),
@@ -233,9 +293,32 @@ module z1top_axi #(
     .core_write_burst(core_write_burst),                 // input
     .core_write_data(core_write_data),                   // input
     .core_write_data_valid(core_write_data_valid),       // input
-    .core_write_data_ready(core_write_data_ready)        // output
+    .core_write_data_ready(core_write_data_ready),       // output
+    .core_write_idle(core_write_idle)                    // output
   );
 
+  // DMA side (one DMem word per beat)
+  wire                   dma_n_read_request_valid;
+  wire                   dma_n_read_request_ready;
+  wire [AXI_AWIDTH-1:0]  dma_n_read_addr;
+  wire [31:0]            dma_n_read_len;
+  wire [2:0]             dma_n_read_size;
+  wire [1:0]             dma_n_read_burst;
+  wire [DMEM_DWIDTH-1:0] dma_n_read_data;
+  wire                   dma_n_read_data_valid;
+  wire                   dma_n_read_data_ready;
+
+  wire                   dma_n_write_request_valid;
+  wire                   dma_n_write_request_ready;
+  wire [AXI_AWIDTH-1:0]  dma_n_write_addr;
+  wire [31:0]            dma_n_write_len;
+  wire [2:0]             dma_n_write_size;
+  wire [1:0]             dma_n_write_burst;
+  wire [DMEM_DWIDTH-1:0] dma_n_write_data;
+  wire                   dma_n_write_data_valid;
+  wire                   dma_n_write_data_ready;
+
+  // Arbiter side (AXI_DWIDTH per beat)
   wire                  dma_read_request_valid;
   wire                  dma_read_request_ready;
   wire [AXI_AWIDTH-1:0] dma_read_addr;
@@ -255,35 +338,37 @@ module z1top_axi #(
   wire [AXI_DWIDTH-1:0] dma_write_data;
   wire                  dma_write_data_valid;
   wire                  dma_write_data_ready;
+  wire                  dma_write_idle;
 
   dma_controller #(
     .AXI_AWIDTH(AXI_AWIDTH),
-    .AXI_DWIDTH(AXI_DWIDTH),
+    .AXI_DWIDTH(DMEM_DWIDTH),
     .DMEM_AWIDTH(DMEM_AWIDTH),
     .DMEM_DWIDTH(DMEM_DWIDTH)
   ) dma_unit (
     .clk(axi_clk),
     .resetn(axi_resetn | ~reset),
 
-    .dma_read_request_valid(dma_read_request_valid),
-    .dma_read_request_ready(dma_read_request_ready),
-    .dma_read_addr(dma_read_addr),
-    .dma_read_len(dma_read_len),
-    .dma_read_size(dma_read_size),
-    .dma_read_burst(dma_read_burst),
-    .dma_read_data(dma_read_data),
-    .dma_read_data_valid(dma_read_data_valid),
-    .dma_read_data_ready(dma_read_data_ready),
-
-    .dma_write_request_valid(dma_write_request_valid),
-    .dma_write_request_ready(dma_write_request_ready),
-    .dma_write_addr(dma_write_addr),
-    .dma_write_len(dma_write_len),
-    .dma_write_size(dma_write_size),
-    .dma_write_burst(dma_write_burst),
-    .dma_write_data(dma_write_data),
-    .dma_write_data_valid(dma_write_data_valid),
-    .dma_write_data_ready(dma_write_data_ready),
+    .dma_read_request_valid(dma_n_read_request_valid),
+    .dma_read_request_ready(dma_n_read_request_ready),
+    .dma_read_addr(dma_n_read_addr),
+    .dma_read_len(dma_n_read_len),
+    .dma_read_size(dma_n_read_size),
+    .dma_read_burst(dma_n_read_burst),
+    .dma_read_data(dma_n_read_data),
+    .dma_read_data_valid(dma_n_read_data_valid),
+    .dma_read_data_ready(dma_n_read_data_ready),
+
+    .dma_write_request_valid(dma_n_write_request_valid),
+    .dma_write_request_ready(dma_n_write_request_ready),
+    .dma_write_addr(dma_n_write_addr),
+    .dma_write_len(dma_n_write_len),
+    .dma_write_size(dma_n_write_size),
+    .dma_write_burst(dma_n_write_burst),
+    .dma_write_data(dma_n_write_data),
+    .dma_write_data_valid(dma_n_write_data_valid),
+    .dma_write_data_ready(dma_n_write_data_ready),
+    .dma_write_idle(dma_write_idle),
 
     .dma_start(dma_start),
     .dma_done(dma_done),
@@ -292,12 +377,71 @@ module z1top_axi #(
     .dma_src_addr(dma_src_addr),
     .dma_dst_addr(dma_dst_addr),
     .dma_len(dma_len),
+    .dma_desc_start(dma_desc_start),
+    .dma_desc_addr(dma_desc_addr),
+    .dma_desc_count(dma_desc_count),
+    .dma_sum(dma_sum),
+    .dma_crc(dma_crc),
+
+    .dmem_addr(dma_dmem_addr),
+    .dmem_din(dma_dmem_din),
+    .dmem_dout(dma_dmem_dout),
+    .dmem_wbe(dma_dmem_wbe),
+    .dmem_en(dma_dmem_en),
+
+    .imem_addr(dma_imem_addr),
+    .imem_din(dma_imem_din),
+    .imem_wbe(dma_imem_wbe)
+  );
 
-    .dmem_addr(dmem_addrb),
-    .dmem_din(dmem_dinb),
-    .dmem_dout(dmem_doutb),
-    .dmem_wbe(dmem_web),
-    .dmem_en(dmem_enb)
+  // Packs the DMA's word beats into AXI_DWIDTH beats (passthrough at 32 bits)
+  axi_upsizer #(
+    .AXI_AWIDTH(AXI_AWIDTH),
+    .NARROW_DWIDTH(DMEM_DWIDTH),
+    .WIDE_DWIDTH(AXI_DWIDTH)
+  ) dma_upsizer (
+    .clk(axi_clk),
+    .rst(~axi_resetn | reset),
+
+    .narrow_read_request_valid(dma_n_read_request_valid),
+    .narrow_read_request_ready(dma_n_read_request_ready),
+    .narrow_read_addr(dma_n_read_addr),
+    .narrow_read_len(dma_n_read_len),
+    .narrow_read_size(dma_n_read_size),
+    .narrow_read_burst(dma_n_read_burst),
+    .narrow_read_data(dma_n_read_data),
+    .narrow_read_data_valid(dma_n_read_data_valid),
+    .narrow_read_data_ready(dma_n_read_data_ready),
+
+    .narrow_write_request_valid(dma_n_write_request_valid),
+    .narrow_write_request_ready(dma_n_write_request_ready),
+    .narrow_write_addr(dma_n_write_addr),
+    .narrow_write_len(dma_n_write_len),
+    .narrow_write_size(dma_n_write_size),
+    .narrow_write_burst(dma_n_write_burst),
+    .narrow_write_data(dma_n_write_data),
+    .narrow_write_data_valid(dma_n_write_data_valid),
+    .narrow_write_data_ready(dma_n_write_data_ready),
+
+    .wide_read_request_valid(dma_read_request_valid),
+    .wide_read_request_ready(dma_read_request_ready),
+    .wide_read_addr(dma_read_addr),
+    .wide_read_len(dma_read_len),
+    .wide_read_size(dma_read_size),
+    .wide_read_burst(dma_read_burst),
+    .wide_read_data(dma_read_data),
+    .wide_read_data_valid(dma_read_data_valid),
+    .wide_read_data_ready(dma_read_data_ready),
+
+    .wide_write_request_valid(dma_write_request_valid),
+    .wide_write_request_ready(dma_write_request_ready),
+    .wide_write_addr(dma_write_addr),
+    .wide_write_len(dma_write_len),
+    .wide_write_size(dma_write_size),
+    .wide_write_burst(dma_write_burst),
+    .wide_write_data(dma_write_data),
+    .wide_write_data_valid(dma_write_data_valid),
+    .wide_write_data_ready(dma_write_data_ready)
   );
 
   wire                  xcel_read_request_valid;
@@ -319,59 +463,237 @@ module z1top_axi #(
   wire [AXI_DWIDTH-1:0] xcel_write_data;
   wire                  xcel_write_data_valid;
   wire                  xcel_write_data_ready;
+  wire                  xcel_write_idle;
 
-  xcel_naive #(
-    .AXI_AWIDTH(AXI_AWIDTH),
-    .AXI_DWIDTH(AXI_DWIDTH)
-  ) xcel_unit (
-    .clk(axi_clk),
-    .rst(~axi_resetn | reset),
-
-    .xcel_read_request_valid(xcel_read_request_valid),
-    .xcel_read_request_ready(xcel_read_request_ready),
-    .xcel_read_addr(xcel_read_addr),
-    .xcel_read_len(xcel_read_len),
-    .xcel_read_size(xcel_read_size),
-    .xcel_read_burst(xcel_read_burst),
-    .xcel_read_data(xcel_read_data),
-    .xcel_read_data_valid(xcel_read_data_valid),
-    .xcel_read_data_ready(xcel_read_data_ready),
+  // Accelerator clock domain (acc_*)
+  wire acc_rst;
 
-    .xcel_write_request_valid(xcel_write_request_valid),
-    .xcel_write_request_ready(xcel_write_request_ready),
-    .xcel_write_addr(xcel_write_addr),
-    .xcel_write_len(xcel_write_len),
-    .xcel_write_size(xcel_write_size),
-    .xcel_write_burst(xcel_write_burst),
-    .xcel_write_data(xcel_write_data),
-    .xcel_write_data_valid(xcel_write_data_valid),
-    .xcel_write_data_ready(xcel_write_data_ready),
+  // Hold the accelerator in reset until its clock is locked
+  synchronizer acc_rst_sync (
+    .async_signal(~axi_resetn | reset | ~xcel_clk_locked),
+    .clk(xcel_clk),
+    .sync_signal(acc_rst)
+  );
 
-    .xcel_start(xcel_start),
-    .xcel_done(xcel_done),
-    .xcel_idle(xcel_idle),
+  wire acc_start, acc_done, acc_idle;
+  wire [31:0] acc_progress;
+
+  wire [31:0] acc_ifm_ddr_addr, acc_wt_ddr_addr, acc_ofm_ddr_addr;
+  wire [31:0] acc_ifm_dim, acc_ifm_depth;
+  wire [31:0] acc_ofm_dim, acc_ofm_depth;
+
+  wire                  acc_read_request_valid;
+  wire                  acc_read_request_ready;
+  wire [AXI_AWIDTH-1:0] acc_read_addr;
+  wire [31:0]           acc_read_len;
+  wire [2:0]            acc_read_size;
+  wire [1:0]            acc_read_burst;
+  wire [AXI_DWIDTH-1:0] acc_read_data;
+  wire                  acc_read_data_valid;
+  wire                  acc_read_data_ready;
+
+  wire                  acc_write_request_valid;
+  wire                  acc_write_request_ready;
+  wire [AXI_AWIDTH-1:0] acc_write_addr;
+  wire [31:0]           acc_write_len;
+  wire [2:0]            acc_write_size;
+  wire [1:0]            acc_write_burst;
+  wire [AXI_DWIDTH-1:0] acc_write_data;
+  wire                  acc_write_data_valid;
+  wire                  acc_write_data_ready;
+
+  wire                   acc_dmem_request_valid;
+  wire                   acc_dmem_request_ready;
+  wire [DMEM_AWIDTH-1:0] acc_dmem_addr;
+  wire [DMEM_DWIDTH-1:0] acc_dmem_din, acc_dmem_dout;
+  wire [3:0]             acc_dmem_wbe;
+  wire                   acc_dmem_dout_valid;
 
-    .ifm_ddr_addr(ifm_ddr_addr),
-    .wt_ddr_addr(wt_ddr_addr),
-    .ofm_ddr_addr(ofm_ddr_addr),
+  xcel_naive #(
+    .AXI_AWIDTH(AXI_AWIDTH),
+    .AXI_DWIDTH(AXI_DWIDTH),
+    .DMEM_AWIDTH(DMEM_AWIDTH),
+    .DMEM_DWIDTH(DMEM_DWIDTH)
+  ) xcel_unit (
+    .clk(xcel_clk),
+    .rst(acc_rst),
+
+    .xcel_read_request_valid(acc_read_request_valid),
+    .xcel_read_request_ready(acc_read_request_ready),
+    .xcel_read_addr(acc_read_addr),
+    .xcel_read_len(acc_read_len),
+    .xcel_read_size(acc_read_size),
+    .xcel_read_burst(acc_read_burst),
+    .xcel_read_data(acc_read_data),
+    .xcel_read_data_valid(acc_read_data_valid),
+    .xcel_read_data_ready(acc_read_data_ready),
+
+    .xcel_write_request_valid(acc_write_request_valid),
+    .xcel_write_request_ready(acc_write_request_ready),
+    .xcel_write_addr(acc_write_addr),
+    .xcel_write_len(acc_write_len),
+    .xcel_write_size(acc_write_size),
+    .xcel_write_burst(acc_write_burst),
+    .xcel_write_data(acc_write_data),
+    .xcel_write_data_valid(acc_write_data_valid),
+    .xcel_write_data_ready(acc_write_data_ready),
+
+    .xcel_dmem_request_valid(acc_dmem_request_valid),
+    .xcel_dmem_request_ready(acc_dmem_request_ready),
+    .xcel_dmem_addr(acc_dmem_addr),
+    .xcel_dmem_din(acc_dmem_din),
+    .xcel_dmem_wbe(acc_dmem_wbe),
+    .xcel_dmem_dout(acc_dmem_dout),
+    .xcel_dmem_dout_valid(acc_dmem_dout_valid),
+
+    .xcel_start(acc_start),
+    .xcel_done(acc_done),
+    .xcel_idle(acc_idle),
+    .xcel_progress(acc_progress),
+
+    .ifm_ddr_addr(acc_ifm_ddr_addr),
+    .wt_ddr_addr(acc_wt_ddr_addr),
+    .ofm_ddr_addr(acc_ofm_ddr_addr),
+
+    .ifm_dim(acc_ifm_dim),
+    .ifm_depth(acc_ifm_depth),
+
+    .ofm_dim(acc_ofm_dim),
+    .ofm_depth(acc_ofm_depth)
+  );
 
-    .ifm_dim(ifm_dim),
-    .ifm_depth(ifm_depth),
+  wire                   xcel_dmem_request_valid;
+  wire                   xcel_dmem_request_ready;
+  wire                   xcel_dmem_dout_valid;
 
-    .ofm_dim(ofm_dim),
-    .ofm_depth(ofm_depth)
+  // Clock-domain crossing between the accelerator and the rest of the system
+  xcel_cdc #(
+    .AXI_AWIDTH(AXI_AWIDTH),
+    .AXI_DWIDTH(AXI_DWIDTH),
+    .DMEM_AWIDTH(DMEM_AWIDTH),
+    .DMEM_DWIDTH(DMEM_DWIDTH)
+  ) xcel_cdc_unit (
+    .sys_clk(axi_clk),
+    .sys_rst(~axi_resetn | reset),
+    .xcel_clk(xcel_clk),
+    .xcel_rst(acc_rst),
+
+    // Riscv151 IO
+    .sys_xcel_start(xcel_start),
+    .sys_xcel_done(xcel_done),
+    .sys_xcel_idle(xcel_idle),
+    .sys_xcel_progress(xcel_progress),
+
+    .sys_ifm_ddr_addr(ifm_ddr_addr),
+    .sys_wt_ddr_addr(wt_ddr_addr),
+    .sys_ofm_ddr_addr(ofm_ddr_addr),
+    .sys_ifm_dim(ifm_dim),
+    .sys_ifm_depth(ifm_depth),
+    .sys_ofm_dim(ofm_dim),
+    .sys_ofm_depth(ofm_depth),
+
+    // Arbiter
+    .sys_read_request_valid(xcel_read_request_valid),
+    .sys_read_request_ready(xcel_read_request_ready),
+    .sys_read_addr(xcel_read_addr),
+    .sys_read_len(xcel_read_len),
+    .sys_read_size(xcel_read_size),
+    .sys_read_burst(xcel_read_burst),
+    .sys_read_data(xcel_read_data),
+    .sys_read_data_valid(xcel_read_data_valid),
+    .sys_read_data_ready(xcel_read_data_ready),
+
+    .sys_write_request_valid(xcel_write_request_valid),
+    .sys_write_request_ready(xcel_write_request_ready),
+    .sys_write_addr(xcel_write_addr),
+    .sys_write_len(xcel_write_len),
+    .sys_write_size(xcel_write_size),
+    .sys_write_burst(xcel_write_burst),
+    .sys_write_data(xcel_write_data),
+    .sys_write_data_valid(xcel_write_data_valid),
+    .sys_write_data_ready(xcel_write_data_ready),
+    .sys_write_idle(xcel_write_idle),
+
+    // DMem arbiter
+    .sys_dmem_request_valid(xcel_dmem_request_valid),
+    .sys_dmem_request_ready(xcel_dmem_request_ready),
+    .sys_dmem_addr(xcel_dmem_addr),
+    .sys_dmem_din(xcel_dmem_din),
+    .sys_dmem_wbe(xcel_dmem_wbe),
+    .sys_dmem_dout(xcel_dmem_dout),
+    .sys_dmem_dout_valid(xcel_dmem_dout_valid),
+
+    // Accelerator
+    .xcel_start(acc_start),
+    .xcel_done(acc_done),
+    .xcel_idle(acc_idle),
+    .xcel_progress(acc_progress),
+
+    .xcel_ifm_ddr_addr(acc_ifm_ddr_addr),
+    .xcel_wt_ddr_addr(acc_wt_ddr_addr),
+    .xcel_ofm_ddr_addr(acc_ofm_ddr_addr),
+    .xcel_ifm_dim(acc_ifm_dim),
+    .xcel_ifm_depth(acc_ifm_depth),
+    .xcel_ofm_dim(acc_ofm_dim),
+    .xcel_ofm_depth(acc_ofm_depth),
+
+    .xcel_read_request_valid(acc_read_request_valid),
+    .xcel_read_request_ready(acc_read_request_ready),
+    .xcel_read_addr(acc_read_addr),
+    .xcel_read_len(acc_read_len),
+    .xcel_read_size(acc_read_size),
+    .xcel_read_burst(acc_read_burst),
+    .xcel_read_data(acc_read_data),
+    .xcel_read_data_valid(acc_read_data_valid),
+    .xcel_read_data_ready(acc_read_data_ready),
+
+    .xcel_write_request_valid(acc_write_request_valid),
+    .xcel_write_request_ready(acc_write_request_ready),
+    .xcel_write_addr(acc_write_addr),
+    .xcel_write_len(acc_write_len),
+    .xcel_write_size(acc_write_size),
+    .xcel_write_burst(acc_write_burst),
+    .xcel_write_data(acc_write_data),
+    .xcel_write_data_valid(acc_write_data_valid),
+    .xcel_write_data_ready(acc_write_data_ready),
+
+    .xcel_dmem_request_valid(acc_dmem_request_valid),
+    .xcel_dmem_request_ready(acc_dmem_request_ready),
+    .xcel_dmem_addr(acc_dmem_addr),
+    .xcel_dmem_din(acc_dmem_din),
+    .xcel_dmem_wbe(acc_dmem_wbe),
+    .xcel_dmem_dout(acc_dmem_dout),
+    .xcel_dmem_dout_valid(acc_dmem_dout_valid)
   );
 
-  wire xcel_busy;
-
-  // High when the accelerator is running
-  // Low when the accelerator is done (but yet to be restarted)
-  REGISTER_R_CE #(.N(1)) acc_busy_reg (
+  // Arbiter logic between {DMA, Accelerator} and Riscv151 DMem port b
+  dmem_arbiter #(
+    .DMEM_AWIDTH(DMEM_AWIDTH),
+    .DMEM_DWIDTH(DMEM_DWIDTH)
+  ) dmem_arb (
     .clk(axi_clk),
-    .rst((xcel_done & ~xcel_start) | ~axi_resetn | reset),
-    .d(1'b1),
-    .q(xcel_busy),
-    .ce(xcel_start)
+    .rst(~axi_resetn | reset),
+
+    .dmem_addr(dmem_addrb),          // output
+    .dmem_din(dmem_dinb),            // output
+    .dmem_dout(dmem_doutb),          // input
+    .dmem_wbe(dmem_web),             // output
+    .dmem_en(dmem_enb),              // output
+
+    .dma_dmem_addr(dma_dmem_addr),
+    .dma_dmem_din(dma_dmem_din),
+    .dma_dmem_dout(dma_dmem_dout),
+    .dma_dmem_wbe(dma_dmem_wbe),
+    .dma_dmem_en(dma_dmem_en),
+    .dma_idle(dma_idle),
+
+    .xcel_dmem_request_valid(xcel_dmem_request_valid),
+    .xcel_dmem_request_ready(xcel_dmem_request_ready),
+    .xcel_dmem_addr(xcel_dmem_addr),
+    .xcel_dmem_din(xcel_dmem_din),
+    .xcel_dmem_wbe(xcel_dmem_wbe),
+    .xcel_dmem_dout(xcel_dmem_dout),
+    .xcel_dmem_dout_valid(xcel_dmem_dout_valid)
   );
 
   // Arbiter logic between {DMA, Accelerator} and {AXI Adapter} <-> DDR
@@ -379,8 +701,8 @@ module z1top_axi #(
     .AXI_AWIDTH(AXI_AWIDTH),
     .AXI_DWIDTH(AXI_DWIDTH)
   ) arb (
-
-    .xcel_busy(xcel_busy),
+    .clk(axi_clk),
+    .rst(~axi_resetn | reset),
 
      // Core interfacing (with the AXI Adapter)
     .core_read_request_valid(core_read_request_valid),   // output
@@ -402,6 +724,7 @@ module z1top_axi #(
     .core_write_data(core_write_data),                   // output
     .core_write_data_valid(core_write_data_valid),       // output
     .core_write_data_ready(core_write_data_ready),       // input
+    .core_write_idle(core_write_idle),                   // input
 
     // DMA Controller interfacing
     .dma_read_request_valid(dma_read_request_valid),
@@ -423,6 +746,7 @@ module z1top_axi #(
     .dma_write_data(dma_write_data),
     .dma_write_data_valid(dma_write_data_valid),
     .dma_write_data_ready(dma_write_data_ready),
+    .dma_write_idle(dma_write_idle),
 
     // Accelerator interfacing
     .xcel_read_request_valid(xcel_read_request_valid),
@@ -443,7 +767,33 @@ module z1top_axi #(
     .xcel_write_burst(xcel_write_burst),
     .xcel_write_data(xcel_write_data),
     .xcel_write_data_valid(xcel_write_data_valid),
-    .xcel_write_data_ready(xcel_write_data_ready)
+    .xcel_write_data_ready(xcel_write_data_ready),
+    .xcel_write_idle(xcel_write_idle)
+  );
+
+  // Traffic monitor at the AXI adapter boundary; the master of a request is
+  // the client the arbiter grants it to
+  axi_monitor axi_mon (
+    .clk(axi_clk),
+    .rst(~axi_resetn | reset),
+    .clear(axi_mon_clear),
+
+    .read_request_valid(core_read_request_valid),
+    .read_request_ready(core_read_request_ready),
+    .read_len(core_read_len),
+    .read_master(xcel_read_request_ready),
+    .read_data_valid(core_read_data_valid),
+    .read_data_ready(core_read_data_ready),
+
+    .write_request_valid(core_write_request_valid),
+    .write_request_ready(core_write_request_ready),
+    .write_len(core_write_len),
+    .write_master(xcel_write_request_ready),
+    .write_data_valid(core_write_data_valid),
+    .write_data_ready(core_write_data_ready),
+
+    .sel(axi_mon_sel[5:0]),
+    .value(axi_mon_value)
   );
 
 endmodule
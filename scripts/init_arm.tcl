@@ -13,5 +13,10 @@ targets -set -nocase -filter {name =~ "ARM*#0"} -index 0
 rst -processor
 targets -set -nocase -filter {name =~ "ARM*#0"} -index 0
 dow system/Debug/system.elf
+# Optionally stage a program image in DDR for the BIOS ddrboot command,
+# e.g. DDRBOOT_BIN=../software/lenet/lenet.bin DDRBOOT_ADDR=0x01000000
+if {[info exists ::env(DDRBOOT_BIN)]} {
+  dow -data $::env(DDRBOOT_BIN) $::env(DDRBOOT_ADDR)
+}
 configparams force-mem-access 0
 con
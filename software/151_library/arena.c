@@ -0,0 +1,41 @@
+#include "arena.h"
+
+void arena_init(arena_t* a, void* base, uint32_t size)
+{
+    // Word align the start, and keep whole words
+    uint32_t skip = (4 - ((uint32_t)base & 3)) & 3;
+    a->base = (uint8_t*)base + skip;
+    a->size = (size > skip) ? (size - skip) & ~3 : 0;
+    a->used = 0;
+    a->peak = 0;
+}
+
+void* arena_alloc(arena_t* a, uint32_t n)
+{
+    uint32_t bytes = (n + 3) & ~3;
+    void* p;
+
+    if (bytes > a->size - a->used)
+        return NULL;
+    p = a->base + a->used;
+    a->used += bytes;
+    if (a->used > a->peak)
+        a->peak = a->used;
+    return p;
+}
+
+uint32_t arena_mark(const arena_t* a)
+{
+    return a->used;
+}
+
+void arena_release(arena_t* a, uint32_t mark)
+{
+    if (mark < a->used)
+        a->used = mark;
+}
+
+void arena_reset(arena_t* a)
+{
+    a->used = 0;
+}
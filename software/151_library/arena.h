@@ -0,0 +1,26 @@
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include "types.h"
+
+// Bump allocator over a fixed buffer: allocations are word aligned and are
+// only freed all together (arena_reset) or back to a mark (arena_release)
+typedef struct {
+    uint8_t* base;
+    uint32_t size; // bytes
+    uint32_t used;
+    uint32_t peak; // largest used since arena_init
+} arena_t;
+
+void arena_init(arena_t* a, void* base, uint32_t size);
+
+// n bytes, or NULL if the arena is full
+void* arena_alloc(arena_t* a, uint32_t n);
+
+// Free everything allocated after arena_mark returned mark
+uint32_t arena_mark(const arena_t* a);
+void arena_release(arena_t* a, uint32_t mark);
+
+void arena_reset(arena_t* a);
+
+#endif
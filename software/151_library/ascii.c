@@ -38,19 +38,15 @@ DEFINE_FROM_ASCII_HEX(uint8)
 DEFINE_FROM_ASCII_HEX(uint16)
 DEFINE_FROM_ASCII_HEX(uint32)
 
+static const int8_t hex_digits[16] = "0123456789abcdef";
+
 #define DEFINE_TO_ASCII_HEX(type) \
 int8_t* type##_to_ascii_hex(type##_t x, int8_t* buffer, uint32_t n) \
 { \
     uint32_t i = 0; \
     uint32_t m = ((sizeof(type##_t) / sizeof(uint8_t)) << 1); \
     for ( ; i < m && i + 1 < n; i++) { \
-        int8_t t = (x >> ((m - 1 - i) << 2)) & 0xf; \
-        if (t >= 0 && t <= 9) { \
-            buffer[i] = t + '0'; \
-        } \
-        if (t >= 0xa && t <= 0xf) { \
-            buffer[i] = (t - 0xa) + 'a'; \
-        } \
+        buffer[i] = hex_digits[(x >> ((m - 1 - i) << 2)) & 0xf]; \
     } \
     buffer[i] = '\0'; \
     return buffer; \
@@ -59,3 +55,37 @@ int8_t* type##_to_ascii_hex(type##_t x, int8_t* buffer, uint32_t n) \
 DEFINE_TO_ASCII_HEX(uint8)
 DEFINE_TO_ASCII_HEX(uint16)
 DEFINE_TO_ASCII_HEX(uint32)
+
+// No divider: each digit is the number of times its power of ten can be
+// subtracted (at most 9)
+static const uint32_t powers_of_10[10] = {
+    1000000000, 100000000, 10000000, 1000000, 100000,
+    10000, 1000, 100, 10, 1
+};
+
+int8_t* uint32_to_ascii_dec(uint32_t x, int8_t* buffer, uint32_t n)
+{
+    uint32_t i = 0, p = 0;
+    // Skip the leading zeros, keep at least one digit
+    while (p < 9 && x < powers_of_10[p])
+        p++;
+    for ( ; p < 10 && i + 1 < n; p++, i++) {
+        int8_t d = '0';
+        while (x >= powers_of_10[p]) {
+            x -= powers_of_10[p];
+            d++;
+        }
+        buffer[i] = d;
+    }
+    buffer[i] = '\0';
+    return buffer;
+}
+
+int8_t* int32_to_ascii_dec(int32_t x, int8_t* buffer, uint32_t n)
+{
+    if (x >= 0 || n < 2)
+        return uint32_to_ascii_dec(x, buffer, n);
+    buffer[0] = '-';
+    uint32_to_ascii_dec(-(uint32_t)x, buffer + 1, n - 1);
+    return buffer;
+}
@@ -24,4 +24,8 @@ DECLARE_TO_ASCII_HEX(uint8)
 DECLARE_TO_ASCII_HEX(uint16)
 DECLARE_TO_ASCII_HEX(uint32)
 
+// Decimal, without leading zeros (up to 11 characters and the '\0')
+int8_t* uint32_to_ascii_dec(uint32_t x, int8_t* buffer, uint32_t n);
+int8_t* int32_to_ascii_dec(int32_t x, int8_t* buffer, uint32_t n);
+
 #endif
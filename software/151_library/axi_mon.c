@@ -0,0 +1,64 @@
+#include "axi_mon.h"
+#include "ascii.h"
+#include "uart.h"
+#include "memory_map.h"
+
+#define BUF_LEN 32
+
+static uint32_t axi_mon_read(uint32_t sel)
+{
+    AXI_MON_SEL = sel;
+    return AXI_MON_VALUE;
+}
+
+void axi_mon_clear(void)
+{
+    AXI_MON_CLEAR = 1;
+}
+
+uint32_t axi_mon_cycles(void)
+{
+    return axi_mon_read(0);
+}
+
+uint32_t axi_mon_idle(void)
+{
+    return axi_mon_read(1);
+}
+
+uint32_t axi_mon_counter(uint32_t master, uint32_t counter)
+{
+    return axi_mon_read(((master + 1) << 4) + counter);
+}
+
+static void print_field(const int8_t* name, uint32_t value)
+{
+    int8_t buffer[BUF_LEN];
+    uwrite_int8s(name);
+    uwrite_int8s(uint32_to_ascii_hex(value, buffer, BUF_LEN));
+}
+
+void axi_mon_report(void)
+{
+    uint32_t m, b;
+
+    print_field("\r\nAXI cycles: ", axi_mon_cycles());
+    print_field(", idle: ", axi_mon_idle());
+
+    for (m = AXI_MON_DMA; m <= AXI_MON_XCEL; m++) {
+        uint32_t rd_reqs = axi_mon_counter(m, AXI_MON_RD_REQS);
+
+        uwrite_int8s(m == AXI_MON_DMA ? "\r\nDMA  " : "\r\nxcel ");
+        print_field("read reqs: ", rd_reqs);
+        print_field(", beats: ", axi_mon_counter(m, AXI_MON_RD_BEATS));
+        print_field(", write reqs: ", axi_mon_counter(m, AXI_MON_WR_REQS));
+        print_field(", beats: ", axi_mon_counter(m, AXI_MON_WR_BEATS));
+        print_field("\r\n     read latency sum: ", axi_mon_counter(m, AXI_MON_LAT_SUM));
+        print_field(", max: ", axi_mon_counter(m, AXI_MON_LAT_MAX));
+
+        // Bucket b: latency < (16 << b) cycles, the last one: the rest
+        uwrite_int8s("\r\n     latency histogram (<10, <20, ..., <400, rest):");
+        for (b = 0; b < AXI_MON_NUM_BUCKETS; b++)
+            print_field(" ", axi_mon_counter(m, AXI_MON_HIST + b));
+    }
+}
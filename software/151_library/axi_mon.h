@@ -0,0 +1,35 @@
+#ifndef AXI_MON_H_
+#define AXI_MON_H_
+
+#include "types.h"
+
+// Counters of the AXI traffic monitor, between the arbiter and the AXI
+// adapter. They count from the last axi_mon_clear (or reset)
+
+// Masters
+#define AXI_MON_DMA  0
+#define AXI_MON_XCEL 1
+
+// Per-master counters
+#define AXI_MON_RD_REQS  0
+#define AXI_MON_RD_BEATS 1
+#define AXI_MON_WR_REQS  2
+#define AXI_MON_WR_BEATS 3
+#define AXI_MON_LAT_SUM  4 // read request to first data beat, in cycles
+#define AXI_MON_LAT_MAX  5
+#define AXI_MON_HIST     8 // + b: read latencies < (16 << b), b = 7: the rest
+
+#define AXI_MON_NUM_BUCKETS 8
+
+void axi_mon_clear(void);
+
+// Cycles, and cycles without any read or write data beat
+uint32_t axi_mon_cycles(void);
+uint32_t axi_mon_idle(void);
+
+uint32_t axi_mon_counter(uint32_t master, uint32_t counter);
+
+// Print all the counters over the UART (hexadecimal)
+void axi_mon_report(void);
+
+#endif
@@ -0,0 +1,56 @@
+#include "ddr.h"
+
+static uint32_t align_up(uint32_t x)
+{
+    return (x + DDR_BURST_ALIGN - 1) & ~(DDR_BURST_ALIGN - 1);
+}
+
+void ddr_region_init(ddr_region_t* r, uint32_t base, uint32_t size)
+{
+    r->base = align_up(base);
+    r->end  = base + size;
+    r->next = r->base;
+}
+
+uint32_t ddr_alloc(ddr_region_t* r, uint32_t n)
+{
+    uint32_t addr = r->next;
+    uint32_t bytes = align_up(n);
+
+    if (r->next > r->end || bytes > r->end - r->next)
+        return 0;
+    r->next += bytes;
+    return addr;
+}
+
+uint32_t ddr_mark(const ddr_region_t* r)
+{
+    return r->next;
+}
+
+void ddr_release(ddr_region_t* r, uint32_t mark)
+{
+    if (mark >= r->base && mark < r->next)
+        r->next = mark;
+}
+
+int32_t ddr_alloc_sets(ddr_region_t* r, ddr_sets_t* sets, uint32_t n, uint32_t count)
+{
+    uint32_t shift = 0;
+
+    while (shift < 31 && ((1u << shift) < n || (1u << shift) < DDR_BURST_ALIGN))
+        shift++;
+    if (count == 0 || count > (0xffffffff >> shift))
+        return -1;
+    sets->base = ddr_alloc(r, count << shift);
+    if (sets->base == 0)
+        return -1;
+    sets->shift = shift;
+    sets->count = count;
+    return 0;
+}
+
+uint32_t ddr_set(const ddr_sets_t* sets, uint32_t i)
+{
+    return sets->base + (i << sets->shift);
+}
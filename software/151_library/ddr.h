@@ -0,0 +1,48 @@
+#ifndef DDR_H_
+#define DDR_H_
+
+#include "types.h"
+
+// DDR scratch buffers for the DMA and the accelerator
+
+// Scratch region: the data the ARM init program loads for lenet ends
+// below it (see DDR_DATA_END in lenet/cnn.h)
+#define DDR_SCRATCH_BASE 0x00900000
+#define DDR_SCRATCH_SIZE 0x00100000
+
+// An AXI burst must not cross a 4 KB boundary. The AXI adapter splits a
+// transfer into bursts of at most AXI_MAX_BURST_LEN beats (at most 4 KB)
+// from its start address, so transfers that start on a 4 KB boundary never
+// issue one that does. Buffers are aligned (and padded) to it
+#define DDR_BURST_ALIGN 4096
+
+typedef struct {
+    uint32_t base;
+    uint32_t end;
+    uint32_t next;
+} ddr_region_t;
+
+void ddr_region_init(ddr_region_t* r, uint32_t base, uint32_t size);
+
+// Address of a buffer of n bytes, or 0 if the region is full
+uint32_t ddr_alloc(ddr_region_t* r, uint32_t n);
+
+// Free everything allocated after ddr_mark returned mark
+uint32_t ddr_mark(const ddr_region_t* r);
+void ddr_release(ddr_region_t* r, uint32_t mark);
+
+// count copies of a buffer set of n bytes, e.g. one per image in flight.
+// The stride is a power of two (no multiply to find a set)
+typedef struct {
+    uint32_t base;
+    uint32_t shift; // log2 of the stride
+    uint32_t count;
+} ddr_sets_t;
+
+// Returns 0, or -1 if the region is full
+int32_t ddr_alloc_sets(ddr_region_t* r, ddr_sets_t* sets, uint32_t n, uint32_t count);
+
+// Address of set i (i < count)
+uint32_t ddr_set(const ddr_sets_t* sets, uint32_t i);
+
+#endif
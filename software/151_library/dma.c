@@ -0,0 +1,142 @@
+#include "dma.h"
+#include "memory_map.h"
+
+void dma_desc_init(dma_desc_t* desc, uint32_t dir,
+                   uint32_t src_addr, uint32_t dst_addr, uint32_t len)
+{
+    desc->flags    = dir & DMA_DESC_DIR;
+    desc->src_addr = src_addr;
+    desc->dst_addr = dst_addr;
+    desc->len      = len;
+    desc->next     = 0;
+    desc->rows       = 1;
+    desc->src_stride = 0;
+    desc->dst_stride = 0;
+}
+
+void dma_desc_2d(dma_desc_t* desc, uint32_t rows, uint32_t src_stride,
+                 uint32_t dst_stride)
+{
+    desc->rows       = rows;
+    desc->src_stride = src_stride;
+    desc->dst_stride = dst_stride;
+}
+
+void dma_desc_copy(dma_desc_t* desc, uint32_t src_addr, uint32_t dst_addr,
+                   uint32_t len)
+{
+    dma_desc_init(desc, 0, src_addr, dst_addr, len);
+    desc->flags = DMA_DESC_COPY;
+}
+
+void dma_desc_imem(dma_desc_t* desc, uint32_t ddr_addr, uint32_t imem_addr,
+                   uint32_t len)
+{
+    dma_desc_init(desc, 0, ddr_addr, imem_addr, len);
+    desc->flags = DMA_DESC_IMEM;
+}
+
+void dma_chain(dma_desc_t* descs, uint32_t n)
+{
+    for (uint32_t i = 0; i + 1 < n; i++) {
+        descs[i].flags &= ~DMA_DESC_LAST;
+        descs[i].next = (uint32_t)&descs[i + 1] >> 2;
+    }
+    descs[n - 1].flags |= DMA_DESC_LAST;
+}
+
+void dma_submit(dma_desc_t* head)
+{
+    // The descriptors must be in DMem before the engine reads them
+    asm volatile ("" ::: "memory");
+    DMA_DESC_ADDR  = (uint32_t)head >> 2;
+    DMA_DESC_START = 1;
+}
+
+uint32_t dma_completed(void)
+{
+    return DMA_DESC_COUNT;
+}
+
+uint32_t dma_poll(void)
+{
+    return DMA_DONE ? 1 : 0;
+}
+
+void dma_wait(void)
+{
+    while (!DMA_DONE) ;
+}
+
+uint32_t dma_sum(void)
+{
+    return DMA_SUM;
+}
+
+uint32_t dma_crc32(void)
+{
+    return DMA_CRC;
+}
+
+// Run a single descriptor to completion
+static void dma_run(dma_desc_t* desc)
+{
+    dma_chain(desc, 1);
+    dma_submit(desc);
+    dma_wait();
+}
+
+static uint32_t dma_mem_aligned(const void* p)
+{
+    return ((uint32_t)p & 3) == 0;
+}
+
+void* dma_memcpy(void* dst, const void* src, uint32_t n)
+{
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+    uint32_t i = 0;
+
+    if (n >= DMA_MEM_MIN_BYTES && dma_mem_aligned(d) && dma_mem_aligned(s)) {
+        dma_desc_t desc;
+        dma_desc_copy(&desc, (uint32_t)s >> 2, (uint32_t)d >> 2, n >> 2);
+        dma_run(&desc);
+        i = n & ~3;
+    }
+    for (; i < n; i++)
+        d[i] = s[i];
+    return dst;
+}
+
+uint32_t dma_checksum(const void* buf, uint32_t n, uint32_t* sum)
+{
+    dma_desc_t desc;
+    dma_desc_copy(&desc, (uint32_t)buf >> 2, (uint32_t)buf >> 2, n);
+    dma_run(&desc);
+    if (sum)
+        *sum = DMA_SUM;
+    return DMA_CRC;
+}
+
+void* dma_memset(void* dst, uint8_t val, uint32_t n)
+{
+    uint8_t* d = (uint8_t*)dst;
+    uint32_t i = 0;
+
+    if (n >= DMA_MEM_MIN_BYTES && dma_mem_aligned(d)) {
+        // Replicate the first word: one-word rows, source stride 0
+        uint32_t* w = (uint32_t*)d;
+        dma_desc_t desc;
+        uint32_t word = val;
+        word |= word << 8;
+        word |= word << 16;
+        w[0] = word;
+        dma_desc_copy(&desc, (uint32_t)w >> 2, ((uint32_t)w >> 2) + 1, 1);
+        dma_desc_2d(&desc, (n >> 2) - 1, 0, 1);
+        dma_run(&desc);
+        i = n & ~3;
+    }
+    for (; i < n; i++)
+        d[i] = val;
+    return dst;
+}
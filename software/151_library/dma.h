@@ -0,0 +1,81 @@
+#ifndef DMA_H_
+#define DMA_H_
+
+#include "types.h"
+
+// Transfer directions (DMA_DIR, and bit 0 of the descriptor flags)
+#define DMA_DDR_TO_DMEM 0
+#define DMA_DMEM_TO_DDR 1
+
+// Descriptor flags
+#define DMA_DESC_DIR  0x1
+#define DMA_DESC_LAST 0x2
+#define DMA_DESC_COPY 0x4 // DMem -> DMem, the direction is ignored
+#define DMA_DESC_IMEM 0x8 // DDR -> IMem, the direction is ignored
+
+// One transfer of a descriptor chain. The DMA engine reads the chain from
+// DMem, so descriptors must live in DMem (word aligned) until it is done.
+// DMem addresses are word addresses, e.g. (uint32_t)ptr >> 2
+//
+// A transfer is rows x len words; each row starts stride units after the
+// previous one (bytes on the DDR side, words on the DMem side)
+typedef struct dma_desc {
+    uint32_t flags;
+    uint32_t src_addr;
+    uint32_t dst_addr;
+    uint32_t len;  // number of 32-bit data transfers per row
+    uint32_t next; // DMem word address of the next descriptor
+    uint32_t rows;
+    uint32_t src_stride;
+    uint32_t dst_stride;
+} dma_desc_t;
+
+// 1D transfer (one row)
+void dma_desc_init(dma_desc_t* desc, uint32_t dir,
+                   uint32_t src_addr, uint32_t dst_addr, uint32_t len);
+
+void dma_desc_2d(dma_desc_t* desc, uint32_t rows, uint32_t src_stride,
+                 uint32_t dst_stride);
+
+// DMem -> DMem transfer (word addresses)
+void dma_desc_copy(dma_desc_t* desc, uint32_t src_addr, uint32_t dst_addr,
+                   uint32_t len);
+
+// DDR -> IMem transfer (the IMem address is a word address, like DMem)
+void dma_desc_imem(dma_desc_t* desc, uint32_t ddr_addr, uint32_t imem_addr,
+                   uint32_t len);
+
+// Link descs[0] .. descs[n - 1] in order, and mark the last one
+void dma_chain(dma_desc_t* descs, uint32_t n);
+
+// Start walking the chain at head (does not wait)
+void dma_submit(dma_desc_t* head);
+
+// Number of transfers finished since the last submit/start
+uint32_t dma_completed(void);
+
+// 1 once the last submit/start is done (dma_wait without the wait)
+uint32_t dma_poll(void);
+
+void dma_wait(void);
+
+// Sum of the 32-bit words and CRC32 (as zlib's crc32() over the bytes) of
+// all the data moved by the last start/submit, once it is done
+uint32_t dma_sum(void);
+uint32_t dma_crc32(void);
+
+// CRC32 of a word-aligned DMem buffer of n words, computed by the DMA
+// engine copying the buffer onto itself. Also returns the word sum in *sum
+// (if not NULL). Waits for the DMA, like dma_memcpy
+uint32_t dma_checksum(const void* buf, uint32_t n, uint32_t* sum);
+
+// memcpy/memset on DMem buffers. Word-aligned buffers of at least
+// DMA_MEM_MIN_BYTES go through the DMA engine (one word every two cycles),
+// anything else falls back to a CPU loop. Both wait for the DMA, and must
+// not be called while another DMA transfer is in flight
+#define DMA_MEM_MIN_BYTES 32
+
+void* dma_memcpy(void* dst, const void* src, uint32_t n);
+void* dma_memset(void* dst, uint8_t val, uint32_t n);
+
+#endif
@@ -17,6 +17,18 @@
 #define DMA_DST_ADDR  (*((volatile uint32_t*) 0x80000040))
 #define DMA_LEN       (*((volatile uint32_t*) 0x80000044))
 
+// Descriptor chain (see dma.h): write the DMem word address of the first
+// descriptor, then start. DMA_DESC_COUNT reads back the number of finished
+// transfers, DMA_DONE goes high once the whole chain is done
+#define DMA_DESC_ADDR  (*((volatile uint32_t*) 0x80000048))
+#define DMA_DESC_START (*((volatile uint32_t*) 0x8000004c))
+#define DMA_DESC_COUNT (*((volatile uint32_t*) 0x8000004c))
+
+// Sum and CRC32 (same as zlib's crc32()) of all the data words moved since
+// the last DMA_START/DMA_DESC_START, valid once DMA_DONE is high
+#define DMA_SUM (*((volatile uint32_t*) 0x80000078))
+#define DMA_CRC (*((volatile uint32_t*) 0x8000007c))
+
 #define XCEL_START (*((volatile uint32_t*) 0x80000050))
 #define XCEL_IDLE  (*((volatile uint32_t*) 0x80000054) & 0x02)
 #define XCEL_DONE  (*((volatile uint32_t*) 0x80000054) & 0x01)
@@ -25,7 +37,25 @@
 #define XCEL_WT_DDR_ADDR  (*((volatile uint32_t*) 0x8000005c))
 #define XCEL_OFM_DDR_ADDR (*((volatile uint32_t*) 0x80000060))
 
+// Accelerator operand address that points into the RISC-V DMem instead of
+// DDR (bit 31 selects the address space, the low bits are the DMem offset)
+#define XCEL_DMEM_ADDR(ptr) (0x80000000 | ((uint32_t)(ptr) & 0x0000ffff))
+
+// Accelerator WT address of packed int4 weights (bit 30 set, two weights
+// per byte, low nibble first)
+#define XCEL_WT_INT4(addr) (0x40000000 | (uint32_t)(addr))
+
 #define XCEL_IFM_DIM   (*((volatile uint32_t*) 0x80000064))
 #define XCEL_IFM_DEPTH (*((volatile uint32_t*) 0x80000068))
 #define XCEL_OFM_DIM   (*((volatile uint32_t*) 0x8000006c))
 #define XCEL_OFM_DEPTH (*((volatile uint32_t*) 0x80000070))
+
+// Number of OFM rows (flattened across output channels) the accelerator
+// has finished since the last XCEL_START
+#define XCEL_PROGRESS  (*((volatile uint32_t*) 0x80000074))
+
+// AXI traffic monitor (see axi_mon.h): store a counter index to AXI_MON_SEL,
+// then load it from AXI_MON_VALUE. A store to AXI_MON_CLEAR zeroes them all
+#define AXI_MON_SEL   (*((volatile uint32_t*) 0x80000080))
+#define AXI_MON_VALUE (*((volatile uint32_t*) 0x80000080))
+#define AXI_MON_CLEAR (*((volatile uint32_t*) 0x80000084))
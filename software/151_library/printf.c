@@ -0,0 +1,117 @@
+#include <stdarg.h>
+
+#include "printf.h"
+#include "ascii.h"
+#include "uart.h"
+
+#define PRINTF_BUF_LEN 64
+
+typedef struct {
+    int8_t buf[PRINTF_BUF_LEN];
+    uint32_t len;
+    uint32_t total;
+} out_t;
+
+static void out_flush(out_t* out)
+{
+    const int8_t* p = out->buf;
+    uint32_t n = out->len;
+    while (n > 0) {
+        uint32_t sent = uwrite(p, n);
+        p += sent;
+        n -= sent;
+    }
+    out->len = 0;
+}
+
+static void out_char(out_t* out, int8_t c)
+{
+    if (out->len == PRINTF_BUF_LEN)
+        out_flush(out);
+    out->buf[out->len++] = c;
+    out->total++;
+}
+
+static void out_field(out_t* out, const int8_t* s, uint32_t width, int8_t pad)
+{
+    uint32_t len = 0;
+    while (s[len] != '\0')
+        len++;
+    // A '-' goes before the zeros
+    if (pad == '0' && s[0] == '-' && len < width) {
+        out_char(out, *s++);
+        len--;
+        width--;
+    }
+    for ( ; len < width; width--)
+        out_char(out, pad);
+    while (*s != '\0')
+        out_char(out, *s++);
+}
+
+int32_t uprintf(const char* fmt, ...)
+{
+    out_t out;
+    int8_t num[12];
+    va_list ap;
+
+    out.len = 0;
+    out.total = 0;
+    va_start(ap, fmt);
+    for ( ; *fmt != '\0'; fmt++) {
+        if (*fmt != '%') {
+            out_char(&out, *fmt);
+            continue;
+        }
+
+        int8_t pad = ' ';
+        uint32_t width = 0;
+        fmt++;
+        if (*fmt == '0') {
+            pad = '0';
+            fmt++;
+        }
+        for ( ; *fmt >= '0' && *fmt <= '9'; fmt++)
+            width = (width << 3) + (width << 1) + (*fmt - '0');
+
+        switch (*fmt) {
+        case 'd':
+            out_field(&out, int32_to_ascii_dec(va_arg(ap, int32_t), num, sizeof(num)), width, pad);
+            break;
+        case 'u':
+            out_field(&out, uint32_to_ascii_dec(va_arg(ap, uint32_t), num, sizeof(num)), width, pad);
+            break;
+        case 'x': {
+            // uint32_to_ascii_hex always prints 8 digits: drop the leading
+            // zeros first, keeping at least one digit
+            const int8_t* s = uint32_to_ascii_hex(va_arg(ap, uint32_t), num, sizeof(num));
+            while (s[0] == '0' && s[1] != '\0')
+                s++;
+            out_field(&out, s, width, pad);
+            break;
+        }
+        case 'c':
+            num[0] = va_arg(ap, int32_t);
+            num[1] = '\0';
+            out_field(&out, num, width, ' ');
+            break;
+        case 's':
+            out_field(&out, va_arg(ap, const int8_t*), width, ' ');
+            break;
+        case '%':
+            out_char(&out, '%');
+            break;
+        case '\0':
+            // A lone % at the end
+            fmt--;
+            break;
+        default:
+            out_char(&out, '%');
+            out_char(&out, *fmt);
+            break;
+        }
+    }
+    va_end(ap);
+    out_flush(&out);
+    return out.total;
+}
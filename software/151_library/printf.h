@@ -0,0 +1,12 @@
+#ifndef PRINTF_H_
+#define PRINTF_H_
+
+#include "types.h"
+
+// Minimal printf over the UART. Conversions: %d %u %x %c %s %%, with an
+// optional width, zero-padded if it starts with 0 (e.g. %08x). The output
+// is formatted into a small buffer and queued a buffer at a time with
+// uwrite (word stores into the TX FIFO). Returns the number of bytes
+int32_t uprintf(const char* fmt, ...);
+
+#endif
@@ -1,30 +1,133 @@
 #include "string.h"
 
+// Nonzero if the word has a zero byte
+#define HAS_ZERO(w) (((w) - 0x01010101) & ~(w) & 0x80808080)
+
+static uint32_t aligned(const void* p)
+{
+    return ((uint32_t)p & 3) == 0;
+}
+
+static uint32_t same_alignment(const void* p, const void* q)
+{
+    return (((uint32_t)p ^ (uint32_t)q) & 3) == 0;
+}
+
 int32_t strcmp(const int8_t* s0, const int8_t* s1)
 {
-/*
-    uwrite_int8s("\n\rComparing ");
-    uwrite_int8s(s0);
-    uwrite_int8s("|");
-    uwrite_int8s("with ");
-    uwrite_int8s(s1);
-    uwrite_int8s("|");
-    uwrite_int8s("\n\r");
-*/  
-  for (uint32_t i = 0; ; i++) {
-        if (s0[i] != s1[i]) {
-            return 1;
+    const uint8_t* a = (const uint8_t*)s0;
+    const uint8_t* b = (const uint8_t*)s1;
+
+    if (same_alignment(a, b)) {
+        for ( ; !aligned(a); a++, b++) {
+            if (*a != *b || *a == '\0')
+                return *a - *b;
         }
-        if (s0[i] == '\0') {
-            break;
+        // Skip the equal words without a terminator
+        const uint32_t* wa = (const uint32_t*)a;
+        const uint32_t* wb = (const uint32_t*)b;
+        while (*wa == *wb && !HAS_ZERO(*wa)) {
+            wa++;
+            wb++;
         }
+        a = (const uint8_t*)wa;
+        b = (const uint8_t*)wb;
     }
-    return 0;
+    for ( ; *a == *b && *a != '\0'; a++, b++) ;
+    return *a - *b;
 }
 
 uint32_t strlen(const int8_t* s)
 {
-    uint32_t i = 0;
-    for ( ; s[i] != '\0'; i++) ;
-    return i;
+    const uint8_t* p = (const uint8_t*)s;
+
+    for ( ; !aligned(p); p++) {
+        if (*p == '\0')
+            return p - (const uint8_t*)s;
+    }
+    const uint32_t* w = (const uint32_t*)p;
+    while (!HAS_ZERO(*w))
+        w++;
+    for (p = (const uint8_t*)w; *p != '\0'; p++) ;
+    return p - (const uint8_t*)s;
+}
+
+void* memcpy(void* dst, const void* src, uint32_t n)
+{
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+
+    if (same_alignment(d, s)) {
+        for ( ; n > 0 && !aligned(d); n--)
+            *d++ = *s++;
+        uint32_t* wd = (uint32_t*)d;
+        const uint32_t* ws = (const uint32_t*)s;
+        for ( ; n >= 16; n -= 16) {
+            uint32_t w0 = ws[0], w1 = ws[1], w2 = ws[2], w3 = ws[3];
+            wd[0] = w0;
+            wd[1] = w1;
+            wd[2] = w2;
+            wd[3] = w3;
+            wd += 4;
+            ws += 4;
+        }
+        for ( ; n >= 4; n -= 4)
+            *wd++ = *ws++;
+        d = (uint8_t*)wd;
+        s = (const uint8_t*)ws;
+    }
+    for ( ; n > 0; n--)
+        *d++ = *s++;
+    return dst;
+}
+
+void* memmove(void* dst, const void* src, uint32_t n)
+{
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+
+    // A forward copy only overwrites bytes it has already read
+    if (d <= s || d >= s + n)
+        return memcpy(dst, src, n);
+
+    // Backward, from the end
+    d += n;
+    s += n;
+    if (same_alignment(d, s)) {
+        for ( ; n > 0 && !aligned(d); n--)
+            *--d = *--s;
+        uint32_t* wd = (uint32_t*)d;
+        const uint32_t* ws = (const uint32_t*)s;
+        for ( ; n >= 4; n -= 4)
+            *--wd = *--ws;
+        d = (uint8_t*)wd;
+        s = (const uint8_t*)ws;
+    }
+    for ( ; n > 0; n--)
+        *--d = *--s;
+    return dst;
+}
+
+void* memset(void* dst, int32_t val, uint32_t n)
+{
+    uint8_t* d = (uint8_t*)dst;
+    uint32_t word = val & 0xff;
+
+    for ( ; n > 0 && !aligned(d); n--)
+        *d++ = val;
+    word |= word << 8;
+    word |= word << 16;
+    uint32_t* wd = (uint32_t*)d;
+    for ( ; n >= 16; n -= 16) {
+        wd[0] = word;
+        wd[1] = word;
+        wd[2] = word;
+        wd[3] = word;
+        wd += 4;
+    }
+    for ( ; n >= 4; n -= 4)
+        *wd++ = word;
+    for (d = (uint8_t*)wd; n > 0; n--)
+        *d++ = val;
+    return dst;
 }
@@ -3,7 +3,19 @@
 
 #include "types.h"
 
+// Word at a time where the pointers allow it (same alignment for
+// memcpy/memmove/strcmp), a byte loop for the rest. The word loops may
+// read (never write) up to 3 bytes past the end of a string, within its
+// last word
+
+// Returns 0 if the strings are equal, else the difference of the first
+// bytes that differ (as unsigned)
 int32_t strcmp(const int8_t* s0, const int8_t* s1);
 uint32_t strlen(const int8_t* s);
 
+void* memcpy(void* dst, const void* src, uint32_t n);
+// Overlapping buffers are fine
+void* memmove(void* dst, const void* src, uint32_t n);
+void* memset(void* dst, int32_t val, uint32_t n);
+
 #endif
@@ -6,13 +6,39 @@ void uwrite_int8(int8_t c)
     UTRAN_DATA = c;
 }
 
+// Four bytes per FIFO entry where possible; only waits when the FIFO is full
 void uwrite_int8s(const int8_t* s)
 {
-    for (int i = 0; s[i] != '\0'; i++) {
-        uwrite_int8(s[i]);
+    uint32_t n = 0;
+    while (s[n] != '\0') n++;
+    while (n > 0) {
+        uint32_t sent = uwrite(s, n);
+        s += sent;
+        n -= sent;
     }
 }
 
+uint32_t uwrite(const void* buf, uint32_t n)
+{
+    const uint8_t* p = (const uint8_t*)buf;
+    uint32_t i = 0;
+    while (i < n && UTRAN_CTRL) {
+        if (n - i >= 4) {
+            UTRAN_WORD = p[i] | (p[i + 1] << 8) | (p[i + 2] << 16) | ((uint32_t)p[i + 3] << 24);
+            i += 4;
+        } else {
+            UTRAN_DATA = p[i];
+            i += 1;
+        }
+    }
+    return i;
+}
+
+void uflush(void)
+{
+    while (!UTRAN_IDLE) ;
+}
+
 int8_t uread_int8(void)
 {
     while (!URECV_CTRL) ;
@@ -24,3 +50,12 @@ int8_t uread_int8(void)
     }
     return ch;
 }
+
+void uread(void* buf, uint32_t n)
+{
+    uint8_t* p = (uint8_t*)buf;
+    for (uint32_t i = 0; i < n; i++) {
+        while (!URECV_CTRL) ;
+        p[i] = URECV_DATA;
+    }
+}
@@ -9,11 +9,32 @@
 
 #define UTRAN_CTRL (*((volatile uint32_t*)0x80000000) & 0x01)
 #define UTRAN_DATA (*((volatile uint32_t*)0x80000008))
+// Word store: four bytes at once, lowest byte first
+#define UTRAN_WORD (*((volatile uint32_t*)0x8000000c))
+// Transmit FIFO empty and the last byte sent
+#define UTRAN_IDLE (*((volatile uint32_t*)0x80000000) & 0x04)
+
+// FIFO levels: free transmit entries (byte or word) and received bytes
+#define UART_LEVELS (*((volatile uint32_t*)0x8000000c))
+#define UTRAN_FREE (UART_LEVELS & 0xffff)
+#define URECV_COUNT (UART_LEVELS >> 16)
+
+// Clock cycles per bit (CPU clock / baud rate), 434 (115200 baud) after reset
+#define UART_BAUD (*((volatile uint32_t*)0x8000001c))
 
 void uwrite_int8(int8_t c);
 
 void uwrite_int8s(const int8_t* s);
 
+// Queue up to n bytes of buf without waiting; returns the number queued
+uint32_t uwrite(const void* buf, uint32_t n);
+
+// Wait until everything queued has been sent
+void uflush(void);
+
 int8_t uread_int8(void);
 
+// Read n bytes into buf, waiting for each one (no echo)
+void uread(void* buf, uint32_t n);
+
 #endif
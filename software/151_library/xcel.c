@@ -0,0 +1,33 @@
+#include "xcel.h"
+#include "memory_map.h"
+
+void xcel_submit(const xcel_job_t* job)
+{
+    // A DMem IFM must be written before the accelerator reads it
+    asm volatile ("" ::: "memory");
+    XCEL_IFM_DDR_ADDR = job->ifm_addr;
+    XCEL_WT_DDR_ADDR  = job->wt_addr;
+    XCEL_OFM_DDR_ADDR = job->ofm_addr;
+    XCEL_OFM_DIM      = job->ofm_dim;
+    XCEL_OFM_DEPTH    = job->ofm_depth;
+    XCEL_IFM_DIM      = job->ifm_dim;
+    XCEL_IFM_DEPTH    = job->ifm_depth;
+    XCEL_START        = 1;
+}
+
+uint32_t xcel_poll(void)
+{
+    return XCEL_DONE ? 1 : 0;
+}
+
+uint32_t xcel_progress(void)
+{
+    return XCEL_PROGRESS;
+}
+
+void xcel_wait(void)
+{
+    while (!XCEL_DONE) ;
+    // The OFM is in DMem from here on
+    asm volatile ("" ::: "memory");
+}
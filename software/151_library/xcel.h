@@ -0,0 +1,33 @@
+#ifndef XCEL_H_
+#define XCEL_H_
+
+#include "types.h"
+
+// conv3D accelerator. Operand addresses are DDR byte addresses, or DMem
+// buffers given as XCEL_DMEM_ADDR(ptr) (see memory_map.h); packed int4
+// weights as XCEL_WT_INT4(addr). The OFM is int32, ofm_dim x ofm_dim per
+// output channel (valid convolution, ofm_dim = ifm_dim - wt_dim + 1)
+typedef struct {
+    uint32_t ifm_addr;
+    uint32_t wt_addr;
+    uint32_t ofm_addr;
+    uint32_t ifm_dim;
+    uint32_t ifm_depth;
+    uint32_t ofm_dim;
+    uint32_t ofm_depth;
+} xcel_job_t;
+
+// Start the job (does not wait). The accelerator must be idle: one job at
+// a time
+void xcel_submit(const xcel_job_t* job);
+
+// 1 once the last submitted job is done
+uint32_t xcel_poll(void);
+
+// Number of OFM rows (flattened across output channels) of the last job
+// done so far
+uint32_t xcel_progress(void);
+
+void xcel_wait(void);
+
+#endif
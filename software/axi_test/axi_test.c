@@ -2,13 +2,17 @@
 #include "ascii.h"
 #include "uart.h"
 #include "memory_map.h"
+#include "dma.h"
+#include "ddr.h"
 
 #define BUF_LEN 128
 
 #define SIZE 16
+// Buffers in flight at once, each in its own DDR buffer set
+#define NUM_SETS 4
 
-static int8_t array0[SIZE] = {0};
-static int8_t array1[SIZE] = {0};
+static int8_t array0[NUM_SETS][SIZE] = {0};
+static int8_t array1[NUM_SETS][SIZE] = {0};
 
 typedef void (*entry_t)(void);
 
@@ -16,44 +20,62 @@ typedef void (*entry_t)(void);
 int main(int argc, char**argv) {
   int8_t buffer[BUF_LEN];
   int32_t len = SIZE;
-  int32_t i;
+  int32_t i, set;
 
-  for (i = 0; i < len; i++) {
-    array1[i] = i;
+  // Burst-aligned DDR buffers from the scratch region, instead of a fixed
+  // address
+  ddr_region_t ddr;
+  ddr_sets_t sets;
+  ddr_region_init(&ddr, DDR_SCRATCH_BASE, DDR_SCRATCH_SIZE);
+  if (ddr_alloc_sets(&ddr, &sets, SIZE, NUM_SETS)) {
+    uwrite_int8s("\r\nNo DDR scratch space\r\n");
+    entry_t start = (entry_t) (ascii_hex_to_uint32("40000000"));
+    start();
   }
 
-  // Copy data from array1 from DMem to DDR at address 0x40_0000
-  DMA_DIR = 1;
-  DMA_DST_ADDR = 0x900000;
-  // shift right by 2 because the DMA uses word-level addressing to access DMem
-  DMA_SRC_ADDR = (uint32_t)array1 >> 2;
-  // shift right by 2 because we're sending 8b data on 32b data bus
-  DMA_LEN = len >> 2;
-  DMA_START = 1;
-  while (!DMA_DONE);
+  for (set = 0; set < NUM_SETS; set++) {
+    for (i = 0; i < len; i++) {
+      array1[set][i] = (set << 4) + i;
+    }
+  }
 
-  // Copy data from DDR at address 0x40_0000 to array0 from DMem
-  DMA_DIR = 0;
-  DMA_SRC_ADDR = 0x900000;
-  // shift right by 2 because the DMA uses word-level addressing to access DMem
-  DMA_DST_ADDR = (uint32_t)array0 >> 2;
-  // shift right by 2 because we're sending 8b data on 32b data bus
-  DMA_LEN = len >> 2;
-  DMA_START = 1;
-  while (!DMA_DONE);
+  // Copy every array1 from DMem to its DDR set, with one descriptor chain
+  static dma_desc_t descs[NUM_SETS];
+  for (set = 0; set < NUM_SETS; set++) {
+    // shift right by 2 because the DMA uses word-level addressing to access
+    // DMem, and because we're sending 8b data on 32b data bus
+    dma_desc_init(&descs[set], DMA_DMEM_TO_DDR, (uint32_t)array1[set] >> 2,
+                  ddr_set(&sets, set), len >> 2);
+  }
+  dma_chain(descs, NUM_SETS);
+  dma_submit(descs);
+  dma_wait();
+
+  // Copy them back to array0 in DMem
+  for (set = 0; set < NUM_SETS; set++) {
+    dma_desc_init(&descs[set], DMA_DDR_TO_DMEM, ddr_set(&sets, set),
+                  (uint32_t)array0[set] >> 2, len >> 2);
+  }
+  dma_chain(descs, NUM_SETS);
+  dma_submit(descs);
+  dma_wait();
 
   uint32_t num_mismatches = 0;
   // Make sure that the two arrays match!
-  for (i = 0; i < len; i++) {
-    uwrite_int8s("\r\n>>> At ");
-    uwrite_int8s(uint8_to_ascii_hex(i, buffer, BUF_LEN));
-    uwrite_int8s("\r\narray0 ");
-    uwrite_int8s(uint8_to_ascii_hex(array0[i], buffer, BUF_LEN));
-    uwrite_int8s("\r\narray1 ");
-    uwrite_int8s(uint8_to_ascii_hex(array1[i], buffer, BUF_LEN));
+  for (set = 0; set < NUM_SETS; set++) {
+    uwrite_int8s("\r\n>>> DDR set at ");
+    uwrite_int8s(uint32_to_ascii_hex(ddr_set(&sets, set), buffer, BUF_LEN));
+    for (i = 0; i < len; i++) {
+      uwrite_int8s("\r\n>>> At ");
+      uwrite_int8s(uint8_to_ascii_hex(i, buffer, BUF_LEN));
+      uwrite_int8s("\r\narray0 ");
+      uwrite_int8s(uint8_to_ascii_hex(array0[set][i], buffer, BUF_LEN));
+      uwrite_int8s("\r\narray1 ");
+      uwrite_int8s(uint8_to_ascii_hex(array1[set][i], buffer, BUF_LEN));
 
-    if (array0[i] != array1[i]) {
-      num_mismatches += 1;
+      if (array0[set][i] != array1[set][i]) {
+        num_mismatches += 1;
+      }
     }
   }
 
@@ -2,6 +2,7 @@
 #include "uart.h"
 #include "string.h"
 #include "memory_map.h"
+#include "dma.h"
 
 int8_t* read_n(int8_t*b, uint32_t n)
 {
@@ -50,6 +51,143 @@ void store(uint32_t address, uint32_t length)
     }
 }
 
+// Binary upload ("bfile"): the host sends the program as frames of
+// {offset of the payload in the program (4 bytes), payload length (2
+// bytes), payload (a multiple of 4 bytes, at most BFRAME_MAX), CRC32 of the
+// offset and the payload (4 bytes)}, little-endian. Each frame is answered
+// with BFILE_NACK (send the frame again), or BFILE_ACK and the offset of
+// the frame (4 bytes). A frame that is already stored (its ack was lost)
+// is acknowledged again, but not stored twice
+#define BFRAME_MAX 256
+#define BFILE_ACK  'A'
+#define BFILE_NACK 'N'
+// Polls of an idle line before a bad frame is considered over (~20 ms)
+#define BFILE_QUIET 100000
+
+uint32_t uread_le(uint32_t n)
+{
+    uint8_t b[4];
+    uint32_t v = 0;
+    uread(b, n);
+    for (uint32_t i = 0; i < n; i++) {
+        v |= (uint32_t)b[i] << (i * 8);
+    }
+    return v;
+}
+
+void bfile_ack(uint32_t offset)
+{
+    uwrite_int8(BFILE_ACK);
+    for (uint32_t i = 0; i < 4; i++) {
+        uwrite_int8(offset >> (i * 8));
+    }
+}
+
+// Drop the rest of a bad frame, to get back in sync with the host
+void bfile_drain(void)
+{
+    for (uint32_t quiet = 0; quiet < BFILE_QUIET; quiet++) {
+        if (URECV_CTRL) {
+            (void)URECV_DATA;
+            quiet = 0;
+        }
+    }
+}
+
+// Packed program image ("zfile", made by scripts/pack_image): a header word
+// {RLE_RUN, count (bits 30:0)}, then count literal words, or one word to
+// repeat count times; this mostly squeezes out zero-filled .data/.bss.
+// The stream is expanded frame by frame, as it arrives
+#define RLE_RUN 0x80000000
+
+typedef struct {
+    volatile uint32_t* dst;
+    uint32_t left;  // words left in the current token
+    uint32_t run;
+} unpack_t;
+
+void unpack(unpack_t* u, const uint32_t* src, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t w = src[i];
+        if (u->left == 0) {
+            u->run = w & RLE_RUN;
+            u->left = w & ~RLE_RUN;
+        } else if (u->run) {
+            for ( ; u->left > 0; u->left--)
+                *u->dst++ = w;
+        } else {
+            *u->dst++ = w;
+            u->left--;
+        }
+    }
+}
+
+// Receive length bytes of frames; store them at address, or expand them
+// there if packed
+void bstore(uint32_t address, uint32_t length, uint32_t packed)
+{
+    // The frame offset, then the payload
+    uint32_t frame[1 + BFRAME_MAX / 4];
+    uint32_t offset = 0;
+    unpack_t u = { (volatile uint32_t*)address, 0, 0 };
+
+    while (offset < length) {
+        uint32_t at = uread_le(4);
+        uint32_t n = uread_le(2);
+        if (n == 0 || n > BFRAME_MAX || (n & 3) || at > offset || n > length - at) {
+            bfile_drain();
+            uwrite_int8(BFILE_NACK);
+            continue;
+        }
+        frame[0] = at;
+        uread(frame + 1, n);
+        uint32_t crc = uread_le(4);
+
+        // The CRC comes from the DMA engine (the frame is on the stack, in DMem)
+        if (dma_checksum(frame, 1 + (n >> 2), NULL) != crc) {
+            bfile_drain();
+            uwrite_int8(BFILE_NACK);
+            continue;
+        }
+
+        // An earlier frame is a resend after a lost ack: only ack it again
+        if (at == offset) {
+            if (packed) {
+                unpack(&u, frame + 1, n >> 2);
+            } else {
+                for (uint32_t i = 0; i < (n >> 2); i++)
+                    *u.dst++ = frame[1 + i];
+            }
+            offset += n;
+        }
+        bfile_ack(at);
+    }
+}
+
+// Run one DMA descriptor, and return the CRC32 of the data it moved
+uint32_t dma_run_crc(dma_desc_t* desc)
+{
+    dma_chain(desc, 1);
+    dma_submit(desc);
+    dma_wait();
+    return dma_crc32();
+}
+
+// Copy a program image staged in DDR (e.g. by the ARM init flow) to IMem
+// and DMem with the DMA engine, like "file" does to address 0x30000000.
+// Returns the CRC32 of the image, as computed by the DMA on the way
+uint32_t ddrboot(uint32_t address, uint32_t ddr_address, uint32_t length)
+{
+    dma_desc_t desc;
+    uint32_t words = (length + 3) >> 2;
+
+    dma_desc_imem(&desc, ddr_address, address >> 2, words);
+    uint32_t crc = dma_run_crc(&desc);
+    dma_desc_init(&desc, DMA_DDR_TO_DMEM, ddr_address, address >> 2, words);
+    dma_run_crc(&desc);
+    return crc;
+}
 
 #define BUFFER_LEN 128
 
@@ -69,6 +207,43 @@ int main(void)
             uint32_t address = ascii_hex_to_uint32(read_token(buffer, BUFFER_LEN, " \x0d"));
             uint32_t file_length = ascii_dec_to_uint32(read_token(buffer, BUFFER_LEN, " \x0d"));
             store(address, file_length);
+        } else if (strcmp(input, "bfile") == 0) {
+            uint32_t address = ascii_hex_to_uint32(read_token(buffer, BUFFER_LEN, " \x0d"));
+            uint32_t file_length = ascii_dec_to_uint32(read_token(buffer, BUFFER_LEN, " \x0d"));
+            bstore(address, file_length, 0);
+        } else if (strcmp(input, "zfile") == 0) {
+            // Length of the packed image, in bytes
+            uint32_t address = ascii_hex_to_uint32(read_token(buffer, BUFFER_LEN, " \x0d"));
+            uint32_t file_length = ascii_dec_to_uint32(read_token(buffer, BUFFER_LEN, " \x0d"));
+            bstore(address, file_length, 1);
+        } else if (strcmp(input, "baud") == 0) {
+            // Clock cycles per bit; the host switches once the echo is back
+            uint32_t divisor = ascii_dec_to_uint32(read_token(buffer, BUFFER_LEN, " \x0d"));
+            uflush();
+            if (divisor > 1 && divisor < 0x10000)
+                UART_BAUD = divisor;
+        } else if (strcmp(input, "ddrboot") == 0) {
+            uint32_t address = ascii_hex_to_uint32(read_token(buffer, BUFFER_LEN, " \x0d"));
+            uint32_t ddr_address = ascii_hex_to_uint32(read_token(buffer, BUFFER_LEN, " \x0d"));
+            uint32_t length = ascii_dec_to_uint32(read_token(buffer, BUFFER_LEN, " \x0d"));
+            uint32_t crc = ddrboot(address, ddr_address, length);
+
+            uwrite_int8s("\n\rcrc32: ");
+            uwrite_int8s(uint32_to_ascii_hex(crc, buffer, BUFFER_LEN));
+            uwrite_int8s("\r\n");
+
+            entry_t start = (entry_t)(address);
+            start();
+        } else if (strcmp(input, "crc") == 0) {
+            // CRC32 of length bytes of DMem at address, e.g. to check a
+            // program loaded with "file" (hex_to_serial prints the expected one)
+            uint32_t address = ascii_hex_to_uint32(read_token(buffer, BUFFER_LEN, " \x0d"));
+            uint32_t length = ascii_dec_to_uint32(read_token(buffer, BUFFER_LEN, " \x0d"));
+            uint32_t crc = dma_checksum((void*)(address & 0x1000fffc), (length + 3) >> 2, NULL);
+
+            uwrite_int8s("\n\rcrc32: ");
+            uwrite_int8s(uint32_to_ascii_hex(crc, buffer, BUFFER_LEN));
+            uwrite_int8s("\r\n");
         } else if (strcmp(input, "jal") == 0) {
             uint32_t address = ascii_hex_to_uint32(read_token(buffer, BUFFER_LEN, " \x0d"));
 
@@ -1,12 +1,11 @@
 #include "memory.h"
+#include "string.h"
 
+// Byte types only: word stores through memset
 #define DEFINE_FILLV(type) \
 type##_t* fill_##type##v(type##_t* v, type##_t val, uint32_t n) \
 { \
-    for (uint32_t i = 0; i < n; i++) { \
-        v[i] = val; \
-    } \
-    return v; \
+    return (type##_t*)memset(v, (uint8_t)val, n); \
 }
 
 DEFINE_FILLV(int8)
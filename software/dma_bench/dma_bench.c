@@ -0,0 +1,106 @@
+#include "types.h"
+#include "ascii.h"
+#include "uart.h"
+#include "memory_map.h"
+#include "dma.h"
+
+#define BUF_LEN 128
+
+// Largest buffer size tested (bytes)
+#define MAX_BYTES 4096
+
+static uint32_t src[MAX_BYTES / 4];
+static uint32_t dst[MAX_BYTES / 4];
+
+typedef void (*entry_t)(void);
+
+// Byte loops, as fill_uint8v in bios151v3/memory.c
+static void cpu_memset(uint8_t* d, uint8_t val, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        d[i] = val;
+}
+
+static void cpu_memcpy(uint8_t* d, const uint8_t* s, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        d[i] = s[i];
+}
+
+static uint32_t check(const uint8_t* d, const uint8_t* expected, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        if (d[i] != expected[i])
+            return 0;
+    }
+    return 1;
+}
+
+static uint32_t check_fill(const uint8_t* d, uint8_t val, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        if (d[i] != val)
+            return 0;
+    }
+    return 1;
+}
+
+static void report(const char* name, uint32_t n, uint32_t cpu_cycles,
+                   uint32_t dma_cycles, uint32_t ok)
+{
+    int8_t buffer[BUF_LEN];
+
+    uwrite_int8s("\r\n");
+    uwrite_int8s(name);
+    uwrite_int8s(" bytes: ");
+    uwrite_int8s(uint32_to_ascii_hex(n, buffer, BUF_LEN));
+    uwrite_int8s(" cpu: ");
+    uwrite_int8s(uint32_to_ascii_hex(cpu_cycles, buffer, BUF_LEN));
+    uwrite_int8s(" dma: ");
+    uwrite_int8s(uint32_to_ascii_hex(dma_cycles, buffer, BUF_LEN));
+    if (!ok)
+        uwrite_int8s(" MISMATCH");
+}
+
+int main(void)
+{
+    uint8_t* s = (uint8_t*)src;
+    uint8_t* d = (uint8_t*)dst;
+    uint32_t cpu_cycles, dma_cycles, ok;
+
+    for (uint32_t i = 0; i < MAX_BYTES / 4; i++)
+        src[i] = 0x01020304 + (i << 8);
+
+    for (uint32_t n = 64; n <= MAX_BYTES; n <<= 2) {
+        COUNTER_RST = 0;
+        cpu_memcpy(d, s, n);
+        cpu_cycles = CYCLE_COUNTER;
+
+        cpu_memset(d, 0, n);
+        COUNTER_RST = 0;
+        dma_memcpy(d, s, n);
+        dma_cycles = CYCLE_COUNTER;
+        ok = check(d, s, n);
+
+        report("memcpy", n, cpu_cycles, dma_cycles, ok);
+
+        COUNTER_RST = 0;
+        cpu_memset(d, 0x5a, n);
+        cpu_cycles = CYCLE_COUNTER;
+
+        COUNTER_RST = 0;
+        dma_memset(d, 0xa5, n);
+        dma_cycles = CYCLE_COUNTER;
+        ok = check_fill(d, 0xa5, n);
+
+        report("memset", n, cpu_cycles, dma_cycles, ok);
+    }
+    uwrite_int8s("\r\n");
+
+    // go back to the bios - using this function causes a jr to the addr,
+    // the compiler "jals" otherwise and then cannot set PC[31:28]
+    uint32_t bios = ascii_hex_to_uint32("40000000");
+    entry_t start = (entry_t) (bios);
+    start();
+    return 0;
+}
@@ -25,250 +25,391 @@ int32_t cast_si32(int8_t input) {
   return (input > 127) ? (val - 256) : val;
 }
 
-// Convolution 3D
-void conv3D_sw_1(int8_t *ifm, int8_t *wt, int32_t *ofm) {
-
-  int f, d, i, j, m, n;
-  int ofm_idx, ifm_idx, wt_idx;
+// Quarter squares: a * b = qsq[a + b] - qsq[a - b], with qsq[n] = n^2 / 4
+// (rounded down), exact for a, b in [-128, 127]. RV32I has no multiplier,
+// so this replaces times() in the MAC loops
+static int32_t qsq_table[512];
+#define qsq ((const char *)(qsq_table + 256))
+
+// The kernels keep their operands multiplied by 4 (byte offsets into qsq)
+#define QSQ(p, x4) (*(const int32_t *)((p) + (x4)))
+#define S8X4(v) ((int32_t)((uint32_t)(v) << 24) >> 22)
+
+static void qsq_init(void) {
+  int32_t n, sq = 0;
+
+  if (qsq_table[0])
+    return;
+  for (n = 0; n <= 256; ++n) {
+    if (n > 0)
+      sq += (n << 1) - 1;
+    if (n < 256)
+      qsq_table[256 + n] = sq >> 2;
+    qsq_table[256 - n] = sq >> 2;
+  }
+}
 
-  int ofm_offset = 0;
-  int ifm_offset = 0;
-  int wt_offset  = 0;
+static int32_t mul_q(int32_t x4, int32_t w4) {
+  return QSQ(qsq + w4, x4) - QSQ(qsq - w4, x4);
+}
 
-  for (f = 0; f < CV1_DEPTH; ++f) {
+// dst[i] = 4 * (signed) src[i], four bytes per word load
+static void unpack_s8x4(const int8_t *src, int32_t *dst, int len) {
+  int i = 0;
+
+  for (; i < len && ((uint32_t)(src + i) & 3); ++i)
+    dst[i] = S8X4(src[i]);
+  for (; i + 4 <= len; i += 4) {
+    uint32_t w = *(const uint32_t *)(src + i);
+    dst[i]     = S8X4(w);
+    dst[i + 1] = S8X4(w >> 8);
+    dst[i + 2] = S8X4(w >> 16);
+    dst[i + 3] = S8X4(w >> 24);
+  }
+  for (; i < len; ++i)
+    dst[i] = S8X4(src[i]);
+}
 
-    ofm_idx = 0;
-    for (i = 0; i < CV1_DIM; ++i) {
-      for (j = 0; j < CV1_DIM; ++j) {
-        ofm[ofm_offset + ofm_idx] = 0;
-        ofm_idx += 1;
-      }
+// acc[j] += sum(x[j + n] * wk[n]), n < wt_dim, for j < len: one IFM row
+// against one weight row, four output pixels at a time in registers
+static void conv_row(const int32_t *x, const int32_t *wk, int wt_dim,
+                     int32_t *acc, int len) {
+  int j, n;
+
+  for (j = 0; j + 4 <= len; j += 4) {
+    const int32_t *xj = x + j;
+    int32_t a0 = acc[j], a1 = acc[j + 1], a2 = acc[j + 2], a3 = acc[j + 3];
+    int32_t x0 = xj[0], x1 = xj[1], x2 = xj[2];
+
+    for (n = 0; n < wt_dim; ++n) {
+      int32_t x3 = xj[n + 3];
+      const char *qp = qsq + wk[n];
+      const char *qm = qsq - wk[n];
+
+      a0 += QSQ(qp, x0) - QSQ(qm, x0);
+      a1 += QSQ(qp, x1) - QSQ(qm, x1);
+      a2 += QSQ(qp, x2) - QSQ(qm, x2);
+      a3 += QSQ(qp, x3) - QSQ(qm, x3);
+      x0 = x1;
+      x1 = x2;
+      x2 = x3;
     }
 
-    ifm_offset = 0;
-    for (d = 0; d < IMG_DEPTH; ++d) {
-
-      ofm_idx = 0;
-      int ifm_idx0 = 0;
-
-      for (i = 0; i < CV1_DIM; ++i) {
-        for (j = 0; j < CV1_DIM; ++j) {
-          wt_idx = 0;
-
-          int32_t tmp = 0;
-          int ifm_idx1 = 0;
-
-          for (m = 0; m < WT1_DIM; ++m) {
-            for (n = 0; n < WT1_DIM; ++n) {
-              int32_t ifm_value = cast_si32(ifm[ifm_offset + ifm_idx0 + ifm_idx1]);
-              int32_t wt_value  = cast_si32(wt[wt_offset + wt_idx]);
-              int32_t prod = times(ifm_value, wt_value);
-              tmp += prod;
+    acc[j] = a0;
+    acc[j + 1] = a1;
+    acc[j + 2] = a2;
+    acc[j + 3] = a3;
+  }
 
-              ifm_idx1 += 1;
-              wt_idx   += 1;
-            } // n
+  for (; j < len; ++j) {
+    int32_t a = acc[j];
+    for (n = 0; n < wt_dim; ++n)
+      a += mul_q(x[j + n], wk[n]);
+    acc[j] = a;
+  }
+}
 
-            ifm_idx1 += IMG_DIM - WT1_DIM;
-          } // m
+// conv_row on the same rows of two images: each weight is loaded once for
+// eight output pixels
+static void conv_row2(const int32_t *x, const int32_t *y, const int32_t *wk,
+                      int wt_dim, int32_t *acc, int32_t *acc_y, int len) {
+  int j, n;
+
+  for (j = 0; j + 4 <= len; j += 4) {
+    const int32_t *xj = x + j;
+    const int32_t *yj = y + j;
+    int32_t a0 = acc[j], a1 = acc[j + 1], a2 = acc[j + 2], a3 = acc[j + 3];
+    int32_t b0 = acc_y[j], b1 = acc_y[j + 1], b2 = acc_y[j + 2], b3 = acc_y[j + 3];
+    int32_t x0 = xj[0], x1 = xj[1], x2 = xj[2];
+    int32_t y0 = yj[0], y1 = yj[1], y2 = yj[2];
+
+    for (n = 0; n < wt_dim; ++n) {
+      int32_t x3 = xj[n + 3];
+      int32_t y3 = yj[n + 3];
+      const char *qp = qsq + wk[n];
+      const char *qm = qsq - wk[n];
+
+      a0 += QSQ(qp, x0) - QSQ(qm, x0);
+      a1 += QSQ(qp, x1) - QSQ(qm, x1);
+      a2 += QSQ(qp, x2) - QSQ(qm, x2);
+      a3 += QSQ(qp, x3) - QSQ(qm, x3);
+      b0 += QSQ(qp, y0) - QSQ(qm, y0);
+      b1 += QSQ(qp, y1) - QSQ(qm, y1);
+      b2 += QSQ(qp, y2) - QSQ(qm, y2);
+      b3 += QSQ(qp, y3) - QSQ(qm, y3);
+      x0 = x1;
+      x1 = x2;
+      x2 = x3;
+      y0 = y1;
+      y1 = y2;
+      y2 = y3;
+    }
 
-          ofm[ofm_offset + ofm_idx] += tmp;
+    acc[j] = a0;
+    acc[j + 1] = a1;
+    acc[j + 2] = a2;
+    acc[j + 3] = a3;
+    acc_y[j] = b0;
+    acc_y[j + 1] = b1;
+    acc_y[j + 2] = b2;
+    acc_y[j + 3] = b3;
+  }
 
-          ofm_idx  += 1;
-          ifm_idx0 += 1;
-        } // j
+  for (; j < len; ++j) {
+    int32_t a = acc[j], b = acc_y[j];
+    for (n = 0; n < wt_dim; ++n) {
+      a += mul_q(x[j + n], wk[n]);
+      b += mul_q(y[j + n], wk[n]);
+    }
+    acc[j] = a;
+    acc_y[j] = b;
+  }
+}
 
-        ifm_idx0 += IMG_DIM - CV1_DIM;
-      } // i
+// Requantize one OFM value: >> 9 (after the channel scale of int4
+// weights, if any) and saturate to int8
+static int32_t requant(int32_t value, const int8_t *scale) {
+  if (scale)
+    value = times(value, *scale);
+  value >>= 9;
+  return (value > 127)  ?  127 :
+         (value < -128) ? -128 : value;
+}
 
-      ifm_offset += IMG_SIZE;
-      wt_offset  += WT1_SIZE;
-    } // d
+int32_t max4(int32_t a, int32_t b, int32_t c, int32_t d) {
+  int32_t tmp0 = (a > b) ? a : b;
+  int32_t tmp1 = (c > d) ? c : d;
+  int32_t result =  (tmp0 > tmp1) ? tmp0 : tmp1;
 
-    ofm_offset += CV1_SIZE;
-  } // f
+  return result;
 }
 
-void conv3D_sw_2(int8_t *ifm, int8_t *wt, int32_t *ofm) {
+void pool_row_q(const int32_t *ifm, int8_t *ofm, int ifm_dim, const int8_t *scale) {
+  int j;
 
-  int f, d, i, j, m, n;
-  int ofm_idx, ifm_idx, wt_idx;
+  for (j = 0; j < (ifm_dim >> 1); ++j) {
+    int32_t tmp0 = requant(ifm[(j << 1) + 0], scale);
+    int32_t tmp1 = requant(ifm[(j << 1) + 1], scale);
+    int32_t tmp2 = requant(ifm[(j << 1) + ifm_dim + 0], scale);
+    int32_t tmp3 = requant(ifm[(j << 1) + ifm_dim + 1], scale);
 
-  int ofm_offset = 0;
-  int ifm_offset = 0;
-  int wt_offset  = 0;
+    // ReLU
+    tmp0 = (tmp0 > 0) ? tmp0 : 0;
+    tmp1 = (tmp1 > 0) ? tmp1 : 0;
+    tmp2 = (tmp2 > 0) ? tmp2 : 0;
+    tmp3 = (tmp3 > 0) ? tmp3 : 0;
 
-  for (f = 0; f < CV2_DEPTH; ++f) {
+    ofm[j] = (int8_t)max4(tmp0, tmp1, tmp2, tmp3);
+  } // j
+}
 
-    ofm_idx = 0;
-    for (i = 0; i < CV2_DIM; ++i) {
-      for (j = 0; j < CV2_DIM; ++j) {
-        ofm[ofm_offset + ofm_idx] = 0;
-        ofm_idx += 1;
-      }
-    }
+void requant_pool(const int32_t *ifm, int8_t *ofm, int ifm_dim, int depth,
+                  const int8_t *scale) {
+  int d, i;
+  int ofm_dim = ifm_dim >> 1;
 
-    ifm_offset = 0;
-    for (d = 0; d < P1_DEPTH; ++d) {
+  for (d = 0; d < depth; ++d) {
+    for (i = 0; i < ofm_dim; ++i) {
+      pool_row_q(ifm + (d * ifm_dim + (i << 1)) * ifm_dim,
+                 ofm + (d * ofm_dim + i) * ofm_dim, ifm_dim,
+                 scale ? scale + d : NULL);
+    } // i
+  } // d
+}
 
-      ofm_idx = 0;
-      int ifm_idx0 = 0;
+// Convolution 3D + requantization + ReLU + MaxPooling2D of k images, one
+// pair of OFM rows at a time. Each filter is unpacked once and swept across
+// the k unpacked IFMs, two images per weight load (conv_row2)
+void conv_pool_sw_batch(const int8_t *ifm, int ifm_stride, int k,
+                        int ifm_dim, int ifm_depth,
+                        const int8_t *wt, int wt_dim,
+                        int8_t *ofm, int ofm_stride, int ofm_depth,
+                        const int8_t *scale, int32_t *scratch) {
+  int f, d, i, m, b;
+  int ofm_dim   = ifm_dim - wt_dim + 1;
+  int pool_dim  = ofm_dim >> 1;
+  int ifm_size  = ifm_dim * ifm_dim;
+  int ifm_words = ifm_depth * ifm_size;
+  int wt_size   = ifm_depth * wt_dim * wt_dim;
+
+  int32_t *x = scratch;
+  int32_t *w;
+  int32_t acc[2][2 * CNN_MAX_DIM];
+
+  qsq_init();
+  for (b = 0; b < k; ++b) {
+    unpack_s8x4(ifm, x, ifm_words);
+    ifm += ifm_stride;
+    x += ifm_words;
+  }
+  w = x;
 
-      for (i = 0; i < CV2_DIM; ++i) {
-        for (j = 0; j < CV2_DIM; ++j) {
-          wt_idx = 0;
+  for (f = 0; f < ofm_depth; ++f) {
+    const int32_t *xb = scratch;
+    int8_t *out = ofm + f * pool_dim * pool_dim;
 
-          int32_t tmp = 0;
-          int ifm_idx1 = 0;
+    unpack_s8x4(wt + f * wt_size, w, wt_size);
 
-          for (m = 0; m < WT2_DIM; ++m) {
-            for (n = 0; n < WT2_DIM; ++n) {
-              int32_t ifm_value = cast_si32(ifm[ifm_offset + ifm_idx0 + ifm_idx1]);
-              int32_t wt_value  = cast_si32(wt[wt_offset + wt_idx]);
-              int32_t prod = times(ifm_value, wt_value);
-              tmp += prod;
+    for (b = 0; b < k; b += 2) {
+      int pair = (b + 1 < k);
 
-              ifm_idx1 += 1;
-              wt_idx   += 1;
-            } // n
+      for (i = 0; i < pool_dim; ++i) {
+        for (m = 0; m < 2 * ofm_dim; ++m) {
+          acc[0][m] = 0;
+          acc[1][m] = 0;
+        }
 
-            ifm_idx1 += P1_DIM - WT2_DIM;
+        for (d = 0; d < ifm_depth; ++d) {
+          for (m = 0; m < wt_dim; ++m) {
+            const int32_t *row = xb + d * ifm_size + ((i << 1) + m) * ifm_dim;
+            const int32_t *wk  = w + (d * wt_dim + m) * wt_dim;
+
+            if (pair) {
+              conv_row2(row, row + ifm_words, wk, wt_dim, acc[0], acc[1], ofm_dim);
+              conv_row2(row + ifm_dim, row + ifm_words + ifm_dim, wk, wt_dim,
+                        acc[0] + ofm_dim, acc[1] + ofm_dim, ofm_dim);
+            } else {
+              conv_row(row, wk, wt_dim, acc[0], ofm_dim);
+              conv_row(row + ifm_dim, wk, wt_dim, acc[0] + ofm_dim, ofm_dim);
+            }
           } // m
+        } // d
 
-          ofm[ofm_offset + ofm_idx] += tmp;
-
-          ofm_idx  += 1;
-          ifm_idx0 += 1;
-        } // j
-
-        ifm_idx0 += P1_DIM - CV2_DIM;
+        pool_row_q(acc[0], out + i * pool_dim, ofm_dim, scale ? scale + f : NULL);
+        if (pair)
+          pool_row_q(acc[1], out + ofm_stride + i * pool_dim, ofm_dim,
+                     scale ? scale + f : NULL);
       } // i
 
-      ifm_offset += P1_SIZE;
-      wt_offset  += WT2_SIZE;
-    } // d
-
-    ofm_offset += CV2_SIZE;
+      xb += ifm_words << 1;
+      out += ofm_stride << 1;
+    } // b
   } // f
 }
 
-int32_t max4(int32_t a, int32_t b, int32_t c, int32_t d) {
-  int32_t tmp0 = (a > b) ? a : b;
-  int32_t tmp1 = (c > d) ? c : d;
-  int32_t result =  (tmp0 > tmp1) ? tmp0 : tmp1;
-
-  return result;
+void conv_pool_sw(const int8_t *ifm, int ifm_dim, int ifm_depth,
+                  const int8_t *wt, int wt_dim,
+                  int8_t *ofm, int ofm_depth,
+                  const int8_t *scale, int32_t *scratch) {
+  conv_pool_sw_batch(ifm, 0, 1, ifm_dim, ifm_depth, wt, wt_dim,
+                     ofm, 0, ofm_depth, scale, scratch);
 }
 
-// Max Pooling 2D
-void pooling_sw_1(int32_t *ifm, int8_t *ofm) {
-  
-  int d, i, j;
-  int ifm_offset = 0;
-  int ofm_offset = 0;
-
-  for (d = 0; d < P1_DEPTH; ++d) {
-    int ifm_idx = 0;
-    int ofm_idx = 0;
-
-    for (i = 0; i < P1_DIM; ++i) {
-      for (j = 0; j < P1_DIM; ++j) {
-        int32_t tmp0 = ifm[ifm_offset + (ifm_idx << 1) + 0];
-        int32_t tmp1 = ifm[ifm_offset + (ifm_idx << 1) + 1];
-        int32_t tmp2 = ifm[ifm_offset + (ifm_idx << 1) + CV1_DIM + 0];
-        int32_t tmp3 = ifm[ifm_offset + (ifm_idx << 1) + CV1_DIM + 1];
-
-        // ReLU
-        tmp0 = (tmp0 > 0) ? tmp0 : 0;
-        tmp1 = (tmp1 > 0) ? tmp1 : 0;
-        tmp2 = (tmp2 > 0) ? tmp2 : 0;
-        tmp3 = (tmp3 > 0) ? tmp3 : 0;
-
-        ofm[ofm_offset + ofm_idx] = (int8_t)max4(tmp0, tmp1, tmp2, tmp3);
-
-        ifm_idx += 1;
-        ofm_idx += 1;
-      } // j
+// Fully Connection of k images: each weight row is unpacked once, and each
+// weight is applied to two images per load
+void fc_sw_batch(const int8_t *ifm, int ifm_stride, int k,
+                 const int8_t *wt, int32_t *ofm,
+                 int ifm_len, int ofm_len, int32_t *scratch) {
+  int f, i, b;
+  int32_t *x = scratch;
+  int32_t *w;
+
+  qsq_init();
+  for (b = 0; b < k; ++b) {
+    unpack_s8x4(ifm, x, ifm_len);
+    ifm += ifm_stride;
+    x += ifm_len;
+  }
+  w = x;
 
-      ifm_idx += CV1_DIM - P1_DIM;
-    } // i
+  for (f = 0; f < ofm_len; ++f) {
+    const int32_t *xb = scratch;
+    int32_t *out = ofm + f;
 
-    ifm_offset += CV1_SIZE;
-    ofm_offset += P1_SIZE;
-  } // d
-}
+    unpack_s8x4(wt + f * ifm_len, w, ifm_len);
 
-void pooling_sw_2(int32_t *ifm, int8_t *ofm) {
-  
-  int d, i, j;
-  int ifm_offset = 0;
-  int ofm_offset = 0;
-
-  for (d = 0; d < P2_DEPTH; ++d) {
-    int ifm_idx = 0;
-    int ofm_idx = 0;
-
-    for (i = 0; i < P2_DIM; ++i) {
-      for (j = 0; j < P2_DIM; ++j) {
-        int32_t tmp0 = ifm[ifm_offset + (ifm_idx << 1) + 0];
-        int32_t tmp1 = ifm[ifm_offset + (ifm_idx << 1) + 1];
-        int32_t tmp2 = ifm[ifm_offset + (ifm_idx << 1) + CV2_DIM + 0];
-        int32_t tmp3 = ifm[ifm_offset + (ifm_idx << 1) + CV2_DIM + 1];
-
-        // ReLU
-        tmp0 = (tmp0 > 0) ? tmp0 : 0;
-        tmp1 = (tmp1 > 0) ? tmp1 : 0;
-        tmp2 = (tmp2 > 0) ? tmp2 : 0;
-        tmp3 = (tmp3 > 0) ? tmp3 : 0;
-
-        ofm[ofm_offset + ofm_idx] = (int8_t)max4(tmp0, tmp1, tmp2, tmp3);
-
-        ifm_idx += 1;
-        ofm_idx += 1;
-      } // j
+    for (b = 0; b + 2 <= k; b += 2) {
+      const int32_t *xc = xb + ifm_len;
+      int32_t tmp0 = 0, tmp1 = 0;
 
-      ifm_idx += CV2_DIM - P2_DIM;
-    } // i
+      for (i = 0; i < ifm_len; ++i) {
+        const char *qp = qsq + w[i];
+        const char *qm = qsq - w[i];
 
-    ifm_offset += CV2_SIZE;
-    ofm_offset += P2_SIZE;
-  } // d
-}
+        tmp0 += QSQ(qp, xb[i]) - QSQ(qm, xb[i]);
+        tmp1 += QSQ(qp, xc[i]) - QSQ(qm, xc[i]);
+      }
+      out[0] = tmp0;
+      out[ofm_len] = tmp1;
+      xb += ifm_len << 1;
+      out += ofm_len << 1;
+    }
+    if (b < k) {
+      int32_t tmp = 0;
 
-// Fully Connection
-void fc_sw(int8_t *ifm, int8_t *wt, int32_t *ofm) {
+      for (i = 0; i < ifm_len; ++i)
+        tmp += mul_q(xb[i], w[i]);
+      out[0] = tmp;
+    }
+  }
+}
 
-  int f, d, i, j;
-  int wt_offset = 0;
+void fc_sw(const int8_t *ifm, const int8_t *wt, int32_t *ofm,
+           int ifm_len, int ofm_len, int32_t *scratch) {
+  fc_sw_batch(ifm, 0, 1, wt, ofm, ifm_len, ofm_len, scratch);
+}
 
-  for (f = 0; f < FC_DEPTH; ++f) {
-    int ifm_offset = 0;
-    int32_t tmp = 0;
+#ifdef CNN_REF
+// Reference kernels (make kernels=REF), byte by byte with times(), to
+// check the ones above against and compare their cycle counts
+void conv3D_ref(const int8_t *ifm, int ifm_dim, int ifm_depth,
+                const int8_t *wt, int wt_dim,
+                int32_t *ofm, int ofm_depth) {
+  int f, d, i, j, m, n;
+  int ofm_dim = ifm_dim - wt_dim + 1;
+
+  for (f = 0; f < ofm_depth; ++f) {
+    for (i = 0; i < ofm_dim; ++i) {
+      for (j = 0; j < ofm_dim; ++j) {
+        int32_t tmp = 0;
+
+        for (d = 0; d < ifm_depth; ++d) {
+          for (m = 0; m < wt_dim; ++m) {
+            for (n = 0; n < wt_dim; ++n) {
+              int32_t ifm_value = cast_si32(ifm[(d * ifm_dim + i + m) * ifm_dim + j + n]);
+              int32_t wt_value  = cast_si32(wt[((f * ifm_depth + d) * wt_dim + m) * wt_dim + n]);
+              tmp += times(ifm_value, wt_value);
+            } // n
+          } // m
+        } // d
 
-    for (d = 0; d < P2_DEPTH; ++d) {
-      int ifm_idx = 0;
+        ofm[(f * ofm_dim + i) * ofm_dim + j] = tmp;
+      } // j
+    } // i
+  } // f
+}
 
-      for (i = 0; i < P2_DIM; ++i) {
-        for (j = 0; j < P2_DIM; ++j) {
-          int32_t ifm_value = cast_si32(ifm[ifm_offset + ifm_idx]);
-          int32_t wt_value  = cast_si32(wt[wt_offset + ifm_offset + ifm_idx]);
-          tmp += times(ifm_value, wt_value);
+void fc_ref(const int8_t *ifm, const int8_t *wt, int32_t *ofm,
+            int ifm_len, int ofm_len) {
+  int f, i;
 
-          ifm_idx += 1;
-        }
-      }
-      ifm_offset += P2_SIZE;
-    }
+  for (f = 0; f < ofm_len; ++f) {
+    int32_t tmp = 0;
+    for (i = 0; i < ifm_len; ++i)
+      tmp += times(cast_si32(ifm[i]), cast_si32(wt[f * ifm_len + i]));
     ofm[f] = tmp;
-    wt_offset += ifm_offset;
   }
 }
+#endif
 
-void clamp(int32_t *array, int len) {
+// Per-element scale (FC outputs computed with int4 weights)
+void scale_sw(int32_t *array, int8_t *scale, int len) {
   int i;
   for (i = 0; i < len; i++) {
-    int32_t value = array[i] >> 9;
-    array[i] = (value > 127)  ?  127 :
-               (value < -128) ? -128 : value;
+    array[i] = times(array[i], scale[i]);
+  }
+}
+
+// Unpack int4 weights (two per byte, low nibble first) to int8
+// The packed data may sit in the upper half of wt: byte i is read before
+// wt[2 * i + 1] is written
+void unpack_int4(int8_t *packed, int8_t *wt, int len) {
+  int i;
+  for (i = 0; i < len; i += 2) {
+    int32_t byte = packed[i >> 1];
+    int32_t lo = byte & 0xf;
+    int32_t hi = (byte >> 4) & 0xf;
+    wt[i]     = (lo > 7) ? (lo - 16) : lo;
+    wt[i + 1] = (hi > 7) ? (hi - 16) : hi;
   }
 }
@@ -6,6 +6,18 @@
 #define IMAGES_DDR_ADDR   0x10b4b4
 #define LABELS_DDR_ADDR   0x8855b4
 
+// Packed int4 conv2/fc weights and their per-channel scales
+// (output of scripts/quantize_int4, loaded after the test labels)
+#define WT_INT4_DDR_ADDR       0x888000
+#define SCALE_CONV2_DDR_ADDR   (WT_INT4_DDR_ADDR)
+#define SCALE_FC_DDR_ADDR      (WT_INT4_DDR_ADDR + 16)
+#define WT_CONV2_INT4_DDR_ADDR (WT_INT4_DDR_ADDR + 28)
+#define WT_FC_INT4_DDR_ADDR    (WT_CONV2_INT4_DDR_ADDR + WT_CONV2_SIZE / 2)
+#define WT_INT4_SCALES_SIZE    28
+
+// End of the data loaded into DDR (the int4 weights come last)
+#define DDR_DATA_END (WT_FC_INT4_DDR_ADDR + WT_FC_SIZE / 2)
+
 #define IMG_DIM   28
 #define IMG_DEPTH 1
 
@@ -67,10 +79,47 @@
 #define WT_CONV2_SIZE (CV2_DEPTH * P1_DEPTH * WT1_DIM * WT2_DIM)  // 3200
 #define WT_FC_SIZE    (FC_DEPTH * P2_DEPTH * WT3_DIM * WT3_DIM)   // 2560
 
-void conv3D_sw_1(int8_t *ifm, int8_t *wt, int32_t *ofm);
-void conv3D_sw_2(int8_t *ifm, int8_t *wt, int32_t *ofm);
-void pooling_sw_1(int32_t *ifm, int8_t *ofm);
-void pooling_sw_2(int32_t *ifm, int8_t *ofm);
-void fc_sw(int8_t *ifm, int8_t *wt, int32_t *ofm);
-void clamp(int32_t *array, int len);
+// Largest OFM row the kernels handle
+#define CNN_MAX_DIM 32
+
+// Scratch words for conv_pool_sw (the unpacked IFM and one filter) and fc_sw
+#define CONV_SCRATCH_SIZE(ifm_dim, ifm_depth, wt_dim) \
+  ((ifm_depth) * ((ifm_dim) * (ifm_dim) + (wt_dim) * (wt_dim)))
+#define FC_SCRATCH_SIZE(ifm_len) (2 * (ifm_len))
+// ... and for their batched forms on k images (k unpacked IFMs)
+#define CONV_BATCH_SCRATCH_SIZE(k, ifm_dim, ifm_depth, wt_dim) \
+  ((ifm_depth) * ((k) * (ifm_dim) * (ifm_dim) + (wt_dim) * (wt_dim)))
+#define FC_BATCH_SCRATCH_SIZE(k, ifm_len) (((k) + 1) * (ifm_len))
+
+// scale: per-channel requantization scales (int4 weights), or NULL
+void conv_pool_sw(const int8_t *ifm, int ifm_dim, int ifm_depth,
+                  const int8_t *wt, int wt_dim,
+                  int8_t *ofm, int ofm_depth,
+                  const int8_t *scale, int32_t *scratch);
+void requant_pool(const int32_t *ifm, int8_t *ofm, int ifm_dim, int depth,
+                  const int8_t *scale);
+void pool_row_q(const int32_t *ifm, int8_t *ofm, int ifm_dim, const int8_t *scale);
+void fc_sw(const int8_t *ifm, const int8_t *wt, int32_t *ofm,
+           int ifm_len, int ofm_len, int32_t *scratch);
+// The same on k images, ifm_stride bytes apart, each filter unpacked once
+// for all of them: image b goes to ofm + b * ofm_stride (bytes, conv) or
+// ofm + b * ofm_len (FC)
+void conv_pool_sw_batch(const int8_t *ifm, int ifm_stride, int k,
+                        int ifm_dim, int ifm_depth,
+                        const int8_t *wt, int wt_dim,
+                        int8_t *ofm, int ofm_stride, int ofm_depth,
+                        const int8_t *scale, int32_t *scratch);
+void fc_sw_batch(const int8_t *ifm, int ifm_stride, int k,
+                 const int8_t *wt, int32_t *ofm,
+                 int ifm_len, int ofm_len, int32_t *scratch);
+#ifdef CNN_REF
+void conv3D_ref(const int8_t *ifm, int ifm_dim, int ifm_depth,
+                const int8_t *wt, int wt_dim,
+                int32_t *ofm, int ofm_depth);
+void fc_ref(const int8_t *ifm, const int8_t *wt, int32_t *ofm,
+            int ifm_len, int ofm_len);
+#endif
+void scale_sw(int32_t *array, int8_t *scale, int len);
+void unpack_int4(int8_t *packed, int8_t *wt, int len);
+int32_t times(int32_t a, int32_t b);
 int32_t cast_si32(int8_t input);
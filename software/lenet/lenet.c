@@ -2,20 +2,122 @@
 #include "ascii.h"
 #include "uart.h"
 #include "memory_map.h"
+#include "dma.h"
+#include "axi_mon.h"
+#include "arena.h"
+#include "ddr.h"
 #include "cnn.h"
+#include "net.h"
 
 #define BUF_LEN 128
 
 #define NUM_TEST_IMAGES 128
 #define NUM_LABELS ((NUM_TEST_IMAGES < 4) ? 4 : NUM_TEST_IMAGES)
 
+// Images per pass over the weights of the CPU layers (make sw_batch=K, see
+// net_run_batch). 1: one image at a time, pipelined with net_step
+#ifndef SW_BATCH
+#define SW_BATCH 1
+#endif
+typedef char sw_batch_check[(SW_BATCH >= 1 && SW_BATCH <= NUM_TEST_IMAGES) ? 1 : -1];
+
 static int8_t wt_conv1[WT_CONV1_SIZE];
 static int8_t wt_conv2[WT_CONV2_SIZE];
 static int8_t wt_fc   [WT_FC_SIZE];
 
-static int8_t img[IMG_SIZE];
+// Double-buffered test images, SW_BATCH each (in the DMem pool): the DMA
+// loads the next image(s) while the current ones are being processed
+static int8_t *img[2];
 static char test_labels[NUM_TEST_IMAGES];
 
+// DDR scratch buffers (ddr.h) must not overlap the weights, images and
+// labels
+typedef char ddr_scratch_check[(DDR_DATA_END <= DDR_SCRATCH_BASE) ? 1 : -1];
+
+#ifdef WT_INT4
+// Per-channel scales of the int4 conv2/fc weights
+static int8_t wt_scales[WT_INT4_SCALES_SIZE];
+#define scale_conv2 (wt_scales)
+#define scale_fc    (wt_scales + (SCALE_FC_DDR_ADDR - SCALE_CONV2_DDR_ADDR))
+
+// The accelerator reads the packed conv2 weights directly
+#define WT_CONV2_XCEL_ADDR XCEL_WT_INT4(WT_CONV2_INT4_DDR_ADDR)
+#else
+#define WT_CONV2_XCEL_ADDR WT_CONV2_DDR_ADDR
+#define scale_conv2 ((int8_t *)NULL)
+#define scale_fc    ((int8_t *)NULL)
+#endif
+
+static layer_t lenet_layers[] = {
+  { LAYER_CONV_POOL, IMG_DIM, IMG_DEPTH, WT1_DIM, CV1_DEPTH, wt_conv1, WT_CONV1_DDR_ADDR,  NULL },
+  { LAYER_CONV_POOL, P1_DIM,  P1_DEPTH,  WT2_DIM, CV2_DEPTH, wt_conv2, WT_CONV2_XCEL_ADDR, scale_conv2 },
+  { LAYER_FC,        P2_DIM,  P2_DEPTH,  0,       FC_DEPTH,  wt_fc,    0,                  scale_fc },
+};
+#define NUM_LAYERS (sizeof(lenet_layers) / sizeof(lenet_layers[0]))
+
+// DMem pool for the executor buffers, the test images and the FC outputs.
+// net_init overlaps the executor buffers that are never in use together;
+// the most it needs is either conv1 and conv2 on the accelerator,
+// pipelined (see net_step): the conv1 OFM, the conv2 scratch, and the pool1
+// and pool2 OFMs; or a batch in conv2 on the CPU: the scratch of SW_BATCH
+// IFMs, and SW_BATCH pool1 and pool2 OFMs. Up to SW_BATCH 4, the batch
+// fits in the pipelined words; each image more costs about 1.8K words
+// (with its image and FC output), so 5 still fits in DMem
+#define NET_PIPE_WORDS  (CONV1_OFM_SIZE + CONV_SCRATCH_SIZE(P1_DIM, P1_DEPTH, WT2_DIM) + \
+                         POOL1_OFM_SIZE / 4 + POOL2_OFM_SIZE / 4)
+#define NET_BATCH_WORDS (CONV_BATCH_SCRATCH_SIZE(SW_BATCH, P1_DIM, P1_DEPTH, WT2_DIM) + \
+                         SW_BATCH * (POOL1_OFM_SIZE / 4 + POOL2_OFM_SIZE / 4))
+#define NET_ARENA_WORDS ((NET_PIPE_WORDS > NET_BATCH_WORDS) ? NET_PIPE_WORDS : NET_BATCH_WORDS)
+#define DMEM_POOL_WORDS (NET_ARENA_WORDS + SW_BATCH * (2 * (IMG_SIZE / 4) + FC_OFM_SIZE))
+static int32_t dmem_pool[DMEM_POOL_WORDS];
+
+#ifdef BATCH
+// Batch mode (make batch=1): nothing is printed per image. The results are
+// kept in one record stream, sent in binary at the end and decoded on the
+// host by scripts/lenet_decode. Little-endian: this header, count records,
+// then the CRC32 (as zlib's crc32()) of the header and the records
+#define RESULTS_MAGIC   0x544e4c7f // "\x7fLNT"
+#define RESULTS_VERSION 1
+
+typedef struct {
+  uint32_t cycles; // of the net_step call that finished the image (or
+                   // its share of its batch)
+  uint8_t  pred;
+  uint8_t  label;
+  uint16_t reserved;
+} result_t;
+
+static struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t count;
+  result_t records[NUM_TEST_IMAGES];
+} results;
+
+// Blocking binary write
+static void send(const void *buf, uint32_t n) {
+  const uint8_t *p = (const uint8_t *)buf;
+  while (n > 0) {
+    uint32_t sent = uwrite(p, n);
+    p += sent;
+    n -= sent;
+  }
+}
+
+static void send_results(void) {
+  uint32_t crc;
+
+  results.magic   = RESULTS_MAGIC;
+  results.version = RESULTS_VERSION;
+  results.count   = NUM_TEST_IMAGES;
+  crc = dma_checksum(&results, sizeof(results) >> 2, NULL);
+  uwrite_int8s("\r\n");
+  send(&results, sizeof(results));
+  send(&crc, sizeof(crc));
+  uflush();
+}
+#endif
+
 typedef void (*entry_t)(void);
 
 // Find the maximum value of FC_DEPTH elements
@@ -32,71 +134,41 @@ void findmax(int32_t *input, char *labels, int img_index) {
   }
 }
 
-void dma_read_ddr(uint32_t src_addr, uint32_t dst_addr, int dma_len) {
-  // Set the parameters for the DMA Engine
-  DMA_DIR      = 0; // DDR -> Riscv DMem
-  DMA_SRC_ADDR = src_addr;
-  DMA_DST_ADDR = dst_addr;
-  DMA_LEN      = dma_len; // number of 32-bit data transfers
-  DMA_START    = 1;
-
-  // Wait until the DMA finishes
-  while (!DMA_DONE);
-}
-
-void dma_write_ddr(uint32_t src_addr, uint32_t dst_addr, int dma_len) {
-  DMA_DIR      = 1; // Riscv DMem -> DDR
-  DMA_SRC_ADDR = src_addr;
-  DMA_DST_ADDR = dst_addr;
-  DMA_LEN      = dma_len; // number of 32-bit data transfers
-  DMA_START    = 1;
-
-  // Wait until the DMA finishes
-  while (!DMA_DONE);
+// rv32i has no divider, and libgcc is not linked
+static uint32_t udiv(uint32_t n, uint32_t d) {
+  uint32_t q = 0, r = 0;
+  int b;
+  for (b = 31; b >= 0; b--) {
+    r = (r << 1) | ((n >> b) & 1);
+    if (r >= d) {
+      r -= d;
+      q |= 1u << b;
+    }
+  }
+  return q;
 }
 
-void conv3D_hw(uint32_t ifm_ddr_addr, uint32_t wt_ddr_addr, uint32_t ofm_ddr_addr,
-               uint32_t ifm_dim, uint32_t ifm_depth,
-               uint32_t ofm_dim, uint32_t ofm_depth) {
-
-  // Set the parameters for the conv3D (xcel) accelerator
-  XCEL_IFM_DDR_ADDR = ifm_ddr_addr;
-  XCEL_WT_DDR_ADDR  = wt_ddr_addr;
-  XCEL_OFM_DDR_ADDR = ofm_ddr_addr;
-  XCEL_OFM_DIM      = ofm_dim;
-  XCEL_OFM_DEPTH    = ofm_depth;
-  XCEL_IFM_DIM      = ifm_dim;
-  XCEL_IFM_DEPTH    = ifm_depth;
-  XCEL_START        = 1;
-
-  // Wait until it finishes
-  while (!XCEL_DONE);
+void bios(void) {
+  // go back to the bios - using this function causes a jr to the addr,
+  // the compiler "jals" otherwise and then cannot set PC[31:28]
+  uint32_t bios = ascii_hex_to_uint32("40000000");
+  entry_t start = (entry_t) (bios);
+  start();
 }
 
-void lenet(int8_t *img, int8_t *wt_conv1, int8_t *wt_conv2, int8_t *wt_fc,
-           int32_t *conv1_ofm, int32_t *conv2_ofm,
-           int8_t *pool1_ofm, int8_t *pool2_ofm,
-           int32_t *fc_ofm,
-           char *labels, int img_index) {
-
-  conv3D_sw_1(img, wt_conv1, conv1_ofm);
-  clamp(conv1_ofm, CONV1_OFM_SIZE);
-  pooling_sw_1(conv1_ofm, pool1_ofm);
-  conv3D_sw_2(pool1_ofm, wt_conv2, conv2_ofm);
-  clamp(conv2_ofm, CONV2_OFM_SIZE);
-  pooling_sw_2(conv2_ofm, pool2_ofm);
-  fc_sw(pool2_ofm, wt_fc, fc_ofm);
-  findmax(fc_ofm, labels, img_index);
+// Start loading test images i to i + n - 1 into buf (does not wait)
+void img_prefetch(dma_desc_t *desc, int8_t *buf, int i, int n) {
+  dma_desc_init(desc, DMA_DDR_TO_DMEM, IMAGES_DDR_ADDR + i * IMG_SIZE,
+                (uint32_t)buf >> 2, n * (IMG_SIZE >> 2));
+  dma_chain(desc, 1);
+  dma_submit(desc);
 }
 
+// Computed by the DMA engine on the side of a DMem -> DMem pass over the
+// buffer, instead of a CPU loop
 int32_t checksum_i32(int32_t *input, int len) {
-  int32_t sum = 0;
-  int i;
-  for (i = 0; i < len; i++) {
-    int32_t val = (input[i]);
-    sum += val;
-  }
-
+  uint32_t sum;
+  dma_checksum(input, len, &sum);
   return sum;
 }
 
@@ -111,122 +183,246 @@ int32_t checksum_i8(int8_t *input, int len) {
   return sum;
 }
 
+static char pred_labels[NUM_LABELS];
+static uint32_t num_corrects;
+// Sum of all FC outputs, to check kernel changes (e.g. kernels=REF) are
+// bit-exact over the whole run
+static uint32_t fc_checksum;
+
+// Check (and print, or record) the prediction of image j
+static void finish_image(int j, int32_t *fc_out, uint32_t img_time) {
+  fc_checksum += checksum_i32(fc_out, FC_OFM_SIZE);
+  if (pred_labels[j] == test_labels[j])
+    num_corrects += 1;
+
+#ifdef BATCH
+  results.records[j].cycles = img_time;
+  results.records[j].pred   = pred_labels[j];
+  results.records[j].label  = test_labels[j];
+#else
+  int8_t buffer[BUF_LEN];
+
+  uwrite_int8s("\r\n>>> Processed image: ");
+  uwrite_int8s(uint32_to_ascii_hex(j, buffer, BUF_LEN));
+  uwrite_int8s("\r\nCycles: ");
+  uwrite_int8s(uint32_to_ascii_hex(img_time, buffer, BUF_LEN));
+  uwrite_int8s("\r\nPrediction: ");
+  uwrite_int8s(uint32_to_ascii_hex(pred_labels[j], buffer, BUF_LEN));
+  uwrite_int8s("\r\nGroundtruth: ");
+  uwrite_int8s(uint32_to_ascii_hex(test_labels[j], buffer, BUF_LEN));
+
+  if (pred_labels[j] != test_labels[j])
+    uwrite_int8s("\r\nMispredicted!");
+#endif
+}
+
+#if SW_BATCH > 1
+// Cycles/image of net_run_batch for K = 1, 2, 4, ... SW_BATCH images, on
+// the images in imgs: the weights of the CPU layers are unpacked once per
+// batch, and each weight load feeds two images
+static void batch_sweep(net_t *net, const int8_t *imgs, int32_t *out) {
+  int8_t buffer[BUF_LEN];
+  uint32_t k = 1;
+
+  while (1) {
+    COUNTER_RST = 0;
+    net_run_batch(net, imgs, IMG_SIZE, k, out);
+    uint32_t cycles = CYCLE_COUNTER;
+
+    uwrite_int8s("\r\nK=");
+    uwrite_int8s(uint32_to_ascii_hex(k, buffer, BUF_LEN));
+    uwrite_int8s(" Cycles/image: ");
+    uwrite_int8s(uint32_to_ascii_hex(udiv(cycles, k), buffer, BUF_LEN));
+    if (k == SW_BATCH)
+      break;
+    k = (k << 1 < SW_BATCH) ? k << 1 : SW_BATCH;
+  }
+}
+#endif
+
 int main(int argc, char**argv) {
   int8_t buffer[BUF_LEN];
   int i;
 
-  // Load wt_conv1
-  dma_read_ddr(WT_CONV1_DDR_ADDR,
-               (uint32_t)wt_conv1 >> 2,
-               WT_CONV1_SIZE >> 2);
-  // Load wt_conv2
-  dma_read_ddr(WT_CONV2_DDR_ADDR,
-               (uint32_t)wt_conv2 >> 2,
-               WT_CONV2_SIZE >> 2);
-  // Load wt_fc
-  dma_read_ddr(WT_FC_DDR_ADDR,
-               (uint32_t)wt_fc >> 2,
-               WT_FC_SIZE >> 2);
+  // Load the weights and the groundtruth labels with one descriptor chain
+  static dma_desc_t loads[5];
+  int num_loads = 0;
+
+  dma_desc_init(&loads[num_loads++], DMA_DDR_TO_DMEM, WT_CONV1_DDR_ADDR,
+                (uint32_t)wt_conv1 >> 2, WT_CONV1_SIZE >> 2);
+#ifdef WT_INT4
+  // The int4 weight scales, then the packed wt_conv2 and wt_fc into the
+  // upper half of their buffers (unpacked in place below)
+  dma_desc_init(&loads[num_loads++], DMA_DDR_TO_DMEM, SCALE_CONV2_DDR_ADDR,
+                (uint32_t)wt_scales >> 2, WT_INT4_SCALES_SIZE >> 2);
+  dma_desc_init(&loads[num_loads++], DMA_DDR_TO_DMEM, WT_CONV2_INT4_DDR_ADDR,
+                (uint32_t)(wt_conv2 + WT_CONV2_SIZE / 2) >> 2, WT_CONV2_SIZE >> 3);
+  dma_desc_init(&loads[num_loads++], DMA_DDR_TO_DMEM, WT_FC_INT4_DDR_ADDR,
+                (uint32_t)(wt_fc + WT_FC_SIZE / 2) >> 2, WT_FC_SIZE >> 3);
+#else
+  dma_desc_init(&loads[num_loads++], DMA_DDR_TO_DMEM, WT_CONV2_DDR_ADDR,
+                (uint32_t)wt_conv2 >> 2, WT_CONV2_SIZE >> 2);
+  dma_desc_init(&loads[num_loads++], DMA_DDR_TO_DMEM, WT_FC_DDR_ADDR,
+                (uint32_t)wt_fc >> 2, WT_FC_SIZE >> 2);
+#endif
 
   uint32_t num_labels = (NUM_TEST_IMAGES < 4) ? 4 : (NUM_TEST_IMAGES >> 2);
-  // Load groundtruth labels
-  dma_read_ddr(LABELS_DDR_ADDR,
-               (uint32_t)test_labels >> 2,
-               num_labels);
-
-  int32_t conv1_ofm[CONV1_OFM_SIZE];
-  int32_t conv2_ofm[CONV2_OFM_SIZE];
+  dma_desc_init(&loads[num_loads++], DMA_DDR_TO_DMEM, LABELS_DDR_ADDR,
+                (uint32_t)test_labels >> 2, num_labels);
+
+  dma_chain(loads, num_loads);
+  dma_submit(loads);
+  dma_wait();
+
+  // The DMA checksums everything it loaded on the way
+  uint32_t load_crc = dma_crc32();
+  uwrite_int8s("\r\nWeights and labels crc32: ");
+  uwrite_int8s(uint32_to_ascii_hex(load_crc, buffer, BUF_LEN));
+#ifdef LOAD_CRC32
+  // Expected value (make load_crc=0x...)
+  if (load_crc != LOAD_CRC32)
+    uwrite_int8s("\r\nCorrupted weights or labels!");
+#endif
 
-  int8_t pool1_ofm[POOL1_OFM_SIZE];
-  int8_t pool2_ofm[POOL2_OFM_SIZE];
+#ifdef WT_INT4
+  // for the software conv2 and fc
+  unpack_int4(wt_conv2 + WT_CONV2_SIZE / 2, wt_conv2, WT_CONV2_SIZE);
+  unpack_int4(wt_fc + WT_FC_SIZE / 2, wt_fc, WT_FC_SIZE);
+#endif
 
-  int32_t fc_ofm[FC_OFM_SIZE];
+  static arena_t dmem;
+  uint32_t net_words = net_arena_words(lenet_layers, NUM_LAYERS, SW_BATCH);
+  arena_init(&dmem, dmem_pool, sizeof(dmem_pool));
+  int32_t *net_arena = arena_alloc(&dmem, net_words << 2);
+  img[0] = arena_alloc(&dmem, SW_BATCH * IMG_SIZE);
+  img[1] = arena_alloc(&dmem, SW_BATCH * IMG_SIZE);
+  int32_t *fc_ofm = arena_alloc(&dmem, SW_BATCH * FC_OFM_SIZE << 2);
+  if (!net_arena || !img[0] || !img[1] || !fc_ofm) {
+    uwrite_int8s("\r\nDMEM_POOL_WORDS too small");
+    bios();
+  }
 
-  char pred_labels[NUM_LABELS];
-  uint32_t num_corrects = 0;
   uint32_t time = 0;
-  for (i = 0; i < NUM_TEST_IMAGES; i++) {
-    uwrite_int8s("\r\n>>> Processing image: ");
-    uwrite_int8s(uint32_to_ascii_hex(i, buffer, BUF_LEN));
 
-    // Benchmark
-    COUNTER_RST = 0;
+  static dma_desc_t img_load;
+  img_prefetch(&img_load, img[0], 0, SW_BATCH);
+  dma_wait();
+
+  static net_t net;
+  if (net_init(&net, lenet_layers, NUM_LAYERS, SW_BATCH, net_arena, net_words)) {
+    uwrite_int8s("\r\nToo many layers");
+    bios();
+  }
 
 #ifdef HW
-    // Perform conv3D on the accelerator
-    // Write the OFM result to DDR at address 0x90_0000
-    conv3D_hw(IMAGES_DDR_ADDR + i * IMG_SIZE, WT_CONV1_DDR_ADDR, 0x900000,
-              IMG_DIM, IMG_DEPTH, CV1_DIM, CV1_DEPTH);
-
-    // Read the OFM result (computed by the accelerator) to the
-    // local conv1_ofm in RISC-V DMem
-    dma_read_ddr(0x900000, (uint32_t)conv1_ofm >> 2, CONV1_OFM_SIZE);
-
-    clamp(conv1_ofm, CONV1_OFM_SIZE);
-    // Perform MaxPooling2D on RISC-V
-    pooling_sw_1(conv1_ofm, pool1_ofm);
-
-    // Send the IFM (maxpool result) to the DDR at address 0x90_0000
-    // so that the conv3D accelerator can read from it
-    dma_write_ddr((uint32_t)pool1_ofm >> 2, 0x900000, POOL1_OFM_SIZE >> 2);
-
-    // Perform conv3D on the accelerator
-    // Read IFM from DDR 0x90_0000
-    // Write the OFM result to 0x91_0000
-    conv3D_hw(0x900000, WT_CONV2_DDR_ADDR, 0x910000,
-              P1_DIM, P1_DEPTH, CV2_DIM, CV2_DEPTH);
-
-    // Read the OFM result (computed by the accelerator) to the
-    // local conv2_ofm in RISC-V DMem
-    dma_read_ddr(0x910000, (uint32_t)conv2_ofm >> 2, CONV2_OFM_SIZE);
-
-    clamp(conv2_ofm, CONV2_OFM_SIZE);
-    // Perform MaxPooling2D on RISC-V
-    pooling_sw_2(conv2_ofm, pool2_ofm);
-
-    // Perform Fully-connected computation on RISC-V
-    fc_sw(pool2_ofm, wt_fc, fc_ofm);
-    findmax(fc_ofm, pred_labels, i);
+  net_force(&net, ENGINE_XCEL);
+#elif defined(HW_STREAM)
+  // Same partition as HW, but MaxPooling2D of each conv3D layer runs row by
+  // row on RISC-V while the accelerator is still computing
+  net_force(&net, ENGINE_XCEL_STREAM);
+#elif defined(AUTO)
+  // Time each layer on every engine (on the first image), keep the fastest
+  net_calibrate(&net, img[0], fc_ofm);
 #else
-    // Read image from DDR
-    dma_read_ddr(IMAGES_DDR_ADDR + i * IMG_SIZE,
-                 (uint32_t)img >> 2,
-                 (IMG_SIZE) >> 2);
-
-    // Run the entire LeNet on RISC-V
-    lenet(img, wt_conv1, wt_conv2, wt_fc,
-          conv1_ofm, conv2_ofm,
-          pool1_ofm, pool2_ofm,
-          fc_ofm,
-          pred_labels, i);
+  net_force(&net, ENGINE_CPU);
+#endif
+  net_report(&net);
+  uwrite_int8s("\r\nDMem pool: ");
+  uwrite_int8s(uint32_to_ascii_hex(dmem.peak >> 2, buffer, BUF_LEN));
+  uwrite_int8s(" of ");
+  uwrite_int8s(uint32_to_ascii_hex(DMEM_POOL_WORDS, buffer, BUF_LEN));
+  uwrite_int8s(" words");
+
+#if SW_BATCH > 1
+  batch_sweep(&net, img[0], fc_ofm);
 #endif
 
-    time += CYCLE_COUNTER;
+  // DDR traffic of the whole run (DMA prefetches, accelerator reads/writes)
+  axi_mon_clear();
 
-    uwrite_int8s("\r\nPrediction: ");
-    uwrite_int8s(uint32_to_ascii_hex(pred_labels[i], buffer, BUF_LEN));
-    uwrite_int8s("\r\nGroundtruth: ");
-    uwrite_int8s(uint32_to_ascii_hex(test_labels[i], buffer, BUF_LEN));
+#if SW_BATCH > 1
+  // SW_BATCH images per step, in one net_run_batch call; the DMA loads the
+  // next batch meanwhile
+  int cur = 0;
+  for (i = 0; i < NUM_TEST_IMAGES; i += SW_BATCH) {
+    int n = (NUM_TEST_IMAGES - i < SW_BATCH) ? NUM_TEST_IMAGES - i : SW_BATCH;
+    int next = i + n;
+    int j;
 
-    if (pred_labels[i] == test_labels[i]) {
-      num_corrects += 1;
-    } else {
-      uwrite_int8s("\r\nMispredicted!");
-    }
+    // Benchmark
+    COUNTER_RST = 0;
+
+    if (next < NUM_TEST_IMAGES)
+      img_prefetch(&img_load, img[cur ^ 1], next,
+                   (NUM_TEST_IMAGES - next < SW_BATCH) ? NUM_TEST_IMAGES - next : SW_BATCH);
+
+    net_run_batch(&net, img[cur], IMG_SIZE, n, fc_ofm);
+    for (j = 0; j < n; j++)
+      findmax(fc_ofm + j * FC_OFM_SIZE, pred_labels, i + j);
+
+    // The next batch must be in before it is used
+    dma_wait();
+
+    uint32_t batch_time = CYCLE_COUNTER;
+    time += batch_time;
+
+    for (j = 0; j < n; j++)
+      finish_image(i + j, fc_ofm + j * FC_OFM_SIZE, udiv(batch_time, n));
+    cur ^= 1;
   }
+#else
+  // Image i goes in and image i - 1 comes out of each step: with xcel=HW
+  // the accelerator runs conv1 of image i while the CPU finishes image
+  // i - 1, and the DMA loads image i + 1 meanwhile
+  for (i = 0; i <= NUM_TEST_IMAGES; i++) {
+    int8_t *cur_img = (i < NUM_TEST_IMAGES) ? img[i & 1] : NULL;
+    int j = i - 1;
+
+    // Benchmark
+    COUNTER_RST = 0;
+
+    // Load the next image into the buffer of image i - 1: only its
+    // activations are still needed (the arbiter interleaves the DMA with
+    // the accelerator traffic)
+    if (i + 1 < NUM_TEST_IMAGES)
+      img_prefetch(&img_load, img[(i + 1) & 1], i + 1, 1);
+
+    // The image was prefetched to DMem; the accelerator (if used) reads it
+    // and writes its OFM in DMem directly
+    int done = net_step(&net, cur_img, fc_ofm);
+    if (done)
+      findmax(fc_ofm, pred_labels, j);
+
+    // The next image must be in before it is used
+    dma_wait();
+
+    uint32_t img_time = CYCLE_COUNTER;
+    time += img_time;
+
+    if (done)
+      finish_image(j, fc_ofm, img_time);
+  }
+#endif
 
   uwrite_int8s("\r\nCycle Count: ");
   uwrite_int8s(uint32_to_ascii_hex(time, buffer, BUF_LEN));
+  uwrite_int8s("\r\nCycles/image: ");
+  uwrite_int8s(uint32_to_ascii_hex(udiv(time, NUM_TEST_IMAGES), buffer, BUF_LEN));
+
+  uwrite_int8s("\r\nFC checksum: ");
+  uwrite_int8s(uint32_to_ascii_hex(fc_checksum, buffer, BUF_LEN));
+
+  axi_mon_report();
 
   uwrite_int8s("\r\nNumber of test images: ");
   uwrite_int8s(uint32_to_ascii_hex(NUM_TEST_IMAGES, buffer, BUF_LEN));
   uwrite_int8s("\r\nNumber of correct predictions: ");
   uwrite_int8s(uint32_to_ascii_hex(num_corrects, buffer, BUF_LEN));
 
-  // go back to the bios - using this function causes a jr to the addr,
-  // the compiler "jals" otherwise and then cannot set PC[31:28]
-  uint32_t bios = ascii_hex_to_uint32("40000000");
-  entry_t start = (entry_t) (bios);
-  start();
+#ifdef BATCH
+  send_results();
+#endif
+
+  bios();
   return 0;
 }
@@ -0,0 +1,459 @@
+#include "types.h"
+#include "ascii.h"
+#include "uart.h"
+#include "memory_map.h"
+#include "xcel.h"
+#include "cnn.h"
+#include "net.h"
+
+#define BUF_LEN 32
+
+static uint32_t ofm_dim(const layer_t *l) {
+  return l->ifm_dim - l->wt_dim + 1;
+}
+
+static uint32_t ifm_len(const layer_t *l) {
+  return l->ifm_dim * l->ifm_dim * l->ifm_depth;
+}
+
+// Output bytes of a conv layer (after pooling), or words of an FC layer
+static uint32_t act_len(const layer_t *l) {
+  uint32_t pool_dim = ofm_dim(l) >> 1;
+
+  if (l->type == LAYER_FC)
+    return l->ofm_depth;
+  return pool_dim * pool_dim * l->ofm_depth;
+}
+
+// Bytes between the activations of two images of a batch (word aligned)
+static uint32_t act_stride(const layer_t *l) {
+  return (act_len(l) + 3) & ~3u;
+}
+
+// Words of the layer's OFM buffer: the int32 OFM (accelerator, and the
+// reference CPU kernels) or the CPU kernel scratch for batch images
+static uint32_t ofm_words(const layer_t *l, uint32_t batch) {
+  uint32_t dim = ofm_dim(l);
+  uint32_t words;
+
+  if (l->type == LAYER_FC)
+    return FC_BATCH_SCRATCH_SIZE(batch, ifm_len(l));
+  words = CONV_BATCH_SCRATCH_SIZE(batch, l->ifm_dim, l->ifm_depth, l->wt_dim);
+  return (dim * dim * l->ofm_depth > words) ? dim * dim * l->ofm_depth : words;
+}
+
+static int supports(const layer_t *l, uint32_t engine) {
+  return engine == ENGINE_CPU ||
+         (l->type == LAYER_CONV_POOL && l->wt_xcel_addr != 0);
+}
+
+// First layer of the part of an image net_step defers to the next call: the
+// last accelerator layer if the first layer runs on the accelerator too
+// (the next image's first layer then starts right after it), else the last
+// layer
+static uint32_t tail_layer(const net_t *net) {
+  uint32_t i;
+
+  if (net->layers[0].engine == ENGINE_XCEL) {
+    for (i = net->num_layers - 1; i > 0; i--) {
+      if (net->layers[i].engine == ENGINE_XCEL)
+        return i;
+    }
+  }
+  return net->num_layers - 1;
+}
+
+// Whether net_step overlaps the first layer of an image with the tail of
+// the previous one
+static uint32_t pipelined(const net_t *net, uint32_t tail) {
+  return tail > 0 && net->layers[0].engine == ENGINE_XCEL &&
+         net->layers[tail].engine == ENGINE_XCEL;
+}
+
+// Buffer planning. Layer k has an OFM buffer (buffer 2k), live while it
+// runs, and a conv layer an activation buffer (2k + 1, the pooled output),
+// live until layer k + 1 is done: bit k of the live mask is layer k. With
+// a batch, each activation buffer holds that many images and the CPU
+// scratch that many IFMs. When net_step pipelines with tail layer t (one
+// image at a time), the accelerator writes the layer 0 OFM of the next
+// image while the layers from t on finish the previous one, so that buffer
+// is live in those layers too. Buffers live in a common
+// layer get disjoint words, the others may share them
+typedef struct {
+  uint32_t words;
+  uint32_t live;
+  uint32_t offset;
+} buf_t;
+
+// pipe_tail: t, or 0 without pipelining. Returns the words used
+static uint32_t plan(const layer_t *layers, uint32_t num_layers, uint32_t pipe_tail,
+                     uint32_t batch, buf_t *bufs) {
+  uint32_t order[2 * NET_MAX_LAYERS];
+  uint32_t n = 2 * num_layers;
+  uint32_t peak = 0;
+  uint32_t i, j;
+
+  for (i = 0; i < num_layers; i++) {
+    const layer_t *l = &layers[i];
+    bufs[2 * i].words     = ofm_words(l, batch);
+    bufs[2 * i].live      = 1u << i;
+    bufs[2 * i + 1].words = (l->type == LAYER_CONV_POOL) ? batch * (act_stride(l) >> 2) : 0;
+    bufs[2 * i + 1].live  = 3u << i;
+  }
+  if (pipe_tail)
+    bufs[0].live |= ~((1u << pipe_tail) - 1);
+
+  // Largest first
+  for (i = 0; i < n; i++) {
+    for (j = i; j > 0 && bufs[order[j - 1]].words < bufs[i].words; j--)
+      order[j] = order[j - 1];
+    order[j] = i;
+  }
+
+  // Each buffer at the lowest offset clear of the placed buffers live in a
+  // common layer
+  for (i = 0; i < n; i++) {
+    buf_t *b = &bufs[order[i]];
+    uint32_t offset = 0, moved = 1;
+
+    while (moved) {
+      moved = 0;
+      for (j = 0; j < i; j++) {
+        const buf_t *p = &bufs[order[j]];
+        if ((p->live & b->live) && offset < p->offset + p->words &&
+            p->offset < offset + b->words) {
+          offset = p->offset + p->words;
+          moved = 1;
+        }
+      }
+    }
+    b->offset = offset;
+    if (offset + b->words > peak)
+      peak = offset + b->words;
+  }
+  return peak;
+}
+
+// Point the layers at their buffers, for the engines they run on: one
+// image when pipelined, else the batch
+static void net_plan(net_t *net) {
+  buf_t bufs[2 * NET_MAX_LAYERS];
+  uint32_t tail = tail_layer(net);
+  uint32_t i;
+
+  if (pipelined(net, tail))
+    net->peak_words = plan(net->layers, net->num_layers, tail, 1, bufs);
+  else
+    net->peak_words = plan(net->layers, net->num_layers, 0, net->batch, bufs);
+  for (i = 0; i < net->num_layers; i++) {
+    layer_t *l = &net->layers[i];
+    l->ofm = net->arena + bufs[2 * i].offset;
+    l->act = (int8_t *)(net->arena + bufs[2 * i + 1].offset);
+  }
+}
+
+uint32_t net_arena_words(const layer_t *layers, uint32_t num_layers, uint32_t batch) {
+  buf_t bufs[2 * NET_MAX_LAYERS];
+  uint32_t words, t;
+
+  // Without pipelining, or with any accelerator layer as the tail
+  words = plan(layers, num_layers, 0, batch, bufs);
+  if (!supports(&layers[0], ENGINE_XCEL))
+    return words;
+  for (t = 1; t < num_layers; t++) {
+    uint32_t w;
+    if (!supports(&layers[t], ENGINE_XCEL))
+      continue;
+    w = plan(layers, num_layers, t, 1, bufs);
+    if (w > words)
+      words = w;
+  }
+  return words;
+}
+
+int net_init(net_t *net, layer_t *layers, uint32_t num_layers, uint32_t batch,
+             int32_t *arena, uint32_t arena_words) {
+  if (num_layers > NET_MAX_LAYERS || batch == 0 ||
+      net_arena_words(layers, num_layers, batch) > arena_words)
+    return -1;
+
+  net->layers      = layers;
+  net->num_layers  = num_layers;
+  net->arena       = arena;
+  net->arena_words = arena_words;
+  net->batch       = batch;
+  net->pending     = 0;
+  net_force(net, ENGINE_CPU);
+  return 0;
+}
+
+static void xcel_start(const layer_t *l, const int8_t *in, int32_t *ofm) {
+  xcel_job_t job;
+
+  // The accelerator reads the IFM from and writes the OFM to DMem directly
+  job.ifm_addr  = XCEL_DMEM_ADDR(in);
+  job.wt_addr   = l->wt_xcel_addr;
+  job.ofm_addr  = XCEL_DMEM_ADDR(ofm);
+  job.ifm_dim   = l->ifm_dim;
+  job.ifm_depth = l->ifm_depth;
+  job.ofm_dim   = ofm_dim(l);
+  job.ofm_depth = l->ofm_depth;
+  xcel_submit(&job);
+}
+
+// Requantization + MaxPooling2D of the OFM of a running accelerator job, two OFM
+// rows at a time: the accelerator writes the OFM straight into DMem, and as
+// soon as it reports that the rows feeding one pooled row are done, pool
+// them while the accelerator keeps computing the later rows.
+// Assume ofm_dim is even, so a row pair never crosses an output channel
+// scale: per-channel requantization scales (int4 weights), or NULL
+static void pooling_hw_stream(int32_t *ofm, int8_t *pool_ofm, int ofm_dim, int ofm_depth,
+                              int8_t *scale) {
+  int pool_dim = ofm_dim >> 1;
+  int num_rows = ofm_dim * ofm_depth;
+  int r;
+  int ch = 0, ch_row = 0;
+
+  for (r = 0; r < num_rows; r += 2) {
+    int32_t *rows = ofm + r * ofm_dim;
+
+    // Wait until OFM rows r and r + 1 are done
+    while (xcel_progress() < r + 2);
+
+    pool_row_q(rows, pool_ofm + (r >> 1) * pool_dim, ofm_dim, scale ? scale + ch : NULL);
+
+    ch_row += 2;
+    if (ch_row == ofm_dim) {
+      ch_row = 0;
+      ch += 1;
+    }
+  }
+
+  xcel_wait();
+}
+
+// out: the pooled output (conv layers)
+static void run_layer(layer_t *l, uint32_t engine, const int8_t *in, int8_t *out,
+                      int32_t *fc_out) {
+  uint32_t dim = ofm_dim(l);
+  int32_t *ofm = l->ofm;
+
+  if (l->type == LAYER_FC) {
+#ifdef CNN_REF
+    fc_ref(in, l->wt, fc_out, ifm_len(l), l->ofm_depth);
+#else
+    fc_sw(in, l->wt, fc_out, ifm_len(l), l->ofm_depth, ofm);
+#endif
+    if (l->scale)
+      scale_sw(fc_out, l->scale, l->ofm_depth);
+    return;
+  }
+
+  if (engine == ENGINE_CPU) {
+#ifdef CNN_REF
+    conv3D_ref(in, l->ifm_dim, l->ifm_depth, l->wt, l->wt_dim, ofm, l->ofm_depth);
+    requant_pool(ofm, out, dim, l->ofm_depth, l->scale);
+#else
+    conv_pool_sw(in, l->ifm_dim, l->ifm_depth, l->wt, l->wt_dim,
+                 out, l->ofm_depth, l->scale, ofm);
+#endif
+    return;
+  }
+
+  xcel_start(l, in, ofm);
+  if (engine == ENGINE_XCEL_STREAM) {
+    pooling_hw_stream(ofm, out, dim, l->ofm_depth, l->scale);
+  } else {
+    xcel_wait();
+    requant_pool(ofm, out, dim, l->ofm_depth, l->scale);
+  }
+}
+
+void net_force(net_t *net, uint32_t engine) {
+  uint32_t i;
+
+  for (i = 0; i < net->num_layers; i++) {
+    layer_t *l = &net->layers[i];
+    l->engine = supports(l, engine) ? engine : ENGINE_CPU;
+  }
+  net_plan(net);
+}
+
+void net_run(net_t *net, const int8_t *in, int32_t *out) {
+  uint32_t i;
+
+  for (i = 0; i < net->num_layers; i++) {
+    layer_t *l = &net->layers[i];
+    run_layer(l, l->engine, in, l->act, out);
+    in = l->act;
+  }
+}
+
+// Layer l on k images, in_stride bytes apart, into its k activation slots
+// (or k FC outputs, one after the other). The CPU kernels unpack each
+// filter once for the k images; the accelerator takes them one by one
+static void run_layer_batch(layer_t *l, const int8_t *in, uint32_t in_stride,
+                            uint32_t k, int32_t *fc_out) {
+  int8_t *out = l->act;
+  uint32_t j;
+
+#ifndef CNN_REF
+  if (l->type == LAYER_FC) {
+    fc_sw_batch(in, in_stride, k, l->wt, fc_out, ifm_len(l), l->ofm_depth, l->ofm);
+    for (j = 0; l->scale && j < k; j++, fc_out += l->ofm_depth)
+      scale_sw(fc_out, l->scale, l->ofm_depth);
+    return;
+  }
+  if (l->engine == ENGINE_CPU) {
+    conv_pool_sw_batch(in, in_stride, k, l->ifm_dim, l->ifm_depth, l->wt, l->wt_dim,
+                       out, act_stride(l), l->ofm_depth, l->scale, l->ofm);
+    return;
+  }
+#endif
+  for (j = 0; j < k; j++) {
+    run_layer(l, l->engine, in, out, fc_out);
+    in += in_stride;
+    out += act_stride(l);
+    fc_out += l->ofm_depth;
+  }
+}
+
+void net_run_batch(net_t *net, const int8_t *in, uint32_t in_stride, uint32_t k,
+                   int32_t *out) {
+  uint32_t i;
+
+  // Pipelined engines: the buffers only hold one image
+  if (pipelined(net, tail_layer(net))) {
+    for (; k > 0; k--) {
+      net_run(net, in, out);
+      in += in_stride;
+      out += net->layers[net->num_layers - 1].ofm_depth;
+    }
+    return;
+  }
+
+  for (i = 0; i < net->num_layers; i++) {
+    layer_t *l = &net->layers[i];
+    run_layer_batch(l, in, in_stride, k, out);
+    in = l->act;
+    in_stride = act_stride(l);
+  }
+}
+
+// Finish the deferred part of the previous image. Its accelerator layer
+// (if pipelined) is done; the accelerator may be writing the layer 0 OFM of
+// the next image meanwhile, which net_plan keeps apart from these buffers
+static void run_tail(net_t *net, uint32_t tail, int32_t *out) {
+  const int8_t *x = net->tail_in;
+  uint32_t i = tail;
+
+  if (pipelined(net, tail)) {
+    layer_t *l = &net->layers[tail];
+    requant_pool(l->ofm, l->act, ofm_dim(l), l->ofm_depth, l->scale);
+    x = l->act;
+    i++;
+  }
+  for (; i < net->num_layers; i++) {
+    layer_t *l = &net->layers[i];
+    run_layer(l, l->engine, x, l->act, out);
+    x = l->act;
+  }
+}
+
+int net_step(net_t *net, const int8_t *in, int32_t *out) {
+  uint32_t tail = tail_layer(net);
+  uint32_t pipe = pipelined(net, tail);
+  int done = net->pending;
+  const int8_t *x = in;
+  uint32_t i = 0;
+
+  // The accelerator is free once the previous image's last layer on it is
+  // done: start the first layer of this image, then finish the previous
+  // image on the CPU meanwhile
+  if (pipe && net->pending)
+    xcel_wait();
+  if (pipe && in)
+    xcel_start(&net->layers[0], in, net->layers[0].ofm);
+  if (net->pending) {
+    run_tail(net, tail, out);
+    net->pending = 0;
+  }
+  if (!in)
+    return done;
+
+  // This image up to its deferred part
+  if (pipe) {
+    layer_t *l = &net->layers[0];
+    xcel_wait();
+    requant_pool(l->ofm, l->act, ofm_dim(l), l->ofm_depth, l->scale);
+    x = l->act;
+    i = 1;
+  }
+  for (; i < tail; i++) {
+    layer_t *l = &net->layers[i];
+    run_layer(l, l->engine, x, l->act, out);
+    x = l->act;
+  }
+  if (pipe)
+    xcel_start(&net->layers[tail], x, net->layers[tail].ofm);
+  net->tail_in = x;
+  net->pending = 1;
+  return done;
+}
+
+void net_calibrate(net_t *net, const int8_t *in, int32_t *out) {
+  uint32_t e, i;
+
+  for (e = 0; e < NUM_ENGINES; e++) {
+    const int8_t *x = in;
+
+    for (i = 0; i < net->num_layers; i++) {
+      layer_t *l = &net->layers[i];
+      uint32_t engine = supports(l, e) ? e : ENGINE_CPU;
+      uint32_t start = CYCLE_COUNTER;
+
+      run_layer(l, engine, x, l->act, out);
+      l->cycles[e] = (engine == e) ? CYCLE_COUNTER - start : 0;
+      x = l->act;
+    }
+  }
+
+  for (i = 0; i < net->num_layers; i++) {
+    layer_t *l = &net->layers[i];
+    l->engine = ENGINE_CPU;
+    for (e = 1; e < NUM_ENGINES; e++) {
+      if (l->cycles[e] != 0 && l->cycles[e] < l->cycles[l->engine])
+        l->engine = e;
+    }
+  }
+  net_plan(net);
+}
+
+void net_report(const net_t *net) {
+  static const char *names[NUM_ENGINES] = { "cpu", "xcel", "xcel_stream" };
+  int8_t buffer[BUF_LEN];
+  uint32_t i, e;
+
+  for (i = 0; i < net->num_layers; i++) {
+    const layer_t *l = &net->layers[i];
+
+    uwrite_int8s("\r\nLayer ");
+    uwrite_int8s(uint32_to_ascii_hex(i, buffer, BUF_LEN));
+    uwrite_int8s(": ");
+    uwrite_int8s(names[l->engine]);
+    for (e = 0; e < NUM_ENGINES; e++) {
+      if (l->cycles[e] == 0)
+        continue;
+      uwrite_int8s(" ");
+      uwrite_int8s(names[e]);
+      uwrite_int8s("=");
+      uwrite_int8s(uint32_to_ascii_hex(l->cycles[e], buffer, BUF_LEN));
+    }
+  }
+  uwrite_int8s("\r\nBuffers: ");
+  uwrite_int8s(uint32_to_ascii_hex(net->peak_words, buffer, BUF_LEN));
+  uwrite_int8s(" of ");
+  uwrite_int8s(uint32_to_ascii_hex(net->arena_words, buffer, BUF_LEN));
+  uwrite_int8s(" words, batch of ");
+  uwrite_int8s(uint32_to_ascii_hex(net->batch, buffer, BUF_LEN));
+}
@@ -0,0 +1,95 @@
+#ifndef NET_H_
+#define NET_H_
+
+#include "types.h"
+
+// A network is a table of layers, run in order on int8 activations in DMem.
+// Each layer runs on the CPU kernels (cnn.c) or on the accelerator, either
+// forced for the whole network (net_force) or picked per layer from
+// measured cycles (net_calibrate)
+
+// Layer types
+#define LAYER_CONV_POOL 0 // conv3D + requantization + ReLU + 2x2 MaxPooling2D
+#define LAYER_FC        1 // fully connected, int32 output (last layer only)
+
+// Engines
+#define ENGINE_CPU         0
+#define ENGINE_XCEL        1 // accelerator, then pooling on the CPU
+#define ENGINE_XCEL_STREAM 2 // accelerator, pooling each row pair once done
+#define NUM_ENGINES        3
+
+#define NET_MAX_LAYERS 16
+
+typedef struct {
+  uint32_t type;
+  uint32_t ifm_dim;
+  uint32_t ifm_depth;
+  uint32_t wt_dim;       // conv only
+  uint32_t ofm_depth;    // FC: number of outputs
+  int8_t  *wt;           // int8 weights in DMem, for the CPU kernels
+  uint32_t wt_xcel_addr; // weight address for the accelerator, 0: CPU only
+  int8_t  *scale;        // per-output-channel scales (int4 weights), or NULL
+
+  // Set by net_force/net_calibrate
+  uint32_t engine;
+  uint32_t cycles[NUM_ENGINES]; // measured by net_calibrate, 0: not run
+
+  // Buffers in the arena, placed by net_init/net_force/net_calibrate
+  int32_t *ofm; // int32 OFM of the accelerator, or CPU kernel scratch
+  int8_t  *act; // pooled output (conv layers)
+} layer_t;
+
+typedef struct {
+  layer_t *layers;
+  uint32_t num_layers;
+  int32_t *arena;
+  uint32_t arena_words;
+  uint32_t peak_words; // arena words the buffers use, for the current engines
+  uint32_t batch;      // most images per net_run_batch call
+
+  // net_step: an image is half done, its deferred part starts on tail_in
+  uint32_t pending;
+  const int8_t *tail_in;
+} net_t;
+
+// DMem words net_init needs for the buffers of these layers, whatever their
+// engines, with batches of batch images. Buffers only share words when they
+// are never in use together
+uint32_t net_arena_words(const layer_t *layers, uint32_t num_layers, uint32_t batch);
+
+// Place the buffers in arena (arena_words long); returns 0, or -1 if the
+// arena is too small, batch is 0 or there are more than NET_MAX_LAYERS layers
+int net_init(net_t *net, layer_t *layers, uint32_t num_layers, uint32_t batch,
+             int32_t *arena, uint32_t arena_words);
+
+// Run every layer the engine supports on it, and the others on the CPU
+void net_force(net_t *net, uint32_t engine);
+
+// Run the network once on each engine, timing every layer, and keep the
+// fastest engine of each layer. The accelerator and the DMA must be idle
+void net_calibrate(net_t *net, const int8_t *in, int32_t *out);
+
+void net_run(net_t *net, const int8_t *in, int32_t *out);
+
+// net_run on k <= batch images, in_stride bytes apart, one layer at a time:
+// the CPU layers sweep each filter across the k images (cnn.h batched
+// kernels), so weights are unpacked once per batch instead of once per
+// image. The k outputs go to out one after the other. Runs the images one
+// by one when the engines are pipelined (see net_step)
+void net_run_batch(net_t *net, const int8_t *in, uint32_t in_stride, uint32_t k,
+                   int32_t *out);
+
+// Pipelined run, one image per call: start image in, and finish the image of
+// the previous call into out. Returns 1 if out was written (0 on the first
+// call). When the first layer and a later one run on ENGINE_XCEL, the first
+// layer of in runs on the accelerator while the CPU finishes the previous
+// image, and the last accelerator layer of in is left running. Call it with
+// in = NULL to finish the last image. in must not change until the next
+// call returns if the network has a single layer (else it is only read
+// during the call); net_run/net_calibrate only once the pipeline is empty
+int net_step(net_t *net, const int8_t *in, int32_t *out);
+
+// Print the engine (and the measured cycles) of every layer
+void net_report(const net_t *net);
+
+#endif
@@ -0,0 +1,203 @@
+#include "types.h"
+#include "ascii.h"
+#include "uart.h"
+#include "memory_map.h"
+#include "string.h"
+#include "printf.h"
+
+#define BUF_LEN 128
+
+// Largest buffer size tested (bytes)
+#define MAX_BYTES 1024
+
+static uint32_t src[MAX_BYTES / 4 + 1];
+static uint32_t dst[MAX_BYTES / 4 + 1];
+static uint32_t ref[MAX_BYTES / 4 + 1];
+
+typedef void (*entry_t)(void);
+
+// The byte loops the library used before, as references
+static void byte_memcpy(uint8_t* d, const uint8_t* s, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        d[i] = s[i];
+}
+
+static void byte_memmove(uint8_t* d, const uint8_t* s, uint32_t n)
+{
+    if (d <= s) {
+        byte_memcpy(d, s, n);
+    } else {
+        for (uint32_t i = n; i > 0; i--)
+            d[i - 1] = s[i - 1];
+    }
+}
+
+static void byte_memset(uint8_t* d, uint8_t val, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        d[i] = val;
+}
+
+static uint32_t byte_strlen(const int8_t* s)
+{
+    uint32_t i = 0;
+    for ( ; s[i] != '\0'; i++) ;
+    return i;
+}
+
+static int32_t byte_strcmp(const int8_t* s0, const int8_t* s1)
+{
+    for (uint32_t i = 0; ; i++) {
+        if (s0[i] != s1[i])
+            return 1;
+        if (s0[i] == '\0')
+            break;
+    }
+    return 0;
+}
+
+static int8_t* nibble_to_ascii_hex(uint32_t x, int8_t* buffer)
+{
+    uint32_t i = 0;
+    for ( ; i < 8; i++) {
+        int8_t t = (x >> ((7 - i) << 2)) & 0xf;
+        if (t >= 0 && t <= 9)
+            buffer[i] = t + '0';
+        if (t >= 0xa && t <= 0xf)
+            buffer[i] = (t - 0xa) + 'a';
+    }
+    buffer[i] = '\0';
+    return buffer;
+}
+
+static uint32_t same(const void* a, const void* b, uint32_t n)
+{
+    const uint8_t* p = (const uint8_t*)a;
+    const uint8_t* q = (const uint8_t*)b;
+    for (uint32_t i = 0; i < n; i++) {
+        if (p[i] != q[i])
+            return 0;
+    }
+    return 1;
+}
+
+static void report(const char* name, uint32_t n, uint32_t byte_cycles,
+                   uint32_t lib_cycles, uint32_t ok)
+{
+    uprintf("\r\n%s %4u bytes: byte loop %6u, library %6u%s", name, n,
+            byte_cycles, lib_cycles, ok ? "" : " MISMATCH");
+}
+
+int main(void)
+{
+    uint8_t* s = (uint8_t*)src;
+    uint8_t* d = (uint8_t*)dst;
+    uint8_t* r = (uint8_t*)ref;
+    int8_t buffer[BUF_LEN];
+    uint32_t byte_cycles, lib_cycles, ok;
+
+    for (uint32_t i = 0; i < MAX_BYTES / 4 + 1; i++)
+        src[i] = 0x41424344 + ((i & 0x1f) << 8); // no zero byte
+
+    for (uint32_t n = 16; n <= MAX_BYTES; n <<= 2) {
+        // Aligned, then off by one byte on the destination side only
+        for (uint32_t off = 0; off < 2; off++) {
+            COUNTER_RST = 0;
+            byte_memcpy(r + off, s, n);
+            byte_cycles = CYCLE_COUNTER;
+
+            COUNTER_RST = 0;
+            memcpy(d + off, s, n);
+            lib_cycles = CYCLE_COUNTER;
+            report(off ? "memcpy (unaligned)" : "memcpy", n, byte_cycles, lib_cycles,
+                   same(d + off, r + off, n));
+        }
+
+        // Overlapping, towards higher addresses (copies backwards)
+        byte_memcpy(r, s, n + 4);
+        byte_memcpy(d, s, n + 4);
+        COUNTER_RST = 0;
+        byte_memmove(r + 4, r, n);
+        byte_cycles = CYCLE_COUNTER;
+
+        COUNTER_RST = 0;
+        memmove(d + 4, d, n);
+        lib_cycles = CYCLE_COUNTER;
+        report("memmove", n, byte_cycles, lib_cycles, same(d, r, n + 4));
+
+        COUNTER_RST = 0;
+        byte_memset(r, 0x5a, n);
+        byte_cycles = CYCLE_COUNTER;
+
+        COUNTER_RST = 0;
+        memset(d, 0x5a, n);
+        lib_cycles = CYCLE_COUNTER;
+        report("memset", n, byte_cycles, lib_cycles, same(d, r, n));
+
+        // Two equal strings of n - 1 characters
+        byte_memcpy(d, s, n);
+        d[n - 1] = '\0';
+        byte_memcpy(r, d, n);
+
+        COUNTER_RST = 0;
+        ok = byte_strlen((int8_t*)d);
+        byte_cycles = CYCLE_COUNTER;
+
+        COUNTER_RST = 0;
+        ok = ok == strlen((int8_t*)d);
+        lib_cycles = CYCLE_COUNTER;
+        report("strlen", n, byte_cycles, lib_cycles, ok);
+
+        COUNTER_RST = 0;
+        ok = byte_strcmp((int8_t*)d, (int8_t*)r) == 0;
+        byte_cycles = CYCLE_COUNTER;
+
+        COUNTER_RST = 0;
+        ok = ok && strcmp((int8_t*)d, (int8_t*)r) == 0;
+        lib_cycles = CYCLE_COUNTER;
+        report("strcmp", n, byte_cycles, lib_cycles, ok);
+    }
+
+    // Number formatting
+    int8_t ref_hex[9];
+    COUNTER_RST = 0;
+    nibble_to_ascii_hex(0x1234abcd, ref_hex);
+    byte_cycles = CYCLE_COUNTER;
+
+    COUNTER_RST = 0;
+    uint32_to_ascii_hex(0x1234abcd, buffer, BUF_LEN);
+    lib_cycles = CYCLE_COUNTER;
+    report("to_ascii_hex", 4, byte_cycles, lib_cycles, strcmp(buffer, ref_hex) == 0);
+
+    COUNTER_RST = 0;
+    uint32_to_ascii_dec(4000000000u, buffer, BUF_LEN);
+    lib_cycles = CYCLE_COUNTER;
+    uprintf("\r\nuint32_to_ascii_dec 4000000000: %u cycles (%s)", lib_cycles, buffer);
+
+    // One line, printed piece by piece and with one uprintf (both wait for
+    // the TX FIFO to take it, not for the line to be sent)
+    uflush();
+    COUNTER_RST = 0;
+    uwrite_int8s("\r\nimage ");
+    uwrite_int8s(uint32_to_ascii_hex(7, buffer, BUF_LEN));
+    uwrite_int8s(" cycles ");
+    uwrite_int8s(uint32_to_ascii_hex(123456, buffer, BUF_LEN));
+    byte_cycles = CYCLE_COUNTER;
+    uflush();
+
+    COUNTER_RST = 0;
+    uprintf("\r\nimage %08x cycles %08x", 7, 123456);
+    lib_cycles = CYCLE_COUNTER;
+    uflush();
+    uprintf("\r\nuwrite_int8s line: %u cycles, uprintf line: %u cycles\r\n",
+            byte_cycles, lib_cycles);
+    uflush();
+
+    // go back to the bios - using this function causes a jr to the addr,
+    // the compiler "jals" otherwise and then cannot set PC[31:28]
+    uint32_t bios = ascii_hex_to_uint32("40000000");
+    entry_t start = (entry_t) (bios);
+    start();
+    return 0;
+}